@@ -0,0 +1,309 @@
+// Micro-benchmarks for the allocators in Glaceon/Core/Memory, measured against malloc and
+// std::pmr::monotonic_buffer_resource.
+//
+// Every benchmark reports time/op (one op = one allocation plus, where the allocator supports it, its free) and
+// peak_rss (process wide, in bytes, so only meaningful relative to the benchmarks that ran before it).  The churn
+// benchmarks also report how fragmented the heap ended up.
+//
+// e.g.
+//  GlaceonBench --benchmark_filter=Churn
+//  GlaceonBench --benchmark_filter=Threaded --benchmark_counters_tabular=true
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <memory_resource>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#ifdef _WIN64
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include "Core/Memory/FreeListAllocator.h"
+#include "Core/Memory/LinearAllocator.h"
+#include "Core/Memory/MemorySubsystem.h"
+#include "Core/Memory/PoolAllocator.h"
+#include "Core/Memory/RingAllocator.h"
+#include "Core/Memory/StackAllocator.h"
+
+namespace glaceon {
+
+static constexpr size_t kBatchSize = 1024;
+static constexpr size_t kSmallSize = 64;
+static constexpr size_t kMinMixedSize = 16;
+static constexpr size_t kMaxMixedSize = 4096;
+static constexpr size_t kArenaSize = 64 * 1024 * 1024;
+static constexpr uint8_t kAlignment = 16;
+
+// -------------------------- WORKLOAD DATA --------------------------
+
+// sizes drawn log-uniformly from [kMinMixedSize, kMaxMixedSize] with a fixed seed so every allocator sees the same mix
+static const std::vector<size_t> &GetMixedSizes() {
+  static const std::vector<size_t> sizes = [] {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> exponent(std::log2(kMinMixedSize), std::log2(kMaxMixedSize));
+    std::vector<size_t> result(kBatchSize * 4);
+    for (size_t &size : result) { size = static_cast<size_t>(std::exp2(exponent(rng))); }
+    return result;
+  }();
+  return sizes;
+}
+
+static const std::vector<size_t> &GetShuffledOrder() {
+  static const std::vector<size_t> order = [] {
+    std::vector<size_t> result(kBatchSize);
+    for (size_t i = 0; i < kBatchSize; i++) { result[i] = i; }
+    std::shuffle(result.begin(), result.end(), std::mt19937(7));
+    return result;
+  }();
+  return order;
+}
+
+static size_t GetPeakRss() {
+#ifdef _WIN64
+  PROCESS_MEMORY_COUNTERS counters = {};
+  GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+  return counters.PeakWorkingSetSize;
+#else
+  rusage usage = {};
+  getrusage(RUSAGE_SELF, &usage);
+  return static_cast<size_t>(usage.ru_maxrss) * 1024;// KiB on Linux
+#endif
+}
+
+static void ReportCounters(benchmark::State &state, size_t ops_per_iteration) {
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * ops_per_iteration));
+  state.counters["time/op"] = benchmark::Counter(static_cast<double>(state.iterations() * ops_per_iteration),
+                                                 benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+  state.counters["peak_rss"] = benchmark::Counter(static_cast<double>(GetPeakRss()), benchmark::Counter::kAvgThreads,
+                                                  benchmark::Counter::kIs1024);
+}
+
+// -------------------------- ADAPTERS --------------------------
+
+// Every adapter exposes Allocate/Free/Reset so the workloads below are written once.  Free is a no-op for allocators
+// that only release in bulk; Reset is called after every batch.
+
+struct MallocAdapter {
+  void *Allocate(size_t size) { return malloc(size); }
+  void Free(void *ptr, size_t) { free(ptr); }
+  void Reset() {}
+};
+
+struct MonotonicAdapter {
+  MonotonicAdapter() : buffer(kArenaSize), resource(buffer.data(), buffer.size(), std::pmr::null_memory_resource()) {}
+  void *Allocate(size_t size) { return resource.allocate(size, kAlignment); }
+  void Free(void *, size_t) {}
+  void Reset() { resource.release(); }
+
+  std::vector<std::byte> buffer;
+  std::pmr::monotonic_buffer_resource resource;
+};
+
+struct LinearAdapter {
+  LinearAdapter() : buffer(kArenaSize), allocator(buffer.size(), buffer.data()) {}
+  void *Allocate(size_t size) { return allocator.Allocate(size, kAlignment); }
+  void Free(void *, size_t) {}
+  void Reset() { allocator.Clear(); }
+
+  std::vector<std::byte> buffer;
+  LinearAllocator allocator;
+};
+
+// frees must come in LIFO order
+struct StackAdapter {
+  StackAdapter() : buffer(kArenaSize), allocator(buffer.size(), buffer.data()) {}
+  void *Allocate(size_t size) { return allocator.Allocate(size, kAlignment); }
+  void Free(void *ptr, size_t) { allocator.Deallocate(ptr); }
+  void Reset() {}
+
+  std::vector<std::byte> buffer;
+  StackAllocator allocator;
+};
+
+// every object is kMaxMixedSize bytes so mixed workloads fit too
+struct PoolAdapter {
+  PoolAdapter() : allocator(kMaxMixedSize, kAlignment, kBatchSize) {}
+  void *Allocate(size_t size) { return allocator.Allocate(size, kAlignment); }
+  void Free(void *ptr, size_t) { allocator.Deallocate(ptr); }
+  void Reset() {}
+
+  PoolAllocator allocator;
+};
+
+struct FreeListAdapter {
+  FreeListAdapter() : buffer(kArenaSize), allocator(buffer.size(), buffer.data()) {}
+  void *Allocate(size_t size) { return allocator.Allocate(size, kAlignment); }
+  void Free(void *ptr, size_t) { allocator.Deallocate(ptr); }
+  void Reset() {}
+
+  std::vector<std::byte> buffer;
+  FreeListAllocator allocator;
+};
+
+// memory is only reused in allocation order, so frees should come in FIFO order
+struct RingAdapter {
+  RingAdapter() : buffer(kArenaSize), allocator(buffer.size(), buffer.data()) {}
+  void *Allocate(size_t size) { return allocator.Allocate(size, kAlignment); }
+  void Free(void *ptr, size_t) { allocator.Deallocate(ptr); }
+  void Reset() {}
+
+  std::vector<std::byte> buffer;
+  RingAllocator allocator;
+};
+
+struct GAllocateAdapter {
+  void *Allocate(size_t size) { return MemorySubsystem::GAllocate(size, MEMORY_TAG_ARRAY); }
+  void Free(void *ptr, size_t size) { MemorySubsystem::GFree(ptr, size, MEMORY_TAG_ARRAY); }
+  void Reset() {}
+};
+
+enum class FreeOrder { kLifo, kFifo, kRandom };
+
+// -------------------------- WORKLOADS --------------------------
+
+// Allocates a batch, then frees it in the given order.  sizes == nullptr means every allocation is kSmallSize.
+template<typename Adapter, FreeOrder Order>
+static void RunBatches(benchmark::State &state, Adapter &adapter, const std::vector<size_t> *sizes) {
+  std::vector<void *> blocks(kBatchSize);
+  const std::vector<size_t> &shuffled = GetShuffledOrder();
+  size_t offset = 0;
+
+  for (auto _ : state) {
+    for (size_t i = 0; i < kBatchSize; i++) {
+      blocks[i] = adapter.Allocate(sizes != nullptr ? (*sizes)[offset + i] : kSmallSize);
+      benchmark::DoNotOptimize(blocks[i]);
+    }
+    for (size_t i = 0; i < kBatchSize; i++) {
+      size_t index = i;
+      if constexpr (Order == FreeOrder::kLifo) { index = kBatchSize - 1 - i; }
+      if constexpr (Order == FreeOrder::kRandom) { index = shuffled[i]; }
+      adapter.Free(blocks[index], sizes != nullptr ? (*sizes)[offset + index] : kSmallSize);
+    }
+    adapter.Reset();
+    if (sizes != nullptr) { offset = (offset + kBatchSize) % (sizes->size() - kBatchSize); }
+  }
+  ReportCounters(state, kBatchSize);
+}
+
+template<typename Adapter, FreeOrder Order>
+static void BM_UniformSmall(benchmark::State &state) {
+  Adapter adapter;
+  RunBatches<Adapter, Order>(state, adapter, nullptr);
+}
+
+template<typename Adapter, FreeOrder Order>
+static void BM_MixedSizes(benchmark::State &state) {
+  Adapter adapter;
+  RunBatches<Adapter, Order>(state, adapter, &GetMixedSizes());
+}
+
+// Keeps a live set of state.range(0) blocks and replaces a random one per op, which is what fragments a general
+// purpose heap over time.  Runs for a fixed number of ops so every allocator ends in a comparable state.
+template<typename Adapter>
+static void BM_Churn(benchmark::State &state) {
+  Adapter adapter;
+  const auto live_set = static_cast<size_t>(state.range(0));
+  const std::vector<size_t> &mixed_sizes = GetMixedSizes();
+  std::vector<void *> blocks(live_set, nullptr);
+  std::vector<size_t> block_sizes(live_set, 0);
+  std::mt19937 rng(1234);
+
+  for (auto _ : state) {
+    const size_t slot = rng() % live_set;
+    if (blocks[slot] != nullptr) { adapter.Free(blocks[slot], block_sizes[slot]); }
+    block_sizes[slot] = mixed_sizes[rng() % mixed_sizes.size()];
+    blocks[slot] = adapter.Allocate(block_sizes[slot]);
+    benchmark::DoNotOptimize(blocks[slot]);
+  }
+
+  if constexpr (std::is_same_v<Adapter, FreeListAdapter>) {
+    state.counters["fragmentation"] = adapter.allocator.GetFragmentation();
+  }
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+  if constexpr (std::is_same_v<Adapter, MallocAdapter>) {
+    // share of the main heap that is free but not returned to the OS
+    const struct mallinfo2 info = mallinfo2();
+    state.counters["fragmentation"] = info.arena > 0 ? static_cast<double>(info.fordblks) / static_cast<double>(info.arena) : 0.0;
+  }
+#endif
+
+  for (size_t i = 0; i < live_set; i++) {
+    if (blocks[i] != nullptr) { adapter.Free(blocks[i], block_sizes[i]); }
+  }
+  ReportCounters(state, 1);
+}
+
+// Every thread allocates and frees its own batches through an allocator shared by all threads
+template<typename Adapter>
+static void BM_Threaded(benchmark::State &state) {
+  static std::unique_ptr<Adapter> shared;
+  if (state.thread_index() == 0) {
+    shared.reset();// free the previous run's arena first so it does not count towards peak_rss
+    shared = std::make_unique<Adapter>();
+  }
+  // google benchmark starts timing only once every thread got here, so the adapter exists by the first iteration
+  std::vector<void *> blocks(kBatchSize / 4);
+  const std::vector<size_t> &sizes = GetMixedSizes();
+  size_t offset = static_cast<size_t>(state.thread_index()) * kBatchSize;
+
+  for (auto _ : state) {
+    for (size_t i = 0; i < blocks.size(); i++) {
+      blocks[i] = shared->Allocate(sizes[(offset + i) % sizes.size()] / 4);
+      benchmark::DoNotOptimize(blocks[i]);
+    }
+    for (size_t i = 0; i < blocks.size(); i++) { shared->Free(blocks[i], sizes[(offset + i) % sizes.size()] / 4); }
+    offset += blocks.size();
+  }
+  ReportCounters(state, blocks.size());
+}
+
+// -------------------------- REGISTRATION --------------------------
+
+BENCHMARK(BM_UniformSmall<MallocAdapter, FreeOrder::kLifo>);
+BENCHMARK(BM_UniformSmall<MonotonicAdapter, FreeOrder::kLifo>);
+BENCHMARK(BM_UniformSmall<LinearAdapter, FreeOrder::kLifo>);
+BENCHMARK(BM_UniformSmall<StackAdapter, FreeOrder::kLifo>);
+BENCHMARK(BM_UniformSmall<PoolAdapter, FreeOrder::kLifo>);
+BENCHMARK(BM_UniformSmall<FreeListAdapter, FreeOrder::kLifo>);
+BENCHMARK(BM_UniformSmall<RingAdapter, FreeOrder::kFifo>);
+BENCHMARK(BM_UniformSmall<GAllocateAdapter, FreeOrder::kLifo>);
+
+BENCHMARK(BM_MixedSizes<MallocAdapter, FreeOrder::kLifo>);
+BENCHMARK(BM_MixedSizes<MonotonicAdapter, FreeOrder::kLifo>);
+BENCHMARK(BM_MixedSizes<LinearAdapter, FreeOrder::kLifo>);
+BENCHMARK(BM_MixedSizes<StackAdapter, FreeOrder::kLifo>);
+BENCHMARK(BM_MixedSizes<PoolAdapter, FreeOrder::kLifo>);
+BENCHMARK(BM_MixedSizes<FreeListAdapter, FreeOrder::kLifo>);
+BENCHMARK(BM_MixedSizes<RingAdapter, FreeOrder::kFifo>);
+BENCHMARK(BM_MixedSizes<GAllocateAdapter, FreeOrder::kLifo>);
+
+// free order only matters for allocators that can free individual blocks in any order
+BENCHMARK(BM_MixedSizes<MallocAdapter, FreeOrder::kRandom>);
+BENCHMARK(BM_MixedSizes<PoolAdapter, FreeOrder::kRandom>);
+BENCHMARK(BM_MixedSizes<FreeListAdapter, FreeOrder::kRandom>);
+BENCHMARK(BM_MixedSizes<GAllocateAdapter, FreeOrder::kRandom>);
+
+BENCHMARK(BM_Churn<MallocAdapter>)->Arg(4096)->Iterations(4'000'000);
+BENCHMARK(BM_Churn<FreeListAdapter>)->Arg(4096)->Iterations(4'000'000);
+BENCHMARK(BM_Churn<GAllocateAdapter>)->Arg(4096)->Iterations(4'000'000);
+
+BENCHMARK(BM_Threaded<MallocAdapter>)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_Threaded<GAllocateAdapter>)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_Threaded<RingAdapter>)->ThreadRange(1, 8)->UseRealTime();
+
+}// namespace glaceon
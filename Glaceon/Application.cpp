@@ -3,6 +3,7 @@
 namespace glaceon {
 Application::Application([[maybe_unused]] ApplicationInfo *info) {
   glaceon::Logger::InitLoggers();
+  glaceon::DeferredLog::Start();
   char *test = (char *) MemorySubsystem::GAllocate(10, MemoryTag::MEMORY_TAG_STRING);
   test[0] = 'a';
   test[1] = 'b';
@@ -11,4 +12,5 @@ Application::Application([[maybe_unused]] ApplicationInfo *info) {
   MemorySubsystem::PrintStats();
 }
 void Application::PushContent(Assimp_ModelData model_data) { scene_ = Scene(model_data); }
+void Application::PushContent(MeshFile mesh_file) { scene_ = Scene(std::move(mesh_file)); }
 }// namespace glaceon
@@ -23,6 +23,12 @@ class GLACEON_API Application {
   virtual void OnShutdown() = 0;
 
   void PushContent(Assimp_ModelData model_data);
+  // a cooked mesh, see MeshFile.h; the scene keeps it mapped
+  void PushContent(MeshFile mesh_file);
+
+  // RunGame leaves its main loop before the next frame, as if the window had been closed
+  void RequestShutdown() { shutdown_requested_ = true; }
+  [[nodiscard]] bool IsShutdownRequested() const { return shutdown_requested_; }
 
   VulkanContext &GetVulkanContext() { return context_; }
   Scene &GetScene() { return scene_; }
@@ -31,6 +37,7 @@ class GLACEON_API Application {
   VulkanContext context_;
   Scene scene_;
   MemorySubsystem memory_subsystem_;
+  bool shutdown_requested_ = false;
 };
 }// namespace glaceon
 
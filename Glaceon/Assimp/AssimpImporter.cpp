@@ -4,38 +4,54 @@
 
 #include <assimp/Importer.hpp>
 
-#include "../Core/Logger.h"
-#include "AssimpModel.h"
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <optional>
 
+#include "../Core/Logger.h"
+#include "../Core/MappedFile.h"
+#include "../Core/ThreadPool.h"
+#include "../MeshFile.h"
+#include "../MeshOptimizer.h"
+#include "../Profiler/InstrumentationTimer.h"
+#include "../Utils.h"
 
 namespace glaceon {
 
-Assimp_ModelData AssimpImporter::ImportObjectModel(const std::string &obj_file) {
-  Assimp::Importer importer;
-  const aiScene *scene_obj =
-      importer.ReadFile(obj_file,
-                        aiProcess_ValidateDataStructure | aiProcess_CalcTangentSpace | aiProcess_Triangulate
-                            | aiProcess_JoinIdenticalVertices | aiProcess_SortByPType);
+// blocks of vertices and faces handed to a thread at a time, so one big mesh is spread across threads as well
+static constexpr uint32_t kVerticesPerRange = 16 * 1024;
+static constexpr uint32_t kFacesPerRange = 16 * 1024;
 
-  if (scene_obj == nullptr) {
-    GERROR("Cannot import {} - {}", obj_file, importer.GetErrorString());
-    return Assimp_ModelData{};
-  }
+// identical vertices are merged by WeldMeshes() rather than aiProcess_JoinIdenticalVertices
+static constexpr unsigned int kImportFlags =
+    aiProcess_ValidateDataStructure | aiProcess_CalcTangentSpace | aiProcess_Triangulate | aiProcess_SortByPType;
 
-  ExtractMeshes(scene_obj);
+// part of the import cache key along with kImportFlags and kMeshFileVersion; bump it when the import steps change what
+// ends up in a mesh file
+static constexpr uint32_t kImportCacheVersion = 3;
 
-  aiString name;
-  for (size_t i = 0; i < scene_obj->mNumMaterials; i++) {
-    aiMaterial *material = scene_obj->mMaterials[i];
-    // print out all the material properties in the .obj file
-    if (material->Get(AI_MATKEY_NAME, name) == aiReturn_SUCCESS) { GINFO("Material name: {}", name.C_Str()); }
-    PrintMaterialProperties(material);
+// positions and normals are copied as they are
+static_assert(sizeof(aiVector3D) == sizeof(glm::vec3), "assimp built with ASSIMP_DOUBLE_PRECISION is not supported");
+
+// indices of every submesh into the whole vertex range rather than their submesh's, so the meshes are drawn from one
+// vertex buffer
+static std::vector<uint32_t> GetSceneIndices(const Assimp_MeshData &meshes) {
+  std::vector<uint32_t> indices = meshes.indices;
+  for (const Assimp_SubmeshData &submesh : meshes.submeshes) {
+    for (uint32_t i = submesh.first_index; i < submesh.first_index + submesh.index_count; i++) { indices[i] += submesh.first_vertex; }
   }
+  return indices;
+}
+
+Assimp_ModelData AssimpImporter::ImportObjectModel(const std::string &obj_file) {
+  Assimp_MeshData meshes = ImportMeshes(obj_file);
 
   // aiColor3D diffuseColor;
   // aiString name;
   // if (material->Get(AI_MATKEY_COLOR_DIFFUSE, diffuseColor) != aiReturn_SUCCESS) {
-  //   GERROR("Cannot get diffuse color from material");
+  //   GERROR_CH(Assets, "Cannot get diffuse color from material");
   //   return Assimp_ModelData{};
   // }
 
@@ -47,131 +63,511 @@ Assimp_ModelData AssimpImporter::ImportObjectModel(const std::string &obj_file)
   // diff.g = diffuseColor.g;
   // diff.b = diffuseColor.b;
 
-  return Assimp_ModelData{.vert_data = GetVertexData(scene_obj, 0), .diffuse_color = diff};
+  std::vector<uint32_t> indices = GetSceneIndices(meshes);
+  return Assimp_ModelData{.vert_data = std::move(meshes.positions), .indices = std::move(indices), .diffuse_color = diff};
 }
 
-std::vector<glm::vec3> AssimpImporter::GetVertexData(const aiScene *scene, const size_t mesh_idx) {
-
-  std::vector<glm::vec3> verticies;
-  if (const aiMesh *mesh = scene->mMeshes[mesh_idx]; mesh->HasPositions()) {
-    verticies.reserve(mesh->mNumVertices);
-
-    for (unsigned int i = 0; i < mesh->mNumVertices; i++) {
-      aiVector3d vertex = mesh->mVertices[i];
-      verticies.emplace_back(vertex.x, vertex.y, vertex.z);
+/**
+ * @brief Imports every triangle mesh of a file, from the import cache when the file was imported before.
+ *
+ * A miss imports the file with assimp and writes the result to the cache, replacing the entry of an older version of
+ * the same file.  A cache entry that cannot be read is imported again and overwritten.
+ *
+ * @param file_path Any file assimp reads.
+ * @return The meshes; empty if the file cannot be imported.
+ */
+Assimp_MeshData AssimpImporter::ImportMeshes(const std::string &file_path) {
+  GLACEON_PROFILE_FUNCTION();
+  const std::string cache_path = GetCachePath(file_path);
+  if (std::error_code error; !cache_path.empty() && std::filesystem::exists(cache_path, error)) {
+    Assimp_MeshData cached = ReadMeshes(cache_path);
+    if (!cached.positions.empty()) {
+      GINFO_CH(Assets, "Loaded {} from the import cache", file_path);
+      return cached;
     }
   }
-  return verticies;
+
+  Assimp_MeshData meshes = ImportUncached(file_path);
+  if (!cache_path.empty() && !meshes.positions.empty() && WriteMeshes(meshes, cache_path)) { PruneCache(cache_path); }
+  return meshes;
 }
 
-std::vector<glm::vec3> AssimpImporter::GetUVData(const aiScene *scene, const size_t mesh_idx) {
-  if (scene == nullptr) {
-    GWARN("No scene provided, cannot extract uv data");
-    return {};
+bool AssimpImporter::CookMeshes(const std::string &file_path, const std::string &output_path) {
+  const Assimp_MeshData meshes = ImportUncached(file_path);
+  if (meshes.positions.empty()) {
+    GERROR_CH(Assets, "No triangle meshes to cook in {}", file_path);
+    return false;
   }
+  return WriteMeshes(meshes, output_path);
+}
 
-  if (mesh_idx > scene->mNumMeshes) {
-    GWARN("Cannot find mesh with given mesh index");
-    return {};
+Assimp_MeshData AssimpImporter::ImportUncached(const std::string &file_path) {
+  GLACEON_PROFILE_FUNCTION();
+  Assimp::Importer importer;
+  const aiScene *scene_obj = ReadScene(importer, file_path);
+  if (scene_obj == nullptr) { return {}; }
+
+  Assimp_MeshData meshes = ExtractMeshes(scene_obj);
+  WeldMeshes(meshes);
+  OptimizeMeshes(meshes);
+
+  aiString name;
+  for (size_t i = 0; i < scene_obj->mNumMaterials; i++) {
+    aiMaterial *material = scene_obj->mMaterials[i];
+    // print out all the material properties in the .obj file
+    if (material->Get(AI_MATKEY_NAME, name) == aiReturn_SUCCESS) { GINFO_CH(Assets, "Material name: {}", name.C_Str()); }
+    PrintMaterialProperties(material);
   }
-  return {};
+  return meshes;
+}
+
+const aiScene *AssimpImporter::ReadScene(Assimp::Importer &importer, const std::string &file_path) {
+  GLACEON_PROFILE_FUNCTION();
+  const aiScene *scene_obj = importer.ReadFile(file_path, kImportFlags);
+
+  if (scene_obj == nullptr) { GERROR_CH(Assets, "Cannot import {} - {}", file_path, importer.GetErrorString()); }
+  return scene_obj;
 }
 
 void AssimpImporter::PrintMaterialProperties(const aiMaterial *material) {
   for (unsigned int i = 0; i < material->mNumProperties; ++i) {
     aiMaterialProperty *property = material->mProperties[i];
 
-    GTRACE("Property Name: {}", property->mKey.data);
-    GTRACE("Semantic: {}", property->mSemantic);
-    GTRACE("Index: {}", property->mIndex);
-    GTRACE("Data Length: {}", property->mDataLength);
-    //    GTRACE("Type: {}", property->mType);
+    GTRACE_CH(Assets, "Property Name: {}", property->mKey.data);
+    GTRACE_CH(Assets, "Semantic: {}", property->mSemantic);
+    GTRACE_CH(Assets, "Index: {}", property->mIndex);
+    GTRACE_CH(Assets, "Data Length: {}", property->mDataLength);
+    //    GTRACE_CH(Assets, "Type: {}", property->mType);
 
     switch (property->mType) {
       case aiPTI_Float: {
         auto *data = reinterpret_cast<float *>(property->mData);
-        GTRACE("Data: ");
-        for (unsigned int j = 0; j < property->mDataLength / sizeof(float); ++j) { GTRACE("{}", data[j]); }
+        GTRACE_CH(Assets, "Data: ");
+        for (unsigned int j = 0; j < property->mDataLength / sizeof(float); ++j) { GTRACE_CH(Assets, "{}", data[j]); }
         break;
       }
       case aiPTI_Double: {
         auto *data = reinterpret_cast<double *>(property->mData);
-        GTRACE("Data: ");
-        for (unsigned int j = 0; j < property->mDataLength / sizeof(double); ++j) { GTRACE("{}", data[j]); }
+        GTRACE_CH(Assets, "Data: ");
+        for (unsigned int j = 0; j < property->mDataLength / sizeof(double); ++j) { GTRACE_CH(Assets, "{}", data[j]); }
         break;
       }
       case aiPTI_String: {
         auto *data = reinterpret_cast<aiString *>(property->mData);
-        GTRACE("Data: {}", data->C_Str());
+        GTRACE_CH(Assets, "Data: {}", data->C_Str());
         break;
       }
       case aiPTI_Integer: {
         int *data = reinterpret_cast<int *>(property->mData);
-        GTRACE("Data: ");
-        for (unsigned int j = 0; j < property->mDataLength / sizeof(int); ++j) { GTRACE("{}", data[j]); }
+        GTRACE_CH(Assets, "Data: ");
+        for (unsigned int j = 0; j < property->mDataLength / sizeof(int); ++j) { GTRACE_CH(Assets, "{}", data[j]); }
         break;
       }
       case aiPTI_Buffer: {
         auto *data = reinterpret_cast<unsigned char *>(property->mData);
-        GTRACE("Data: ");
-        for (unsigned int j = 0; j < property->mDataLength; ++j) { GTRACE("{}", data[j]); }
+        GTRACE_CH(Assets, "Data: ");
+        for (unsigned int j = 0; j < property->mDataLength; ++j) { GTRACE_CH(Assets, "{}", data[j]); }
         break;
       }
       default:
-        GTRACE("Unknown property type.");
+        GTRACE_CH(Assets, "Unknown property type.");
         break;
     }
 
-    GTRACE("----------------------------------------");
+    GTRACE_CH(Assets, "----------------------------------------");
   }
 }
+// Copies vertices [begin, end) of mesh into its submesh's part of the vertex streams.
+static void CopyVertices(const aiMesh *mesh, const Assimp_SubmeshData &submesh, uint32_t begin, uint32_t end, Assimp_MeshData &data) {
+  const uint32_t count = end - begin;
+  const size_t out = submesh.first_vertex + begin;
+  std::memcpy(&data.positions[out], &mesh->mVertices[begin], count * sizeof(glm::vec3));
+  if (mesh->HasNormals()) { std::memcpy(&data.normals[out], &mesh->mNormals[begin], count * sizeof(glm::vec3)); }
+
+  if (mesh->HasTextureCoords(0)) {
+    const aiVector3D *uvs = mesh->mTextureCoords[0];
+    for (uint32_t i = begin; i < end; i++) { data.uvs[submesh.first_vertex + i] = glm::vec2(uvs[i].x, uvs[i].y); }
+  }
+
+  if (mesh->HasTangentsAndBitangents() && mesh->HasNormals()) {
+    for (uint32_t i = begin; i < end; i++) {
+      const glm::vec3 normal(mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z);
+      const glm::vec3 tangent(mesh->mTangents[i].x, mesh->mTangents[i].y, mesh->mTangents[i].z);
+      const glm::vec3 bitangent(mesh->mBitangents[i].x, mesh->mBitangents[i].y, mesh->mBitangents[i].z);
+      // the shader rebuilds the bitangent as cross(normal, tangent) * w
+      const float handedness = glm::dot(glm::cross(normal, tangent), bitangent) < 0.0f ? -1.0f : 1.0f;
+      data.tangents[submesh.first_vertex + i] = glm::vec4(tangent, handedness);
+    }
+  }
+}
+
+// Copies faces [begin, end) of mesh, all triangles after aiProcess_Triangulate and the primitive type check
+static void CopyIndices(const aiMesh *mesh, const Assimp_SubmeshData &submesh, uint32_t begin, uint32_t end, Assimp_MeshData &data) {
+  uint32_t *out = &data.indices[submesh.first_index + 3 * static_cast<size_t>(begin)];
+  for (uint32_t face = begin; face < end; face++) {
+    const unsigned int *face_indices = mesh->mFaces[face].mIndices;
+    *out++ = face_indices[0];
+    *out++ = face_indices[1];
+    *out++ = face_indices[2];
+  }
+}
+
+/**
+ * @brief Extracts every triangle mesh of the scene into one set of preallocated buffers.
+ *
+ * A first pass over the meshes lays them out back to back, from the prefix sums of their vertex and index counts.
+ * Each mesh then owns a disjoint slice of every buffer, so the copies split into blocks of vertices and faces that
+ * run on the ThreadPool without any synchronization.
+ *
+ * @param scene_obj The imported scene.
+ * @return The vertex streams, indices and submesh table; empty when the scene has no triangle meshes.
+ */
 Assimp_MeshData AssimpImporter::ExtractMeshes(const aiScene *scene_obj) {
+  GLACEON_PROFILE_FUNCTION();
   if (scene_obj == nullptr) {
-    GWARN("No scene provided, cannot extract mesh data");
+    GWARN_CH(Assets, "No scene provided, cannot extract mesh data");
     return {};
   }
 
   if (scene_obj->mNumMeshes == 0) {
-    GWARN("Scene does not contain any meshes");
+    GWARN_CH(Assets, "Scene does not contain any meshes");
     return {};
   }
-  GTRACE("number of meshes: {}", scene_obj->mNumMeshes);
+  GTRACE_CH(Assets, "number of meshes: {}", scene_obj->mNumMeshes);
 
-  AssimpModel model;
+  Assimp_MeshData data;
+  std::vector<const aiMesh *> meshes;
+  uint64_t total_vertices = 0;
+  uint64_t total_indices = 0;
+  for (uint32_t i = 0; i < scene_obj->mNumMeshes; i++) {
+    const aiMesh *mesh = scene_obj->mMeshes[i];
+    // aiProcess_SortByPType moved points and lines into meshes of their own, only triangles are drawn.  Meshes
+    // aiProcess_Triangulate made out of quads and polygons are flagged with aiPrimitiveType_NGONEncodingFlag as well.
+    const unsigned int primitive_types = mesh->mPrimitiveTypes & ~aiPrimitiveType_NGONEncodingFlag;
+    if (primitive_types != aiPrimitiveType_TRIANGLE || !mesh->HasPositions()) {
+      GDEBUG_CH(Assets, "Skipping mesh {} ({}), primitive types {:#x}, {} vertices", i, mesh->mName.C_Str(), mesh->mPrimitiveTypes,
+                mesh->mNumVertices);
+      continue;
+    }
+
+    Assimp_SubmeshData submesh;
+    submesh.first_vertex = static_cast<uint32_t>(total_vertices);
+    submesh.vertex_count = mesh->mNumVertices;
+    submesh.first_index = static_cast<uint32_t>(total_indices);
+    submesh.index_count = 3 * mesh->mNumFaces;
+    submesh.material_index = mesh->mMaterialIndex;
+    data.submeshes.push_back(submesh);
+    meshes.push_back(mesh);
 
-  // Find total vertices across all meshes
-  size_t total_vertices = 0;
-  for (size_t i = 0; i < scene_obj->mNumMeshes; i++) {
-    aiMesh *mesh = scene_obj->mMeshes[i];
-    total_vertices += mesh->mNumVertices;
+    total_vertices += submesh.vertex_count;
+    total_indices += submesh.index_count;
+    if (total_vertices > UINT32_MAX || total_indices > UINT32_MAX) {
+      GERROR_CH(Assets, "Scene has more than {} vertices or indices", UINT32_MAX);
+      return {};
+    }
   }
 
-  GTRACE("Total vertices: {}", total_vertices);
-  model.InitializeVertexData(total_vertices);
+  data.positions.resize(total_vertices);
+  data.normals.resize(total_vertices);
+  data.uvs.resize(total_vertices);
+  data.tangents.resize(total_vertices);
+  data.indices.resize(total_indices);
 
-  size_t index = 0;// temporary manage vertex index to maek sure we are adding shit correcly; idiot
-  for (size_t i = 0; i < scene_obj->mNumMeshes; i++) {
-    aiMesh *mesh = scene_obj->mMeshes[i];
-    GTRACE("number of vertices: {}", mesh->mNumVertices);
-    for (size_t j = 0; j < mesh->mNumVertices; j++) {
-      const glm::vec3 kGlmVert = reinterpret_cast<glm::vec3 *>(mesh->mVertices)[j];
-      GTRACE("Assimp Importer: {} {} {}", kGlmVert.x, kGlmVert.y, kGlmVert.z);
-      model.AddVertex(kGlmVert);
+  struct ExtractRange {
+    uint32_t submesh;
+    uint32_t begin;
+    uint32_t end;
+    bool faces;
+  };
+  std::vector<ExtractRange> ranges;
+  for (uint32_t i = 0; i < data.submeshes.size(); i++) {
+    const uint32_t vertex_count = data.submeshes[i].vertex_count;
+    for (uint32_t begin = 0; begin < vertex_count; begin += kVerticesPerRange) {
+      ranges.push_back({i, begin, std::min(vertex_count, begin + kVerticesPerRange), false});
+    }
+    const uint32_t face_count = meshes[i]->mNumFaces;
+    for (uint32_t begin = 0; begin < face_count; begin += kFacesPerRange) {
+      ranges.push_back({i, begin, std::min(face_count, begin + kFacesPerRange), true});
+    }
+  }
 
-      // Let's check it
-      auto ret = model.GetVertex(index);
-      GTRACE("After Adding To Model: {} {} {}", ret.x, ret.y, ret.z);
-      index++;
+  ThreadPool::ParallelFor(ranges.size(), 1, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      const ExtractRange &range = ranges[i];
+      if (range.faces) {
+        CopyIndices(meshes[range.submesh], data.submeshes[range.submesh], range.begin, range.end, data);
+      } else {
+        CopyVertices(meshes[range.submesh], data.submeshes[range.submesh], range.begin, range.end, data);
+      }
     }
+  });
+
+  GDEBUG_CH(Assets, "Extracted {} meshes, {} vertices, {} triangles", data.submeshes.size(), total_vertices, total_indices / 3);
+  return data;
+}
+
+// the attributes besides the position two vertices must share to be welded
+struct WeldAttributes {
+  glm::vec3 normal;
+  glm::vec2 uv;
+  glm::vec4 tangent;
+};
+static_assert(sizeof(WeldAttributes) == 9 * sizeof(float), "WeldAttributes is hashed as bytes and must not have padding");
+
+/**
+ * @brief Merges the vertices of each submesh that are identical in every stream, submeshes in parallel, then packs
+ * the submeshes back together.
+ *
+ * WeldVertices() welds the positions, keyed on a hash of the normal, UV and tangent so only vertices that match in
+ * all of them merge.  It takes one pass over the vertices where aiProcess_JoinIdenticalVertices did the same job.
+ *
+ * @param data Meshes from ExtractMeshes(), welded in place.
+ */
+void AssimpImporter::WeldMeshes(Assimp_MeshData &data) {
+  GLACEON_PROFILE_FUNCTION();
+  std::vector<uint32_t> unique_counts;
+  for (const Assimp_SubmeshData &submesh : data.submeshes) { unique_counts.push_back(submesh.vertex_count); }
+
+  ThreadPool::ParallelFor(data.submeshes.size(), 1, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      const Assimp_SubmeshData &submesh = data.submeshes[i];
+      const size_t first = submesh.first_vertex;
+      const std::vector<glm::vec3> positions(data.positions.begin() + first, data.positions.begin() + first + submesh.vertex_count);
+      std::vector<uint64_t> keys(submesh.vertex_count);
+      for (uint32_t v = 0; v < submesh.vertex_count; v++) {
+        const WeldAttributes attributes = {data.normals[first + v], data.uvs[first + v], data.tangents[first + v]};
+        keys[v] = HashBytes(std::as_bytes(std::span(&attributes, 1)));
+      }
+
+      std::vector<glm::vec3> unique_positions;
+      const std::vector<uint32_t> remap = WeldVertices(positions, unique_positions, {.attribute_keys = keys});
+      if (remap.size() != submesh.vertex_count) { continue; }
+
+      // unique vertices are numbered in the order they first appear, so each one moves to the same place or further
+      // forward and the streams can be compacted in place
+      uint32_t unique_count = 0;
+      for (uint32_t v = 0; v < submesh.vertex_count; v++) {
+        if (remap[v] != unique_count) { continue; }
+        data.positions[first + unique_count] = data.positions[first + v];
+        data.normals[first + unique_count] = data.normals[first + v];
+        data.uvs[first + unique_count] = data.uvs[first + v];
+        data.tangents[first + unique_count] = data.tangents[first + v];
+        unique_count++;
+      }
+      for (uint32_t j = submesh.first_index; j < submesh.first_index + submesh.index_count; j++) { data.indices[j] = remap[data.indices[j]]; }
+      unique_counts[i] = unique_count;
+    }
+  });
+
+  // the submeshes' vertices are packed back to back again, each one's range only moves towards the front
+  const size_t vertex_count = data.positions.size();
+  uint32_t next_vertex = 0;
+  for (size_t i = 0; i < data.submeshes.size(); i++) {
+    Assimp_SubmeshData &submesh = data.submeshes[i];
+    const auto move = [&](auto &stream) {
+      std::copy(stream.begin() + submesh.first_vertex, stream.begin() + submesh.first_vertex + unique_counts[i], stream.begin() + next_vertex);
+    };
+    if (submesh.first_vertex != next_vertex) {
+      move(data.positions);
+      move(data.normals);
+      move(data.uvs);
+      move(data.tangents);
+    }
+    submesh.first_vertex = next_vertex;
+    submesh.vertex_count = unique_counts[i];
+    next_vertex += unique_counts[i];
+  }
+  data.positions.resize(next_vertex);
+  data.normals.resize(next_vertex);
+  data.uvs.resize(next_vertex);
+  data.tangents.resize(next_vertex);
+
+  GDEBUG_CH(Assets, "Welded {} vertices into {}", vertex_count, next_vertex);
+}
+
+static void AddStats(VertexCacheStats &total, const VertexCacheStats &stats) {
+  total.triangles += stats.triangles;
+  total.vertices_transformed += stats.vertices_transformed;
+  total.vertices_referenced += stats.vertices_referenced;
+}
+
+/**
+ * @brief Reorders the triangles and vertices of every submesh for the GPU, submeshes in parallel.
+ *
+ * Runs OptimizeVertexCache(), OptimizeOverdraw() and OptimizeVertexFetch() on each submesh within its own index and
+ * vertex ranges, and logs the ACMR and ATVR of the whole scene before and after.
+ *
+ * @param data Meshes from ExtractMeshes(), reordered in place.
+ */
+void AssimpImporter::OptimizeMeshes(Assimp_MeshData &data) {
+  GLACEON_PROFILE_FUNCTION();
+  std::vector<VertexCacheStats> before(data.submeshes.size());
+  std::vector<VertexCacheStats> after(data.submeshes.size());
+
+  ThreadPool::ParallelFor(data.submeshes.size(), 1, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      const Assimp_SubmeshData &submesh = data.submeshes[i];
+      const std::span<uint32_t> indices(data.indices.data() + submesh.first_index, submesh.index_count);
+      const auto vertices = [&]<typename T>(std::vector<T> &stream) {
+        return std::span<T>(stream.data() + submesh.first_vertex, submesh.vertex_count);
+      };
+
+      before[i] = AnalyzeVertexCache(indices, submesh.vertex_count);
+      OptimizeVertexCache(indices, submesh.vertex_count);
+      OptimizeOverdraw(indices, vertices(data.positions));
+      const std::vector<uint32_t> remap = OptimizeVertexFetch(indices, submesh.vertex_count);
+      RemapVertices(vertices(data.positions), remap);
+      RemapVertices(vertices(data.normals), remap);
+      RemapVertices(vertices(data.uvs), remap);
+      RemapVertices(vertices(data.tangents), remap);
+      after[i] = AnalyzeVertexCache(indices, submesh.vertex_count);
+    }
+  });
+
+  VertexCacheStats total_before;
+  VertexCacheStats total_after;
+  for (size_t i = 0; i < data.submeshes.size(); i++) {
+    AddStats(total_before, before[i]);
+    AddStats(total_after, after[i]);
+  }
+  if (total_before.triangles == 0) { return; }
+
+  const auto acmr = [](const VertexCacheStats &stats) { return static_cast<double>(stats.vertices_transformed) / stats.triangles; };
+  const auto atvr = [](const VertexCacheStats &stats) {
+    return static_cast<double>(stats.vertices_transformed) / std::max<uint32_t>(stats.vertices_referenced, 1);
+  };
+  GINFO_CH(Assets, "Optimized {} meshes for a {} entry vertex cache: ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}",
+           data.submeshes.size(), kVertexCacheSize, acmr(total_before), acmr(total_after), atvr(total_before), atvr(total_after));
+}
+
+// -------------------------- IMPORT CACHE --------------------------
+
+static std::mutex cache_mutex_;
+static std::optional<std::string> cache_directory_;// unset until first used, then $GLACEON_IMPORT_CACHE_DIR
+
+void AssimpImporter::SetCacheDirectory(const std::string &directory) {
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  cache_directory_ = directory;
+}
+
+std::string AssimpImporter::GetCacheDirectory() {
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  if (!cache_directory_) {
+    const char *directory = std::getenv("GLACEON_IMPORT_CACHE_DIR");
+    cache_directory_ = directory != nullptr ? directory : "import_cache";
+  }
+  return *cache_directory_;
+}
+
+/**
+ * @brief Names the cache entry of a file: <stem>-<path hash>-<key>.gmesh.
+ *
+ * The key hashes the file's contents along with kImportFlags, kMeshFileVersion and kImportCacheVersion, so changing any
+ * of them misses the old entry.  The path hash tells apart files of the same name in different directories.
+ *
+ * @param file_path The file to import.
+ * @return Path of its cache entry, which may not exist yet; empty if the cache is off or the file cannot be read.
+ */
+std::string AssimpImporter::GetCachePath(const std::string &file_path) {
+  GLACEON_PROFILE_FUNCTION();
+  const std::string directory = GetCacheDirectory();
+  if (directory.empty()) { return {}; }
+  std::error_code error;
+  if (!std::filesystem::is_regular_file(file_path, error)) {
+    GDEBUG_CH(Assets, "Not caching the import of {} - {}", file_path, error ? error.message() : std::string("not a regular file"));
+    return {};
   }
 
-  //   struct Assimp_MeshData {
-  //   std::vector<glm::vec3> positions;
-  //   std::vector<glm::vec3> normals;
-  //   std::vector<glm::vec2> uvs;
-  //   std::vector<uint32_t> indices;// indexes of material
-  // };
+  MappedFile source;
+  if (!source.Open(file_path)) { return {}; }
+  const uint32_t versions[] = {kImportFlags, kMeshFileVersion, kImportCacheVersion};
+  const uint64_t key = HashBytes({source.GetData(), source.GetSize()}, HashBytes(std::as_bytes(std::span(versions))));
 
-  return {};
+  const std::filesystem::path path = std::filesystem::weakly_canonical(file_path, error);
+  const std::string path_string = (error ? std::filesystem::path(file_path) : path).generic_string();
+  const auto path_hash = static_cast<uint32_t>(HashBytes(std::as_bytes(std::span(path_string))));
+
+  const std::string name = fmt::format("{}-{:08x}-{:016x}.gmesh", std::filesystem::path(file_path).stem().string(), path_hash, key);
+  return (std::filesystem::path(directory) / name).string();
+}
+
+// removes the entries of older versions of the file cached at cache_path, the ones with the same name up to the key
+void AssimpImporter::PruneCache(const std::string &cache_path) {
+  const std::filesystem::path entry_path(cache_path);
+  const std::string name = entry_path.filename().string();
+  const std::string prefix = name.substr(0, name.rfind('-') + 1);
+
+  std::error_code error;
+  std::error_code remove_error;
+  for (auto entry = std::filesystem::directory_iterator(entry_path.parent_path(), error);
+       !error && entry != std::filesystem::directory_iterator(); entry.increment(error)) {
+    const std::string entry_name = entry->path().filename().string();
+    if (entry_name != name && entry_name.starts_with(prefix) && entry_name.ends_with(".gmesh")) {
+      GDEBUG_CH(Assets, "Removing stale import cache entry {}", entry_name);
+      std::filesystem::remove(entry->path(), remove_error);
+    }
+  }
 }
+
+bool AssimpImporter::WriteMeshes(const Assimp_MeshData &meshes, const std::string &output_path) {
+  GLACEON_PROFILE_FUNCTION();
+  std::error_code error;
+  if (const std::filesystem::path directory = std::filesystem::path(output_path).parent_path(); !directory.empty()) {
+    std::filesystem::create_directories(directory, error);
+  }
+
+  // mesh files index the whole vertex range, so every submesh is drawn from one vertex buffer
+  const std::vector<uint32_t> indices = GetSceneIndices(meshes);
+  std::vector<MeshFileSubmesh> submeshes;
+  submeshes.reserve(meshes.submeshes.size());
+  for (const Assimp_SubmeshData &submesh : meshes.submeshes) {
+    submeshes.push_back({.first_vertex = submesh.first_vertex,
+                         .vertex_count = submesh.vertex_count,
+                         .first_index = submesh.first_index,
+                         .index_count = submesh.index_count,
+                         .material_index = submesh.material_index});
+  }
+
+  return WriteMeshFile(output_path, {.positions = meshes.positions,
+                                     .normals = meshes.normals,
+                                     .uvs = meshes.uvs,
+                                     .tangents = meshes.tangents,
+                                     .indices = indices,
+                                     .submeshes = submeshes});
+}
+
+// The mesh file back in the layout ExtractMeshes() returns, empty if it cannot be read
+Assimp_MeshData AssimpImporter::ReadMeshes(const std::string &cache_path) {
+  GLACEON_PROFILE_FUNCTION();
+  MeshFile file;
+  if (!file.Open(cache_path)) { return {}; }
+
+  Assimp_MeshData meshes;
+  const std::span<const glm::vec3> positions = file.GetPositions();
+  const std::span<const glm::vec3> normals = file.GetNormals();
+  const std::span<const glm::vec2> uvs = file.GetUvs();
+  const std::span<const glm::vec4> tangents = file.GetTangents();
+  const std::span<const uint32_t> indices = file.GetIndices();
+  meshes.positions.assign(positions.begin(), positions.end());
+  meshes.normals.assign(normals.begin(), normals.end());
+  meshes.uvs.assign(uvs.begin(), uvs.end());
+  meshes.tangents.assign(tangents.begin(), tangents.end());
+  meshes.indices.assign(indices.begin(), indices.end());
+  // ExtractMeshes() always fills every stream, zeros for what the meshes do not have
+  meshes.normals.resize(positions.size());
+  meshes.uvs.resize(positions.size());
+  meshes.tangents.resize(positions.size());
+
+  // MeshFile::Open() checked that every submesh's indices lie within its own vertices
+  for (const MeshFileSubmesh &submesh : file.GetSubmeshes()) {
+    for (uint32_t i = submesh.first_index; i < submesh.first_index + submesh.index_count; i++) { meshes.indices[i] -= submesh.first_vertex; }
+    meshes.submeshes.push_back({.first_vertex = submesh.first_vertex,
+                                .vertex_count = submesh.vertex_count,
+                                .first_index = submesh.first_index,
+                                .index_count = submesh.index_count,
+                                .material_index = submesh.material_index});
+  }
+  return meshes;
+}
+
 }// namespace glaceon
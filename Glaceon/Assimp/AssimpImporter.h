@@ -5,31 +5,70 @@
 
 #include "../Core/Base.h"
 
+namespace Assimp {
+class Importer;
+}
+
 namespace glaceon {
 
 struct Assimp_ModelData {
   std::vector<glm::vec3> vert_data;
+  std::vector<uint32_t> indices;// triangle lists of every mesh, into the whole of vert_data
   glm::vec3 diffuse_color;
   // std::vector<glm::vec3> uv_data;
 };
 
+// One aiMesh's part of Assimp_MeshData: its vertices are [first_vertex, first_vertex + vertex_count) of every vertex
+// stream, its indices [first_index, first_index + index_count) of indices
+struct Assimp_SubmeshData {
+  uint32_t first_vertex = 0;
+  uint32_t vertex_count = 0;
+  uint32_t first_index = 0;
+  uint32_t index_count = 0;
+  uint32_t material_index = 0;
+};
+
+// Every triangle mesh of a scene in one set of buffers, one entry per vertex in each stream.  Attributes a mesh does
+// not have are left zero.
 struct Assimp_MeshData {
   std::vector<glm::vec3> positions;
   std::vector<glm::vec3> normals;
   std::vector<glm::vec2> uvs;
-  std::vector<uint32_t> indices;// indexes of material
+  std::vector<glm::vec4> tangents;// w is the handedness of the bitangent, +1 or -1
+  std::vector<uint32_t> indices;  // triangle lists, relative to their submesh's first_vertex
+  std::vector<Assimp_SubmeshData> submeshes;
 };
 
+// Imports go through a disk cache of mesh files (see MeshFile.h), keyed by the file's contents, the import flags and
+// kMeshFileVersion, so a file assimp has seen before is mapped instead of imported again.  The cache lives in
+// $GLACEON_IMPORT_CACHE_DIR, or import_cache in the working directory.
 class AssimpImporter {
  public:
+  // positions of every mesh in the file along with their triangles, in the order ImportMeshes() leaves them
   static Assimp_ModelData GLACEON_API ImportObjectModel(const std::string &obj_file);
+  // every triangle mesh in the file with its normals, UVs, tangents and indices, identical vertices welded and
+  // triangles and vertices reordered for the GPU (see MeshOptimizer.h)
+  static Assimp_MeshData GLACEON_API ImportMeshes(const std::string &file_path);
+  // imports file_path, never from the cache, and writes it to output_path as a mesh file
+  static bool GLACEON_API CookMeshes(const std::string &file_path, const std::string &output_path);
+
+  // empty turns the cache off
+  static void GLACEON_API SetCacheDirectory(const std::string &directory);
+  [[nodiscard]] static std::string GLACEON_API GetCacheDirectory();
 
  private:
+  static Assimp_MeshData ImportUncached(const std::string &file_path);
+  static const aiScene *ReadScene(Assimp::Importer &importer, const std::string &file_path);
   static void PrintMaterialProperties(const aiMaterial *material);
-  static std::vector<glm::vec3> GetVertexData(const aiScene *scene, size_t mesh_idx);
-  static std::vector<glm::vec3> GetUVData(const aiScene *scene, size_t mesh_idx);
 
   static Assimp_MeshData ExtractMeshes(const aiScene *scene_obj);
+  static void WeldMeshes(Assimp_MeshData &data);
+  static void OptimizeMeshes(Assimp_MeshData &data);
+
+  static std::string GetCachePath(const std::string &file_path);
+  static bool WriteMeshes(const Assimp_MeshData &meshes, const std::string &output_path);
+  static Assimp_MeshData ReadMeshes(const std::string &cache_path);
+  static void PruneCache(const std::string &cache_path);
 };
 }// namespace glaceon
 
@@ -0,0 +1,192 @@
+#include "DeferredLog.h"
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "Logger.h"
+
+namespace glaceon {
+
+static_assert(DeferredLog::kRingSize % DeferredLog::kRecordAlignment == 0, "ring must hold a whole number of records");
+// records above this are dropped rather than letting one message take most of the ring
+static constexpr size_t kMaxRecordSize = DeferredLog::kRingSize / 4;
+
+// Single producer, single consumer ring of one thread.  head and tail only grow, their difference is the number of
+// bytes in use.  A record that does not fit before the end of the buffer is placed at the start, behind a padding
+// record, or behind nothing if not even a header fits.  Like the Profiler's ThreadTrace a ring outlives its thread,
+// so records it made are still written, and is handed to the next new thread.
+struct ThreadRing {
+  alignas(64) std::atomic<uint64_t> head{0};// published by the owning thread
+  alignas(64) std::atomic<uint64_t> tail{0};// advanced by the thread in Flush()
+  uint64_t pending_head = 0;                // head after the record between BeginRecord() and EndRecord()
+  std::atomic<uint64_t> dropped{0};
+  std::unique_ptr<std::byte[]> data = std::make_unique<std::byte[]>(DeferredLog::kRingSize);
+  std::atomic<bool> in_use{true};
+  ThreadRing *next = nullptr;
+};
+
+static std::atomic<ThreadRing *> thread_rings_head_{nullptr};
+
+// consumer state
+static std::mutex flush_mutex_;
+static fmt::memory_buffer flush_buffer_;
+static uint64_t reported_dropped_ = 0;
+
+// background thread
+static std::mutex thread_mutex_;
+static std::condition_variable thread_wake_;
+static std::thread thread_;
+static bool stop_thread_ = false;
+
+// joins a thread that is still running at exit, without flushing since the loggers may be gone already
+struct ThreadGuard {
+  ~ThreadGuard() {
+    if (!thread_.joinable()) { return; }
+    {
+      std::lock_guard<std::mutex> lock(thread_mutex_);
+      stop_thread_ = true;
+    }
+    thread_wake_.notify_one();
+    thread_.join();
+  }
+};
+static ThreadGuard thread_guard_;
+
+static ThreadRing *AcquireThreadRing() {
+  for (ThreadRing *ring = thread_rings_head_.load(std::memory_order_acquire); ring != nullptr; ring = ring->next) {
+    bool expected = false;
+    if (ring->in_use.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) { return ring; }
+  }
+
+  auto *ring = new ThreadRing();
+  ring->next = thread_rings_head_.load(std::memory_order_relaxed);
+  while (!thread_rings_head_.compare_exchange_weak(ring->next, ring, std::memory_order_release, std::memory_order_relaxed)) {}
+  return ring;
+}
+
+struct ThreadRingHolder {
+  ThreadRing *ring = AcquireThreadRing();
+  ~ThreadRingHolder() { ring->in_use.store(false, std::memory_order_release); }
+};
+
+static thread_local ThreadRingHolder thread_ring_;
+
+static size_t AlignRecordSize(size_t size) { return (size + DeferredLog::kRecordAlignment - 1) & ~(DeferredLog::kRecordAlignment - 1); }
+
+/**
+ * @brief Reserves space for a record in the calling thread's ring and fills in its header.
+ *
+ * @param site Call site of the record.
+ * @param args_size Bytes of encoded arguments that follow the header.
+ * @return Where to write the arguments, or nullptr if the ring is full and the record was dropped.
+ */
+std::byte *DeferredLog::BeginRecord(const DeferredLogSite &site, size_t args_size) {
+  ThreadRing &ring = *thread_ring_.ring;
+  const size_t size = AlignRecordSize(sizeof(DeferredLogRecord) + args_size);
+  uint64_t head = ring.head.load(std::memory_order_relaxed);
+  const size_t contiguous = kRingSize - head % kRingSize;
+  const size_t padding = contiguous < size ? contiguous : 0;
+  if (size > kMaxRecordSize || head + padding + size - ring.tail.load(std::memory_order_acquire) > kRingSize) {
+    ring.dropped.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+
+  if (padding >= sizeof(DeferredLogRecord)) {
+    auto *padding_record = reinterpret_cast<DeferredLogRecord *>(ring.data.get() + head % kRingSize);
+    *padding_record = {nullptr, 0, padding};
+  }
+  head += padding;
+
+  auto *record = reinterpret_cast<DeferredLogRecord *>(ring.data.get() + head % kRingSize);
+  *record = {&site, spdlog::log_clock::now().time_since_epoch().count(), size};
+  ring.pending_head = head + size;
+  return reinterpret_cast<std::byte *>(record + 1);
+}
+
+void DeferredLog::EndRecord() {
+  ThreadRing &ring = *thread_ring_.ring;
+  ring.head.store(ring.pending_head, std::memory_order_release);
+}
+
+/**
+ * @brief Formats the records of every thread and hands them to their channel's logger, oldest first per thread.
+ */
+void DeferredLog::Flush() {
+  std::lock_guard<std::mutex> lock(flush_mutex_);
+  uint64_t dropped = 0;
+  for (ThreadRing *ring = thread_rings_head_.load(std::memory_order_acquire); ring != nullptr; ring = ring->next) {
+    dropped += ring->dropped.load(std::memory_order_relaxed);
+    const uint64_t head = ring->head.load(std::memory_order_acquire);
+    uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+    while (tail < head) {
+      const size_t contiguous = kRingSize - tail % kRingSize;
+      if (contiguous < sizeof(DeferredLogRecord)) {
+        tail += contiguous;
+        continue;
+      }
+
+      const auto *record = reinterpret_cast<const DeferredLogRecord *>(ring->data.get() + tail % kRingSize);
+      if (record->site != nullptr) {
+        const DeferredLogSite &site = *record->site;
+        flush_buffer_.clear();
+        try {
+          site.format_args(site, reinterpret_cast<const std::byte *>(record + 1), flush_buffer_);
+        } catch (const fmt::format_error &error) {
+          flush_buffer_.clear();
+          fmt::format_to(fmt::appender(flush_buffer_), "[format error: {}] {}", error.what(), site.format);
+        }
+        const spdlog::log_clock::time_point time{spdlog::log_clock::duration(record->time)};
+        Logger::Get(site.channel)->log(time, spdlog::source_loc{}, site.level,
+                                       spdlog::string_view_t(flush_buffer_.data(), flush_buffer_.size()));
+      }
+      tail += record->size;
+      // hand the space back right away so a busy producer drops as little as possible
+      ring->tail.store(tail, std::memory_order_release);
+    }
+  }
+
+  if (dropped > reported_dropped_) {
+    GWARN("DeferredLog: {} messages dropped, rings were full", dropped - reported_dropped_);
+    reported_dropped_ = dropped;
+  }
+}
+
+void DeferredLog::Start(std::chrono::milliseconds interval) {
+  std::lock_guard<std::mutex> lock(thread_mutex_);
+  if (thread_.joinable()) { return; }
+
+  stop_thread_ = false;
+  thread_ = std::thread([interval] {
+    std::unique_lock<std::mutex> thread_lock(thread_mutex_);
+    while (!stop_thread_) {
+      // stopped, Stop() flushes what is left itself and ThreadGuard must not flush at all
+      if (thread_wake_.wait_for(thread_lock, interval, [] { return stop_thread_; })) { break; }
+      thread_lock.unlock();
+      Flush();
+      thread_lock.lock();
+    }
+  });
+}
+
+void DeferredLog::Stop() {
+  std::unique_lock<std::mutex> lock(thread_mutex_);
+  if (thread_.joinable()) {
+    stop_thread_ = true;
+    lock.unlock();
+    thread_wake_.notify_one();
+    thread_.join();
+  }
+  Flush();
+}
+
+uint64_t DeferredLog::GetDroppedCount() {
+  uint64_t dropped = 0;
+  for (ThreadRing *ring = thread_rings_head_.load(std::memory_order_acquire); ring != nullptr; ring = ring->next) {
+    dropped += ring->dropped.load(std::memory_order_relaxed);
+  }
+  return dropped;
+}
+
+}// namespace glaceon
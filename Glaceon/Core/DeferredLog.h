@@ -0,0 +1,166 @@
+#ifndef GLACEON_GLACEON_CORE_DEFERREDLOG_H_
+#define GLACEON_GLACEON_CORE_DEFERREDLOG_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+#include "../pch.h"
+
+namespace glaceon {
+
+enum class LogChannel : uint8_t;// Logger.h
+
+struct DeferredLogSite;
+// decodes the raw arguments recorded for site and formats them into out
+using DeferredFormatFn = void (*)(const DeferredLogSite &site, const std::byte *args, fmt::memory_buffer &out);
+
+// Static data of one GTRACE/GDEBUG call site; its address is the id records refer to.
+struct DeferredLogSite {
+  std::string_view format;
+  LogChannel channel;
+  spdlog::level::level_enum level;
+  DeferredFormatFn format_args;
+};
+
+// Record header, followed by the encoded arguments and padded to kRecordAlignment.
+struct DeferredLogRecord {
+  const DeferredLogSite *site;// nullptr for the padding at the end of the ring
+  int64_t time;               // spdlog::log_clock ticks
+  uint64_t size;              // including this header and the padding
+};
+
+namespace deferred_log_detail {
+
+// Arguments that can be copied into the ring and formatted later.  Numbers are copied as they are, strings by value
+// since whatever the pointer points to may be gone by the time the record is formatted.
+template<typename T>
+struct ArgCodec {
+  static constexpr bool kDeferrable = std::is_arithmetic_v<T>;
+  using Decoded = T;
+  static size_t Size(const T &) { return sizeof(T); }
+  static std::byte *Write(std::byte *out, const T &value) {
+    std::memcpy(out, &value, sizeof(T));
+    return out + sizeof(T);
+  }
+  static T Read(const std::byte *&in) {
+    T value;
+    std::memcpy(&value, in, sizeof(T));
+    in += sizeof(T);
+    return value;
+  }
+};
+
+template<>
+struct ArgCodec<std::string_view> {
+  static constexpr bool kDeferrable = true;
+  using Decoded = std::string_view;
+  static size_t Size(std::string_view value) { return sizeof(uint32_t) + value.size(); }
+  static std::byte *Write(std::byte *out, std::string_view value) {
+    const auto size = static_cast<uint32_t>(value.size());
+    std::memcpy(out, &size, sizeof(size));
+    std::memcpy(out + sizeof(size), value.data(), size);
+    return out + sizeof(size) + size;
+  }
+  static std::string_view Read(const std::byte *&in) {
+    uint32_t size;
+    std::memcpy(&size, in, sizeof(size));
+    std::string_view value(reinterpret_cast<const char *>(in + sizeof(size)), size);
+    in += sizeof(size) + size;
+    return value;
+  }
+};
+
+template<>
+struct ArgCodec<const char *> : ArgCodec<std::string_view> {};
+template<>
+struct ArgCodec<char *> : ArgCodec<std::string_view> {};
+template<>
+struct ArgCodec<std::string> : ArgCodec<std::string_view> {};
+
+template<typename T>
+using Codec = ArgCodec<std::remove_cv_t<std::decay_t<T>>>;
+
+template<typename... Args>
+void FormatArgs(const DeferredLogSite &site, [[maybe_unused]] const std::byte *in, fmt::memory_buffer &out) {
+  // braced initialization reads the arguments in order
+  const std::tuple<typename Codec<Args>::Decoded...> args{Codec<Args>::Read(in)...};
+  std::apply(
+      [&](const auto &...values) {
+        fmt::vformat_to(fmt::appender(out), fmt::string_view(site.format.data(), site.format.size()), fmt::make_format_args(values...));
+      },
+      args);
+}
+
+}// namespace deferred_log_detail
+
+// Log records that are formatted later.
+//
+// The calling thread only copies a pointer to the call site's static DeferredLogSite and the raw arguments into a ring
+// buffer of its own; formatting and writing to the Logger happen on the DeferredLog thread started by Start(), or in
+// Flush(), where the channel level is checked again.  A full ring drops the new record and counts it.  Records keep
+// their timestamp, but records of different threads, and the ones of regular GINFO etc. calls, can come out in a
+// different order than they were made.
+//
+// Arguments other than numbers and strings are formatted on the spot and recorded as text.  Records made while the
+// thread is not running stay in the ring until the next Flush().
+class DeferredLog {
+ public:
+  static constexpr size_t kRingSize = 256 * 1024;// per thread
+  static constexpr size_t kRecordAlignment = alignof(DeferredLogRecord);
+
+  // starts the thread that drains the rings every interval
+  static void Start(std::chrono::milliseconds interval = std::chrono::milliseconds(20));
+  // stops the thread and writes out what is left
+  static void Stop();
+  // formats and writes every record made so far, from the calling thread
+  static void Flush();
+  [[nodiscard]] static uint64_t GetDroppedCount();
+
+  // SiteTag is a unique type per call site, see GDEFER
+  template<typename SiteTag, typename... Args>
+  static void Write(SiteTag, LogChannel channel, spdlog::level::level_enum level, [[maybe_unused]] fmt::format_string<Args...> format,
+                    Args &&...args) {
+    if constexpr ((deferred_log_detail::Codec<Args>::kDeferrable && ...)) {
+      static const DeferredLogSite site = {SiteTag{}(), channel, level, &deferred_log_detail::FormatArgs<Args...>};
+      const size_t args_size = (size_t{0} + ... + deferred_log_detail::Codec<Args>::Size(args));
+      std::byte *out = BeginRecord(site, args_size);
+      if (out == nullptr) { return; }
+      ((out = deferred_log_detail::Codec<Args>::Write(out, args)), ...);
+      EndRecord();
+    } else {
+      static const DeferredLogSite site = {"{}", channel, level, &deferred_log_detail::FormatArgs<std::string_view>};
+      const fmt::memory_buffer text = FormatNow(format, std::forward<Args>(args)...);
+      const std::string_view text_view(text.data(), text.size());
+      std::byte *out = BeginRecord(site, deferred_log_detail::Codec<std::string_view>::Size(text_view));
+      if (out == nullptr) { return; }
+      deferred_log_detail::Codec<std::string_view>::Write(out, text_view);
+      EndRecord();
+    }
+  }
+
+ private:
+  // reserves a record of the calling thread's ring, nullptr if it is full
+  static std::byte *BeginRecord(const DeferredLogSite &site, size_t args_size);
+  static void EndRecord();
+
+  template<typename... Args>
+  static fmt::memory_buffer FormatNow(fmt::format_string<Args...> format, Args &&...args) {
+    fmt::memory_buffer text;
+    fmt::format_to(fmt::appender(text), format, std::forward<Args>(args)...);
+    return text;
+  }
+};
+
+}// namespace glaceon
+
+// Records a message for the DeferredLog.  The lambda gives every call site its own type, and with it its own static
+// DeferredLogSite, while fmt checks the format string against the arguments at compile time.
+#define GDEFER(channel, level, fmt_str, ...)                                                                               \
+  glaceon::DeferredLog::Write([]() -> std::string_view { return fmt_str; }, channel, level,                              \
+                              fmt_str __VA_OPT__(, ) __VA_ARGS__)
+
+#endif// GLACEON_GLACEON_CORE_DEFERREDLOG_H_
@@ -1,13 +1,93 @@
 #include "Logger.h"
 
+#include <spdlog/async.h>
+#include <spdlog/sinks/rotating_file_sink.h>
+
 namespace glaceon {
 
-std::shared_ptr<spdlog::logger> Logger::p_console_logger_;
+std::array<std::shared_ptr<spdlog::logger>, kNumLogChannels> Logger::loggers_;
+std::shared_ptr<spdlog::details::thread_pool> Logger::thread_pool_;
+
+static_assert(GLACEON_LOG_LEVEL_TRACE == SPDLOG_LEVEL_TRACE && GLACEON_LOG_LEVEL_OFF == SPDLOG_LEVEL_OFF,
+              "GLACEON_LOG_LEVEL values must match spdlog's");
+
+static constexpr const char *kChannelNames[kNumLogChannels] = {"GLACEON", "RENDERER", "ASSETS", "MEMORY"};
+
+static spdlog::async_overflow_policy ToSpdlogPolicy(LogOverflowPolicy policy) {
+  switch (policy) {
+    case LogOverflowPolicy::kBlock:
+      return spdlog::async_overflow_policy::block;
+    case LogOverflowPolicy::kOverrunOldest:
+      return spdlog::async_overflow_policy::overrun_oldest;
+    case LogOverflowPolicy::kDiscardNew:
+#if SPDLOG_VERSION >= 11200
+      return spdlog::async_overflow_policy::discard_new;
+#else
+      return spdlog::async_overflow_policy::overrun_oldest;
+#endif
+  }
+  return spdlog::async_overflow_policy::block;
+}
+
+/**
+ * @brief Creates one logger per LogChannel, all sharing a colored stdout sink and, if configured, a rotating file sink.
+ *
+ * In async mode the loggers only queue messages; a single background thread formats and writes them, so the sinks see
+ * them in order.  Errors flush immediately so they are not left in the queue if the application goes down right after.
+ */
+void Logger::InitLoggers(const LoggerConfig &config) {
+  std::vector<spdlog::sink_ptr> sinks;
+  sinks.push_back(std::make_shared<spdlog::sinks::stdout_color_sink_mt>());
+  if (!config.file_path.empty()) {
+    sinks.push_back(std::make_shared<spdlog::sinks::rotating_file_sink_mt>(config.file_path, config.max_file_size, config.max_files));
+  }
+
+  if (config.async) { thread_pool_ = std::make_shared<spdlog::details::thread_pool>(config.queue_size, 1); }
+
+  for (size_t i = 0; i < kNumLogChannels; i++) {
+    std::shared_ptr<spdlog::logger> logger;
+    if (config.async) {
+      logger = std::make_shared<spdlog::async_logger>(kChannelNames[i], sinks.begin(), sinks.end(), thread_pool_,
+                                                      ToSpdlogPolicy(config.overflow_policy));
+    } else {
+      logger = std::make_shared<spdlog::logger>(kChannelNames[i], sinks.begin(), sinks.end());
+    }
+    // set minimum level to show
+    // trace, debug, info, warn, error, critical -> lowest to highest level
+    logger->set_level(config.levels[i]);
+    logger->flush_on(spdlog::level::err);
+    loggers_[i] = std::move(logger);
+  }
+}
+
+void Logger::Shutdown() {
+  if (thread_pool_ == nullptr) {
+    for (std::shared_ptr<spdlog::logger> &logger : loggers_) {
+      if (logger != nullptr) { logger->flush(); }
+    }
+    return;
+  }
+
+  // synchronous replacements first, so messages logged from now on go straight to the sinks
+  for (std::shared_ptr<spdlog::logger> &logger : loggers_) {
+    auto sync_logger = std::make_shared<spdlog::logger>(logger->name(), logger->sinks().begin(), logger->sinks().end());
+    sync_logger->set_level(logger->level());
+    sync_logger->flush_on(spdlog::level::err);
+    logger = std::move(sync_logger);
+  }
+  // the pool's destructor lets its thread write out what is still queued before joining it
+  thread_pool_.reset();
+  for (std::shared_ptr<spdlog::logger> &logger : loggers_) { logger->flush(); }
+}
 
-void Logger::InitLoggers() {
-  p_console_logger_ = spdlog::stdout_color_mt("GLACEON");
-  // set minimum level to show to stdout
-  // trace, info, warn, error, critical -> lowest to highest level
-  p_console_logger_->set_level(spdlog::level::trace);
+void Logger::SetLevel(LogChannel channel, spdlog::level::level_enum level) { loggers_[static_cast<size_t>(channel)]->set_level(level); }
+
+void Logger::SetLevel(spdlog::level::level_enum level) {
+  for (std::shared_ptr<spdlog::logger> &logger : loggers_) { logger->set_level(level); }
 }
+
+spdlog::level::level_enum Logger::GetLevel(LogChannel channel) { return loggers_[static_cast<size_t>(channel)]->level(); }
+
+const char *Logger::GetChannelName(LogChannel channel) { return kChannelNames[static_cast<size_t>(channel)]; }
+
 }// namespace glaceon
@@ -2,24 +2,77 @@
 #define GLACEON_GLACEON_LOGGER_H_
 
 #include "../pch.h"
+#include "DeferredLog.h"
 
+// Messages below GLACEON_LOG_LEVEL are compiled out, arguments included.  The values are spdlog's levels: 0 trace,
+// 1 debug, 2 info, 3 warn, 4 error, 5 critical, 6 off.  Defaults to trace for debug builds and info otherwise.
+#define GLACEON_LOG_LEVEL_TRACE 0
+#define GLACEON_LOG_LEVEL_DEBUG 1
+#define GLACEON_LOG_LEVEL_INFO 2
+#define GLACEON_LOG_LEVEL_WARN 3
+#define GLACEON_LOG_LEVEL_ERROR 4
+#define GLACEON_LOG_LEVEL_CRITICAL 5
+#define GLACEON_LOG_LEVEL_OFF 6
+
+#ifndef GLACEON_LOG_LEVEL
 #ifdef _DEBUG
-#define DEBUG_LOG_ENABLED 1
-#define TRACE_LOG_ENABLED 1
+#define GLACEON_LOG_LEVEL GLACEON_LOG_LEVEL_TRACE
 #else
-#define DEBUG_LOG_ENABLED 0
-#define TRACE_LOG_ENABLED 0
+#define GLACEON_LOG_LEVEL GLACEON_LOG_LEVEL_INFO
+#endif
 #endif
 
+namespace spdlog::details {
+class thread_pool;
+}// namespace spdlog::details
+
 namespace glaceon {
 
+// every channel is its own logger, with its own level, writing to the same sinks
+enum class LogChannel : uint8_t { kCore, kRenderer, kAssets, kMemory, kCount };
+constexpr size_t kNumLogChannels = static_cast<size_t>(LogChannel::kCount);
+
+// what an async logger does when its queue is full
+enum class LogOverflowPolicy : uint8_t {
+  kBlock,        // wait for the logging thread to make room
+  kOverrunOldest,// drop the oldest queued message
+  kDiscardNew,   // drop the new message, cheapest for the caller
+};
+
+struct LoggerConfig {
+  // format and write messages on a background thread instead of the calling one
+  bool async = true;
+  size_t queue_size = 8192;// messages, rounded by spdlog
+  LogOverflowPolicy overflow_policy = LogOverflowPolicy::kOverrunOldest;
+
+  // also write to a size capped set of rotating files, e.g. glaceon.log, glaceon.1.log ...; empty for console only
+  std::string file_path;
+  size_t max_file_size = 8 * 1024 * 1024;
+  size_t max_files = 3;
+
+  // initial level of each channel, see Logger::SetLevel(); assets default to info since GTRACE there runs per vertex
+  std::array<spdlog::level::level_enum, kNumLogChannels> levels = {spdlog::level::trace, spdlog::level::trace, spdlog::level::info,
+                                                                   spdlog::level::trace};
+};
+
 class Logger {
  public:
-  static void InitLoggers();
-  static inline std::shared_ptr<spdlog::logger> &GetConsoleLogger() { return p_console_logger_; }
+  static void InitLoggers(const LoggerConfig &config = {});
+  // drains the async queue and switches to synchronous logging, so nothing logged before is lost and logging after still
+  // works; other threads must have stopped logging
+  static void Shutdown();
+
+  static inline std::shared_ptr<spdlog::logger> &GetConsoleLogger() { return loggers_[static_cast<size_t>(LogChannel::kCore)]; }
+  static inline spdlog::logger *Get(LogChannel channel) { return loggers_[static_cast<size_t>(channel)].get(); }
+
+  static void SetLevel(LogChannel channel, spdlog::level::level_enum level);
+  static void SetLevel(spdlog::level::level_enum level);// every channel
+  static spdlog::level::level_enum GetLevel(LogChannel channel);
+  static const char *GetChannelName(LogChannel channel);
 
  private:
-  static std::shared_ptr<spdlog::logger> p_console_logger_;
+  static std::array<std::shared_ptr<spdlog::logger>, kNumLogChannels> loggers_;
+  static std::shared_ptr<spdlog::details::thread_pool> thread_pool_;
 };
 
 }// namespace glaceon
@@ -29,21 +82,66 @@ class Logger {
 //
 // C++ 20 standard affords us the capability to use variadic macros with the __VA_OPT__ macro
 // https://gcc.gnu.org/onlinedocs/cpp/Variadic-Macros.html
-#if (DEBUG_LOG_ENABLED)
-#define GDEBUG(fmt_str, ...) Glaceon::Logger::GetConsoleLogger()->debug(fmt_str __VA_OPT__(,) __VA_ARGS__)
+//
+// The level is checked before the arguments are evaluated, so a filtered out message costs a load and a compare.
+#define GLOG(channel, level, fmt_str, ...)                                                                                       \
+  do {                                                                                                                           \
+    spdlog::logger *glaceon_logger = glaceon::Logger::Get(channel);                                                              \
+    if (glaceon_logger->should_log(level)) { glaceon_logger->log(level, fmt_str __VA_OPT__(, ) __VA_ARGS__); }                   \
+  } while (0)
+
+// Same, but only the call site and the raw arguments are recorded; see DeferredLog
+#define GLOG_DEFERRED(channel, level, fmt_str, ...)                                                                             \
+  do {                                                                                                                           \
+    if (glaceon::Logger::Get(channel)->should_log(level)) { GDEFER(channel, level, fmt_str __VA_OPT__(, ) __VA_ARGS__); }        \
+  } while (0)
+
+// GXXX_CH(Assets, ...) logs to LogChannel::kAssets, GXXX(...) to LogChannel::kCore.  Trace and debug messages are the
+// ones in hot loops, they go through the DeferredLog.
+#if GLACEON_LOG_LEVEL <= GLACEON_LOG_LEVEL_TRACE
+#define GTRACE_CH(channel, fmt_str, ...) \
+  GLOG_DEFERRED(glaceon::LogChannel::k##channel, spdlog::level::trace, fmt_str __VA_OPT__(, ) __VA_ARGS__)
+#else
+#define GTRACE_CH(channel, fmt_str, ...) ((void) 0)
+#endif
+
+#if GLACEON_LOG_LEVEL <= GLACEON_LOG_LEVEL_DEBUG
+#define GDEBUG_CH(channel, fmt_str, ...) \
+  GLOG_DEFERRED(glaceon::LogChannel::k##channel, spdlog::level::debug, fmt_str __VA_OPT__(, ) __VA_ARGS__)
+#else
+#define GDEBUG_CH(channel, fmt_str, ...) ((void) 0)
+#endif
+
+#if GLACEON_LOG_LEVEL <= GLACEON_LOG_LEVEL_INFO
+#define GINFO_CH(channel, fmt_str, ...) GLOG(glaceon::LogChannel::k##channel, spdlog::level::info, fmt_str __VA_OPT__(, ) __VA_ARGS__)
+#else
+#define GINFO_CH(channel, fmt_str, ...) ((void) 0)
+#endif
+
+#if GLACEON_LOG_LEVEL <= GLACEON_LOG_LEVEL_WARN
+#define GWARN_CH(channel, fmt_str, ...) GLOG(glaceon::LogChannel::k##channel, spdlog::level::warn, fmt_str __VA_OPT__(, ) __VA_ARGS__)
+#else
+#define GWARN_CH(channel, fmt_str, ...) ((void) 0)
+#endif
+
+#if GLACEON_LOG_LEVEL <= GLACEON_LOG_LEVEL_ERROR
+#define GERROR_CH(channel, fmt_str, ...) GLOG(glaceon::LogChannel::k##channel, spdlog::level::err, fmt_str __VA_OPT__(, ) __VA_ARGS__)
 #else
-#define GDEBUG(fmt_str, ...)
+#define GERROR_CH(channel, fmt_str, ...) ((void) 0)
 #endif
 
-#if (TRACE_LOG_ENABLED)
-#define GTRACE(fmt_str, ...) glaceon::Logger::GetConsoleLogger()->trace(fmt_str __VA_OPT__(,) __VA_ARGS__)
+#if GLACEON_LOG_LEVEL <= GLACEON_LOG_LEVEL_CRITICAL
+#define GCRITICAL_CH(channel, fmt_str, ...) \
+  GLOG(glaceon::LogChannel::k##channel, spdlog::level::critical, fmt_str __VA_OPT__(, ) __VA_ARGS__)
 #else
-#define GTRACE(fmt_str, ...)
+#define GCRITICAL_CH(channel, fmt_str, ...) ((void) 0)
 #endif
 
-#define GINFO(fmt_str, ...) glaceon::Logger::GetConsoleLogger()->info(fmt_str __VA_OPT__(,) __VA_ARGS__)
-#define GWARN(fmt_str, ...) glaceon::Logger::GetConsoleLogger()->warn(fmt_str __VA_OPT__(,) __VA_ARGS__)
-#define GERROR(fmt_str, ...) glaceon::Logger::GetConsoleLogger()->error(fmt_str __VA_OPT__(,) __VA_ARGS__)
-#define GCRITICAL(fmt_str, ...) Glaceon::Logger::GetConsoleLogger()->critical(fmt_str __VA_OPT__(,) __VA_ARGS__)
+#define GDEBUG(fmt_str, ...) GDEBUG_CH(Core, fmt_str __VA_OPT__(, ) __VA_ARGS__)
+#define GTRACE(fmt_str, ...) GTRACE_CH(Core, fmt_str __VA_OPT__(, ) __VA_ARGS__)
+#define GINFO(fmt_str, ...) GINFO_CH(Core, fmt_str __VA_OPT__(, ) __VA_ARGS__)
+#define GWARN(fmt_str, ...) GWARN_CH(Core, fmt_str __VA_OPT__(, ) __VA_ARGS__)
+#define GERROR(fmt_str, ...) GERROR_CH(Core, fmt_str __VA_OPT__(, ) __VA_ARGS__)
+#define GCRITICAL(fmt_str, ...) GCRITICAL_CH(Core, fmt_str __VA_OPT__(, ) __VA_ARGS__)
 
 #endif// GLACEON_GLACEON_LOGGER_H_
@@ -0,0 +1,120 @@
+#include "MappedFile.h"
+
+#ifdef _WIN64
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <utility>
+
+#include "Logger.h"
+
+namespace glaceon {
+
+MappedFile::~MappedFile() { Close(); }
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)) {}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+  if (this != &other) {
+    Close();
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+  }
+  return *this;
+}
+
+/**
+ * @brief Maps the whole of file_path read-only, replacing whatever was mapped before.
+ *
+ * The file and mapping handles are closed again straight away, the view keeps the file open until Close().
+ *
+ * @param file_path File to map.
+ * @return false if the file cannot be opened, is empty or cannot be mapped.
+ */
+bool MappedFile::Open(const std::string &file_path) {
+  Close();
+
+#ifdef _WIN64
+  HANDLE file = CreateFileW(std::filesystem::path(file_path).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    GERROR_CH(Assets, "Cannot open {} - error {}", file_path, GetLastError());
+    return false;
+  }
+
+  LARGE_INTEGER file_size = {};
+  if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+    GERROR_CH(Assets, "Cannot map {} - it is empty", file_path);
+    CloseHandle(file);
+    return false;
+  }
+
+  HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  void *view = mapping != nullptr ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+  const DWORD error = GetLastError();
+  if (mapping != nullptr) { CloseHandle(mapping); }
+  CloseHandle(file);
+  if (view == nullptr) {
+    GERROR_CH(Assets, "Cannot map {} - error {}", file_path, error);
+    return false;
+  }
+
+  size_ = static_cast<size_t>(file_size.QuadPart);
+  // read it in ahead of the first touch, it is about to be read front to back
+  WIN32_MEMORY_RANGE_ENTRY range = {view, size_};
+  PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+  const int file = open(file_path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (file < 0) {
+    GERROR_CH(Assets, "Cannot open {} - {}", file_path, std::strerror(errno));
+    return false;
+  }
+
+  struct stat file_stat = {};
+  if (fstat(file, &file_stat) != 0 || file_stat.st_size == 0) {
+    GERROR_CH(Assets, "Cannot map {} - it is empty", file_path);
+    close(file);
+    return false;
+  }
+
+  void *view = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+  const int error = errno;
+  close(file);
+  if (view == MAP_FAILED) {
+    GERROR_CH(Assets, "Cannot map {} - {}", file_path, std::strerror(error));
+    return false;
+  }
+
+  size_ = static_cast<size_t>(file_stat.st_size);
+  // read it in ahead of the first touch, it is about to be read front to back
+  madvise(view, size_, MADV_WILLNEED);
+#endif
+
+  data_ = static_cast<const std::byte *>(view);
+  return true;
+}
+
+void MappedFile::Close() {
+  if (data_ == nullptr) { return; }
+#ifdef _WIN64
+  UnmapViewOfFile(data_);
+#else
+  munmap(const_cast<std::byte *>(data_), size_);
+#endif
+  data_ = nullptr;
+  size_ = 0;
+}
+
+}// namespace glaceon
@@ -0,0 +1,38 @@
+#ifndef GLACEON_GLACEON_CORE_MAPPEDFILE_H_
+#define GLACEON_GLACEON_CORE_MAPPEDFILE_H_
+
+#include <cstddef>
+#include <string>
+
+#include "Base.h"
+
+namespace glaceon {
+
+// A whole file mapped read-only into the address space (mmap on Linux, a file mapping view on Windows).  Pages are
+// shared with the OS file cache and read in as they are first touched, so nothing is parsed or copied on Open().
+class GLACEON_API MappedFile {
+ public:
+  MappedFile() = default;
+  ~MappedFile();
+
+  MappedFile(MappedFile &&other) noexcept;
+  MappedFile &operator=(MappedFile &&other) noexcept;
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  // maps file_path and asks the OS to start reading it in; false (and logged) if it is missing or empty
+  bool Open(const std::string &file_path);
+  void Close();
+
+  [[nodiscard]] bool IsOpen() const { return data_ != nullptr; }
+  [[nodiscard]] const std::byte *GetData() const { return data_; }
+  [[nodiscard]] size_t GetSize() const { return size_; }
+
+ private:
+  const std::byte *data_ = nullptr;
+  size_t size_ = 0;
+};
+
+}// namespace glaceon
+
+#endif// GLACEON_GLACEON_CORE_MAPPEDFILE_H_
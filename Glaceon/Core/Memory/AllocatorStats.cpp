@@ -0,0 +1,199 @@
+#include "AllocatorStats.h"
+
+#include <algorithm>
+#include <bit>
+#include <mutex>
+
+#include "../../Profiler/Profiler.h"
+#include "../Logger.h"
+
+namespace glaceon {
+
+// -------------------------- ALLOCATOR STATS --------------------------
+
+AllocatorStats::~AllocatorStats() { Unregister(); }
+
+AllocatorStats::AllocatorStats(AllocatorStats &&other) noexcept { TakeCounters(other); }
+
+AllocatorStats &AllocatorStats::operator=(AllocatorStats &&other) noexcept {
+  if (this != &other) {
+    Unregister();
+    TakeCounters(other);
+  }
+  return *this;
+}
+
+void AllocatorStats::Register(const std::string &name, size_t capacity) {
+  Unregister();
+  name_ = name;
+  trace_name_ = Profiler::InternName(name);
+  SetCapacity(capacity);
+  registered_ = true;
+  AllocatorRegistry::Register(this);
+}
+
+void AllocatorStats::Unregister() {
+  if (!registered_) { return; }
+  AllocatorRegistry::Unregister(this);
+  registered_ = false;
+}
+
+void AllocatorStats::RecordAllocation(size_t size, size_t used_memory) {
+  num_allocations_.fetch_add(1, std::memory_order_relaxed);
+  bytes_allocated_.fetch_add(size, std::memory_order_relaxed);
+  size_histogram_[GetSizeBucket(size)].fetch_add(1, std::memory_order_relaxed);
+  used_memory_.store(used_memory, std::memory_order_relaxed);
+
+  size_t peak = peak_used_memory_.load(std::memory_order_relaxed);
+  while (used_memory > peak && !peak_used_memory_.compare_exchange_weak(peak, used_memory, std::memory_order_relaxed)) {}
+
+  if (registered_) { Profiler::RecordAllocation(trace_name_, size, static_cast<int64_t>(used_memory)); }
+}
+
+void AllocatorStats::RecordRelease(size_t used_memory) {
+  num_deallocations_.fetch_add(1, std::memory_order_relaxed);
+  const size_t previous = used_memory_.exchange(used_memory, std::memory_order_relaxed);
+
+  if (registered_ && previous > used_memory) {
+    Profiler::RecordFree(trace_name_, previous - used_memory, static_cast<int64_t>(used_memory));
+  }
+}
+
+void AllocatorStats::RecordFailure() { num_failures_.fetch_add(1, std::memory_order_relaxed); }
+
+void AllocatorStats::EndFrame() {
+  const uint64_t allocations = num_allocations_.load(std::memory_order_relaxed);
+  const uint64_t bytes = bytes_allocated_.load(std::memory_order_relaxed);
+  frame_allocations_.store(allocations - frame_start_allocations_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  frame_bytes_.store(bytes - frame_start_bytes_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  frame_start_allocations_.store(allocations, std::memory_order_relaxed);
+  frame_start_bytes_.store(bytes, std::memory_order_relaxed);
+}
+
+uint32_t AllocatorStats::GetSizeBucket(size_t size) {
+  if (size < (size_t{1} << kMinBucketLog2)) { return 0; }
+  const uint32_t bucket = static_cast<uint32_t>(std::bit_width(size)) - kMinBucketLog2;
+  return std::min(bucket, kNumSizeBuckets - 1);
+}
+
+size_t AllocatorStats::GetSizeBucketMin(uint32_t bucket) { return bucket == 0 ? 0 : size_t{1} << (bucket + kMinBucketLog2 - 1); }
+
+void AllocatorStats::TakeCounters(AllocatorStats &other) {
+  auto take = [](auto &to, auto &from) { to.store(from.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed); };
+
+  take(capacity_, other.capacity_);
+  take(used_memory_, other.used_memory_);
+  take(peak_used_memory_, other.peak_used_memory_);
+  take(num_allocations_, other.num_allocations_);
+  take(num_deallocations_, other.num_deallocations_);
+  take(num_failures_, other.num_failures_);
+  take(bytes_allocated_, other.bytes_allocated_);
+  for (uint32_t i = 0; i < kNumSizeBuckets; i++) { take(size_histogram_[i], other.size_histogram_[i]); }
+  take(frame_start_allocations_, other.frame_start_allocations_);
+  take(frame_start_bytes_, other.frame_start_bytes_);
+  take(frame_allocations_, other.frame_allocations_);
+  take(frame_bytes_, other.frame_bytes_);
+
+  name_ = std::move(other.name_);
+  trace_name_ = other.trace_name_;
+  registered_ = other.registered_;
+  if (registered_) { AllocatorRegistry::Replace(&other, this); }
+  other.registered_ = false;
+}
+
+// -------------------------- ALLOCATOR REGISTRY --------------------------
+
+// Allocators may be static objects in any translation unit, so the registry is created on first use and never
+// destroyed to stay valid for their destructors.
+struct Registry {
+  std::mutex mutex;
+  std::vector<AllocatorStats *> allocators;
+};
+
+static Registry &GetRegistry() {
+  static auto *registry = new Registry();
+  return *registry;
+}
+
+static AllocatorStatsSnapshot MakeSnapshot(const AllocatorStats &stats) {
+  AllocatorStatsSnapshot snapshot = {
+      .name = stats.GetTraceName(),
+      .capacity = stats.GetCapacity(),
+      .used_memory = stats.GetUsedMemory(),
+      .peak_used_memory = stats.GetPeakUsedMemory(),
+      .num_allocations = stats.GetNumAllocations(),
+      .num_deallocations = stats.GetNumDeallocations(),
+      .num_failures = stats.GetNumFailures(),
+      .bytes_allocated = stats.GetBytesAllocated(),
+      .frame_allocations = stats.GetFrameAllocations(),
+      .frame_bytes = stats.GetFrameBytes(),
+      .size_histogram = {},
+  };
+  for (uint32_t i = 0; i < AllocatorStats::kNumSizeBuckets; i++) { snapshot.size_histogram[i] = stats.GetSizeBucketCount(i); }
+  return snapshot;
+}
+
+void AllocatorRegistry::Register(AllocatorStats *stats) {
+  Registry &registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.allocators.push_back(stats);
+}
+
+void AllocatorRegistry::Unregister(AllocatorStats *stats) {
+  Registry &registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  std::erase(registry.allocators, stats);
+}
+
+void AllocatorRegistry::Replace(AllocatorStats *old_stats, AllocatorStats *new_stats) {
+  Registry &registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  std::replace(registry.allocators.begin(), registry.allocators.end(), old_stats, new_stats);
+}
+
+void AllocatorRegistry::EndFrame() {
+  Registry &registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  for (AllocatorStats *stats : registry.allocators) { stats->EndFrame(); }
+}
+
+std::vector<AllocatorStatsSnapshot> AllocatorRegistry::GetSnapshots() {
+  Registry &registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+
+  std::vector<AllocatorStatsSnapshot> snapshots;
+  snapshots.reserve(registry.allocators.size());
+  for (const AllocatorStats *stats : registry.allocators) { snapshots.push_back(MakeSnapshot(*stats)); }
+  return snapshots;
+}
+
+size_t AllocatorRegistry::GetSnapshots(std::span<AllocatorStatsSnapshot> snapshots) {
+  Registry &registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+
+  const size_t count = std::min(snapshots.size(), registry.allocators.size());
+  for (size_t i = 0; i < count; i++) { snapshots[i] = MakeSnapshot(*registry.allocators[i]); }
+  return count;
+}
+
+bool AllocatorRegistry::GetSnapshot(const std::string &name, AllocatorStatsSnapshot &snapshot) {
+  Registry &registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+
+  for (const AllocatorStats *stats : registry.allocators) {
+    if (stats->GetName() == name) {
+      snapshot = MakeSnapshot(*stats);
+      return true;
+    }
+  }
+  return false;
+}
+
+void AllocatorRegistry::PrintStats() {
+  for (const AllocatorStatsSnapshot &snapshot : GetSnapshots()) {
+    GINFO_CH(Memory, "{}: {} / {} bytes used, peak {}, {} allocations ({} last frame), {} failed", snapshot.name, snapshot.used_memory,
+          snapshot.capacity, snapshot.peak_used_memory, snapshot.num_allocations, snapshot.frame_allocations, snapshot.num_failures);
+  }
+}
+
+}// namespace glaceon
@@ -0,0 +1,129 @@
+#ifndef GLACEON_GLACEON_CORE_ALLOCATORSTATS_H_
+#define GLACEON_GLACEON_CORE_ALLOCATORSTATS_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "../Base.h"
+
+namespace glaceon {
+
+// Counters an allocator keeps about itself.  They are updated with relaxed atomics so allocators used from several
+// threads (RingAllocator) share the same code path; a query may be slightly behind but never sees a torn value.
+//
+// Stats are always collected; an allocator only shows up in AllocatorRegistry queries and the memory panel once it
+// has been given a name with Register(); from then on its allocations and releases are also recorded by a running
+// Profiler session.
+class GLACEON_API AllocatorStats {
+ public:
+  // power of two size buckets: [0, 16), [16, 32), ... , [256 KiB, inf)
+  static constexpr uint32_t kMinBucketLog2 = 4;
+  static constexpr uint32_t kNumSizeBuckets = 16;
+
+  AllocatorStats() = default;
+  ~AllocatorStats();
+
+  // counters and registration move with the allocator
+  AllocatorStats(AllocatorStats &&other) noexcept;
+  AllocatorStats &operator=(AllocatorStats &&other) noexcept;
+  AllocatorStats(const AllocatorStats &) = delete;
+  AllocatorStats &operator=(const AllocatorStats &) = delete;
+
+  void Register(const std::string &name, size_t capacity);
+  void Unregister();
+  void SetCapacity(size_t capacity) { capacity_.store(capacity, std::memory_order_relaxed); }
+
+  void RecordAllocation(size_t size, size_t used_memory);
+  // a single deallocation or a bulk release (Clear, FreeToMarker, ...) that brought usage down to used_memory; either
+  // counts as one deallocation
+  void RecordRelease(size_t used_memory);
+  void RecordFailure();
+  // closes the current frame for the per-frame rates, called by AllocatorRegistry::EndFrame()
+  void EndFrame();
+
+  [[nodiscard]] const std::string &GetName() const { return name_; }
+  // the name as interned for the Profiler, stays valid after the allocator is gone
+  [[nodiscard]] const char *GetTraceName() const { return trace_name_; }
+  [[nodiscard]] bool IsRegistered() const { return registered_; }
+  [[nodiscard]] size_t GetCapacity() const { return capacity_.load(std::memory_order_relaxed); }
+  [[nodiscard]] size_t GetUsedMemory() const { return used_memory_.load(std::memory_order_relaxed); }
+  [[nodiscard]] size_t GetPeakUsedMemory() const { return peak_used_memory_.load(std::memory_order_relaxed); }
+  [[nodiscard]] uint64_t GetNumAllocations() const { return num_allocations_.load(std::memory_order_relaxed); }
+  [[nodiscard]] uint64_t GetNumDeallocations() const { return num_deallocations_.load(std::memory_order_relaxed); }
+  [[nodiscard]] uint64_t GetNumFailures() const { return num_failures_.load(std::memory_order_relaxed); }
+  [[nodiscard]] uint64_t GetBytesAllocated() const { return bytes_allocated_.load(std::memory_order_relaxed); }
+  [[nodiscard]] uint64_t GetFrameAllocations() const { return frame_allocations_.load(std::memory_order_relaxed); }
+  [[nodiscard]] uint64_t GetFrameBytes() const { return frame_bytes_.load(std::memory_order_relaxed); }
+  [[nodiscard]] uint64_t GetSizeBucketCount(uint32_t bucket) const { return size_histogram_[bucket].load(std::memory_order_relaxed); }
+
+  static uint32_t GetSizeBucket(size_t size);
+  // inclusive lower bound of a bucket in bytes
+  static size_t GetSizeBucketMin(uint32_t bucket);
+
+ private:
+  void TakeCounters(AllocatorStats &other);
+
+  std::string name_;
+  const char *trace_name_ = nullptr;// name_, interned for the Profiler
+  bool registered_ = false;
+
+  std::atomic<size_t> capacity_{0};
+  std::atomic<size_t> used_memory_{0};
+  std::atomic<size_t> peak_used_memory_{0};
+  std::atomic<uint64_t> num_allocations_{0};
+  std::atomic<uint64_t> num_deallocations_{0};
+  std::atomic<uint64_t> num_failures_{0};
+  std::atomic<uint64_t> bytes_allocated_{0};
+  std::atomic<uint64_t> size_histogram_[kNumSizeBuckets] = {};
+
+  // allocation count/bytes when the current frame started, and the totals of the last completed frame
+  std::atomic<uint64_t> frame_start_allocations_{0};
+  std::atomic<uint64_t> frame_start_bytes_{0};
+  std::atomic<uint64_t> frame_allocations_{0};
+  std::atomic<uint64_t> frame_bytes_{0};
+};
+
+// Copy of an allocator's stats taken by AllocatorRegistry, safe to keep around after the allocator is gone
+struct AllocatorStatsSnapshot {
+  const char *name;
+  size_t capacity;
+  size_t used_memory;
+  size_t peak_used_memory;
+  uint64_t num_allocations;
+  uint64_t num_deallocations;
+  uint64_t num_failures;
+  uint64_t bytes_allocated;
+  uint64_t frame_allocations;
+  uint64_t frame_bytes;
+  uint64_t size_histogram[AllocatorStats::kNumSizeBuckets];
+};
+
+// Process wide list of named allocators.  Allocators register through IAllocator::SetDebugName() (or the equivalent
+// on PoolAllocator/ObjectPool) and are removed again when destroyed.
+class GLACEON_API AllocatorRegistry {
+ public:
+  static void Register(AllocatorStats *stats);
+  static void Unregister(AllocatorStats *stats);
+  static void Replace(AllocatorStats *old_stats, AllocatorStats *new_stats);
+
+  // closes the frame for every registered allocator's per-frame allocation rate; call once per frame
+  static void EndFrame();
+
+  static std::vector<AllocatorStatsSnapshot> GetSnapshots();
+  // fills snapshots with up to snapshots.size() allocators without allocating, for the panels drawn every frame;
+  // returns how many were written
+  static size_t GetSnapshots(std::span<AllocatorStatsSnapshot> snapshots);
+  // false when no allocator with that name is registered
+  static bool GetSnapshot(const std::string &name, AllocatorStatsSnapshot &snapshot);
+
+  // logs every registered allocator
+  static void PrintStats();
+};
+
+}// namespace glaceon
+
+#endif//GLACEON_GLACEON_CORE_ALLOCATORSTATS_H_
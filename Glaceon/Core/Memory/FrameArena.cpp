@@ -0,0 +1,109 @@
+#include "FrameArena.h"
+
+#include <cstdlib>
+
+#include "../../Utils.h"
+#include "../Logger.h"
+
+namespace glaceon {
+
+FrameArena::~FrameArena() { Destroy(); }
+
+/**
+ * @brief Allocates one contiguous block and carves it into one LinearAllocator per frame in flight.
+ *
+ * Calling Initialize() again (e.g. after the swap chain was rebuilt with a different image count) releases the
+ * previous arenas first.
+ *
+ * @param frames_in_flight Number of frames that can be recorded/executing at the same time.
+ * @param bytes_per_frame Size of each frame's arena.
+ */
+void FrameArena::Initialize(uint32_t frames_in_flight, size_t bytes_per_frame) {
+  assert(frames_in_flight > 0 && bytes_per_frame > 0);
+  Destroy();
+
+  bytes_per_frame_ = bytes_per_frame;
+  memory_ = malloc(bytes_per_frame * frames_in_flight);
+  if (memory_ == nullptr) {
+    GERROR_CH(Memory, "FrameArena: failed to allocate {} bytes for {} frames", bytes_per_frame * frames_in_flight, frames_in_flight);
+    return;
+  }
+
+  arenas_.reserve(frames_in_flight);
+  for (uint32_t i = 0; i < frames_in_flight; i++) {
+    void *start = reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(memory_) + i * bytes_per_frame);
+    arenas_.push_back(std::make_unique<LinearAllocator>(bytes_per_frame, start));
+    arenas_.back()->SetDebugName("FrameArena[" + std::to_string(i) + "]");
+  }
+  heap_blocks_.assign(frames_in_flight, nullptr);
+  current_frame_ = 0;
+  peak_used_memory_ = 0;
+  frame_spills_ = 0;
+  total_spills_ = 0;
+}
+
+void FrameArena::Destroy() {
+  for (uint32_t i = 0; i < heap_blocks_.size(); i++) { ReleaseHeapBlocks(i); }
+  heap_blocks_.clear();
+  arenas_.clear();
+  free(memory_);
+  memory_ = nullptr;
+}
+
+/**
+ * @brief Recycles the arena of the given frame and makes it the target of subsequent allocations.
+ *
+ * @param frame_index Index of the frame about to be recorded; its in-flight fence must already have signaled.
+ */
+void FrameArena::BeginFrame(uint32_t frame_index) {
+  assert(frame_index < arenas_.size());
+
+  if (frame_spills_ > 0) {
+    GWARN_CH(Memory, "FrameArena: frame {} spilled {} allocations to the heap; increase the per-frame size (currently {} bytes)",
+          current_frame_, frame_spills_, bytes_per_frame_);
+  }
+
+  current_frame_ = frame_index;
+  frame_spills_ = 0;
+  arenas_[frame_index]->Clear();
+  ReleaseHeapBlocks(frame_index);
+}
+
+void *FrameArena::Allocate(size_t size, uint8_t alignment) {
+  assert(!arenas_.empty() && "FrameArena used before Initialize()");
+
+  LinearAllocator &arena = *arenas_[current_frame_];
+  if (void *ptr = arena.Allocate(size, alignment); ptr != nullptr) {
+    peak_used_memory_ = std::max(peak_used_memory_, arena.GetUsedMemory());
+    return ptr;
+  }
+
+  // arena exhausted, spill over to the heap; the block is still released with the frame
+  void *block = malloc(sizeof(HeapBlock) + size + alignment);
+  if (block == nullptr) { return nullptr; }
+  auto *header = static_cast<HeapBlock *>(block);
+  header->next = heap_blocks_[current_frame_];
+  heap_blocks_[current_frame_] = header;
+
+  frame_spills_++;
+  total_spills_++;
+
+  return AlignAddress(reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(block) + sizeof(HeapBlock)), alignment);
+}
+
+size_t FrameArena::GetUsedMemory() const {
+  if (arenas_.empty()) { return 0; }
+  return arenas_[current_frame_]->GetUsedMemory();
+}
+
+void FrameArena::ReleaseHeapBlocks(uint32_t frame_index) {
+  HeapBlock *block = heap_blocks_[frame_index];
+  while (block != nullptr) {
+    HeapBlock *next = block->next;
+    free(block);
+    block = next;
+  }
+  heap_blocks_[frame_index] = nullptr;
+}
+
+}// namespace glaceon
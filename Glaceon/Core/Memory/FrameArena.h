@@ -0,0 +1,110 @@
+#ifndef GLACEON_GLACEON_CORE_FRAMEARENA_H_
+#define GLACEON_GLACEON_CORE_FRAMEARENA_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "../Base.h"
+#include "LinearAllocator.h"
+
+namespace glaceon {
+
+template<typename T>
+class FrameAllocator;
+
+// Transient, frame-scoped memory.  One LinearAllocator is kept per frame in flight; an arena is cleared in one go by
+// BeginFrame() once the fence guarding that frame has signaled, so nothing allocated from it can still be in use.
+//
+// Allocations that do not fit in the arena spill over to the heap and are released on the next BeginFrame() of the
+// same frame.  Spills are counted so the arena can be sized to never spill in steady state; they say nothing about heap
+// use outside the arena; build with GLACEON_TRACK_GLOBAL_NEW to have FrameStats count every frame's heap allocations.
+class GLACEON_API FrameArena {
+ public:
+  FrameArena() = default;
+  ~FrameArena();
+
+  void Initialize(uint32_t frames_in_flight, size_t bytes_per_frame);
+  void Destroy();
+
+  // Must only be called once the in-flight fence for frame_index has been waited on
+  void BeginFrame(uint32_t frame_index);
+
+  void *Allocate(size_t size, uint8_t alignment);
+
+  template<typename T>
+  FrameAllocator<T> GetAllocator() {
+    return FrameAllocator<T>(this);
+  }
+
+  [[nodiscard]] uint32_t GetFramesInFlight() const { return static_cast<uint32_t>(arenas_.size()); }
+  [[nodiscard]] size_t GetBytesPerFrame() const { return bytes_per_frame_; }
+  [[nodiscard]] size_t GetUsedMemory() const;
+  [[nodiscard]] size_t GetPeakUsedMemory() const { return peak_used_memory_; }
+  // allocations of the current frame that spilled to the heap because its arena was exhausted
+  [[nodiscard]] uint64_t GetFrameSpills() const { return frame_spills_; }
+  // spills since Initialize(); stays constant once the arena is big enough
+  [[nodiscard]] uint64_t GetTotalSpills() const { return total_spills_; }
+
+  FrameArena(const FrameArena &) = delete;
+  FrameArena &operator=(const FrameArena &) = delete;
+
+ private:
+  // prepended to every block that spilled to the heap so it can be released with the frame
+  struct HeapBlock {
+    HeapBlock *next;
+  };
+
+  void ReleaseHeapBlocks(uint32_t frame_index);
+
+  void *memory_ = nullptr;
+  size_t bytes_per_frame_ = 0;
+  uint32_t current_frame_ = 0;
+
+  std::vector<std::unique_ptr<LinearAllocator>> arenas_;
+  std::vector<HeapBlock *> heap_blocks_;
+
+  size_t peak_used_memory_ = 0;
+  uint64_t frame_spills_ = 0;
+  uint64_t total_spills_ = 0;
+};
+
+// STL-compatible allocator that bump-allocates from the current frame of a FrameArena.
+// Deallocation is a no-op, memory is reclaimed when the frame is recycled; containers using it must not outlive the
+// frame they were created in.
+//
+// e.g.
+//  FrameVector<vk::ClearValue> clear_values(frame_arena.GetAllocator<vk::ClearValue>());
+template<typename T>
+class FrameAllocator {
+ public:
+  using value_type = T;
+
+  explicit FrameAllocator(FrameArena *arena) noexcept : arena_(arena) {}
+  template<typename U>
+  FrameAllocator(const FrameAllocator<U> &other) noexcept : arena_(other.GetArena()) {}
+
+  T *allocate(size_t n) {
+    void *ptr = arena_->Allocate(n * sizeof(T), static_cast<uint8_t>(alignof(T)));
+    if (ptr == nullptr) { throw std::bad_alloc(); }
+    return static_cast<T *>(ptr);
+  }
+  void deallocate(T *, size_t) noexcept {}
+
+  [[nodiscard]] FrameArena *GetArena() const noexcept { return arena_; }
+
+  template<typename U>
+  bool operator==(const FrameAllocator<U> &other) const noexcept {
+    return arena_ == other.GetArena();
+  }
+
+ private:
+  FrameArena *arena_;
+};
+
+template<typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
+
+}// namespace glaceon
+
+#endif//GLACEON_GLACEON_CORE_FRAMEARENA_H_
@@ -1,172 +1,271 @@
 #include "FreeListAllocator.h"
 
+#include <bit>
+
 #include "../../Utils.h"
 
 namespace glaceon {
 
+// index of the most significant set bit
+static size_t FindLastSet(uint64_t value) { return 63 - std::countl_zero(value); }
+// index of the least significant set bit
+static size_t FindFirstSet(uint64_t value) { return std::countr_zero(value); }
+
+static size_t AlignUp(size_t size, size_t alignment) { return (size + alignment - 1) & ~(alignment - 1); }
+
 // -------------------------- FREE-LIST ALLOCATOR --------------------------
-FreeListAllocator::FreeListAllocator(const size_t size, void *start) : size_(size) {
-  assert(size > 0);
+
+/**
+ * @brief Turns the given memory block into a single free block followed by a zero sized, permanently used sentinel.
+ *
+ * The sentinel stops coalescing from running off the end of the block, the null prev_physical of the first block
+ * does the same at the front.
+ *
+ * @param size Size of the memory block in bytes.
+ * @param start Start of the memory block, typically obtained from malloc.
+ */
+FreeListAllocator::FreeListAllocator(const size_t size, void *start) {
+  start_ = start;
+  size_ = size;
   used_memory_ = 0;
-  free_blocks_ = static_cast<FreeBlock *>(start);
-  free_blocks_->size = size;
-  free_blocks_->next = nullptr;
+  num_allocations_ = 0;
+
+  const uint8_t adjustment = AlignSize(start, kAlignment);
+  assert(size > adjustment + 2 * kHeaderSize + kMinPayloadSize);
+
+  auto *first = reinterpret_cast<BlockHeader *>(reinterpret_cast<uintptr_t>(start) + adjustment);
+  first->prev_physical = nullptr;
+  first->size = (size - adjustment - 2 * kHeaderSize) & ~(kAlignment - 1);
+  first->SetFree(true);
+
+  BlockHeader *sentinel = first->GetNextPhysical();
+  sentinel->prev_physical = first;
+  sentinel->size = 0;
+
+  InsertFreeBlock(first);
 }
 
-FreeListAllocator::~FreeListAllocator() { free_blocks_ = nullptr; }
+FreeListAllocator::~FreeListAllocator() {
+  fl_bitmap_ = 0;
+  start_ = nullptr;
+}
 
+/**
+ * @brief Allocates a block of memory in constant time.
+ *
+ * The request is rounded up to the next bin boundary so that any block found in the selected bin is guaranteed to be
+ * large enough (good-fit rather than best-fit); the excess is split off and returned to the free lists.
+ *
+ * @param size The size of the memory block to allocate.
+ * @param alignment The alignment of the memory block, must be a power of two.
+ * @return void* A pointer to the allocated memory block, or nullptr if no free block was big enough.
+ */
 void *FreeListAllocator::Allocate(const size_t size, const uint8_t alignment) {
   assert(size != 0 && alignment != 0);
 
-  /*
-   * The free list is a singly-linked list of free blocks,
-   * where each free block has a size and a pointer to the next free block.
-   *
-   * The free block structure is defined in the header, and consists of:
-   * - size_t size;                  // size of the free block
-   * - FreeBlock *next;              // pointer to the next free block
-   */
-
-  // Keep track of the previous free block in the list
-  FreeBlock *prev_free_block = nullptr;
-
-  // Start at the beginning of the free list
-  FreeBlock *free_block = free_blocks_;
-
-  /*
-   * Iterate through the free list, until we find a free block
-   * that is big enough to hold the requested allocation.
-   */
-  while (free_block != nullptr) {
-
-    // Calculate the adjustment needed for alignment
-    const uint8_t adjustment = AlignSize(free_block, alignment);
-
-    // Calculate the total size needed for the requested allocation
-    size_t total_size = size + adjustment;
-
-    // Check if the free block is big enough
-    if (free_block->size <= total_size) {
-      // The free block is not big enough, so continue to the next one
-      prev_free_block = free_block;
-      free_block = free_block->next;
-      continue;
-    }
+  const size_t adjusted_size = std::max(AlignUp(size, kAlignment), kMinPayloadSize);
 
-    // Now check if there is enough room for the AllocationHeader
-    if (free_block->size - total_size >= sizeof(AllocationHeader)) {
-      // There is enough room for the AllocationHeader
-
-      /*
-       * Use the free block as the allocated block by setting the requested
-       * allocation size to the size of the free block instead of creating
-       * a new FreeBlock.
-       */
-      total_size = free_block->size;
-
-      /*
-       * Remove the free block from the free list by updating the next
-       * pointer of the previous free block (or the free list if the current
-       * block is the first in the list).
-       */
-      if (prev_free_block != nullptr) {
-        prev_free_block->next = free_block->next;
-      } else {
-        // the current block is the first in the list
-        free_blocks_ = free_block->next;
-      }
-    } else {
-      // There is not enough room for the AllocationHeader, so create a new FreeBlock
-
-      /*
-       * Create a new FreeBlock after the current one, and point the next
-       * pointer of the current FreeBlock to the new FreeBlock.
-       */
-      auto *next_block = reinterpret_cast<FreeBlock *>(reinterpret_cast<uintptr_t>(free_block) + total_size);
-      next_block->size = free_block->size - total_size;
-      next_block->next = free_block->next;
-
-      /*
-       * Update the next pointer of the previous free block (or the free
-       * list if the current block is the first in the list).
-       */
-      if (prev_free_block != nullptr) {
-        prev_free_block->next = next_block;
-      } else {
-        free_blocks_ = next_block;
-      }
-    }
+  // Payloads are always kAlignment aligned.  For stricter alignments over-allocate so that the block can be trimmed at
+  // the front, the gap has to be large enough to hold a free block of its own.
+  const bool needs_trim = alignment > kAlignment;
+  const size_t search_size = needs_trim ? adjusted_size + alignment + kMinBlockSize : adjusted_size;
 
-    // Calculate the aligned address of the allocated block
-    const uintptr_t aligned_address = reinterpret_cast<uintptr_t>(free_block) + adjustment;
+  size_t fl, sl;
+  MappingSearch(search_size, fl, sl);
+  BlockHeader *block = FindSuitableBlock(fl, sl);
+  if (block == nullptr) {
+    stats_.RecordFailure();
+    return nullptr;
+  }
+  RemoveFreeBlock(block);
 
-    // Prepend the AllocationHeader to the allocated block
-    auto *header = reinterpret_cast<AllocationHeader *>(aligned_address - sizeof(AllocationHeader));
-    header->size = total_size;
-    header->adjustment = adjustment;
+  if (needs_trim) {
+    const auto payload = reinterpret_cast<uintptr_t>(block->GetPayload());
+    auto aligned = reinterpret_cast<uintptr_t>(AlignAddress(block->GetPayload(), alignment));
+    if (aligned != payload && aligned - payload < kMinBlockSize) {
+      aligned = reinterpret_cast<uintptr_t>(AlignAddress(reinterpret_cast<void *>(payload + kMinBlockSize), alignment));
+    }
 
-    // Update the used memory
-    used_memory_ += total_size;
+    if (const size_t gap = aligned - payload; gap != 0) {
+      // give the leading gap back as a free block of its own
+      auto *aligned_block = reinterpret_cast<BlockHeader *>(aligned - kHeaderSize);
+      aligned_block->prev_physical = block;
+      aligned_block->size = block->GetSize() - gap;
+      aligned_block->GetNextPhysical()->prev_physical = aligned_block;
 
-    // Return a pointer to the allocated block
-    return reinterpret_cast<void *>(aligned_address);
+      block->SetSize(gap - kHeaderSize);
+      InsertFreeBlock(block);
+      block = aligned_block;
+    }
   }
 
-  // No free block was big enough, so return nullptr
-  return nullptr;
+  if (BlockHeader *remainder = Split(block, adjusted_size); remainder != nullptr) { InsertFreeBlock(remainder); }
+  block->SetFree(false);
+
+  used_memory_ += block->GetSize();
+  num_allocations_++;
+  stats_.RecordAllocation(size, used_memory_);
+
+  return block->GetPayload();
 }
 
-// Deallocate function to release memory allocated by the FreeListAllocator
+/**
+ * @brief Returns a block to the allocator, coalescing it with free physical neighbours in constant time.
+ *
+ * @param ptr A pointer previously returned by Allocate, or nullptr.
+ */
 void FreeListAllocator::Deallocate(void *ptr) {
-  // Check if the pointer is nullptr, if so, return immediately
   if (ptr == nullptr) { return; }
 
-  // Get the AllocationHeader based on the provided pointer
-  const auto *header = reinterpret_cast<AllocationHeader *>(static_cast<uintptr_t *>(ptr) - sizeof(AllocationHeader));
+  BlockHeader *block = FromPayload(ptr);
+  assert(!block->IsFree() && "double free detected in FreeListAllocator");
+
+  used_memory_ -= block->GetSize();
+  num_allocations_--;
+  stats_.RecordRelease(used_memory_);
 
-  // Calculate the start and end addresses of the memory block
-  const uintptr_t block_start = reinterpret_cast<uintptr_t>(ptr) - header->adjustment;
-  const uintptr_t block_end = block_start + header->size;
+  block->SetFree(true);
+  block = MergeWithPrevious(block);
+  MergeWithNext(block);
+  InsertFreeBlock(block);
+}
 
-  // Initialize variables to track previous and current FreeBlocks
-  FreeBlock *prev_free_block = nullptr;
-  FreeBlock *free_block = free_blocks_;
+size_t FreeListAllocator::GetLargestFreeBlock() const {
+  if (fl_bitmap_ == 0) { return 0; }
 
-  // Iterate through FreeBlocks to find the appropriate location to deallocate
-  while (free_block != nullptr) {
-    // Break the loop if the current FreeBlock is beyond the block_end
-    if (reinterpret_cast<uintptr_t>(free_block) > block_end) { break; }
-    prev_free_block = free_block;
-    free_block = free_block->next;
+  // the largest block lives in the highest non-empty bin, but a bin covers a range of sizes so check all of it
+  const size_t fl = FindLastSet(fl_bitmap_);
+  const size_t sl = FindLastSet(sl_bitmap_[fl]);
+  size_t largest = 0;
+  for (const BlockHeader *block = free_blocks_[fl][sl]; block != nullptr; block = block->next_free) {
+    largest = std::max(largest, block->GetSize());
   }
+  return largest;
+}
+
+float FreeListAllocator::GetFragmentation() const {
+  if (free_memory_ == 0) { return 0.0f; }
+  return 1.0f - static_cast<float>(GetLargestFreeBlock()) / static_cast<float>(free_memory_);
+}
 
-  // Handle different scenarios for deallocation
-  if (prev_free_block == nullptr) {
-    // If there is no previous FreeBlock, create a new one at the block_start
-    prev_free_block = reinterpret_cast<FreeBlock *>(block_start);
-    prev_free_block->size = block_end - reinterpret_cast<uintptr_t>(prev_free_block);
-    prev_free_block->next = free_blocks_;
-    free_blocks_ = prev_free_block;
-  } else if (reinterpret_cast<uintptr_t>(prev_free_block) + prev_free_block->size == block_start) {
-    // If the previous FreeBlock is adjacent to the block_start, update the size
-    prev_free_block->size = header->size;
+/**
+ * @brief Maps a block size to the bin it is stored in.
+ *
+ * Sizes below kSmallBlockSize are split linearly into kSlIndexCount bins on the first level.  Above that, the first
+ * level index is the power of two and the second level index the next kSlIndexLog2 bits below it.
+ */
+void FreeListAllocator::MappingInsert(const size_t size, size_t &fl, size_t &sl) {
+  if (size < kSmallBlockSize) {
+    fl = 0;
+    sl = size / (kSmallBlockSize / kSlIndexCount);
   } else {
-    // Create a new FreeBlock and adjust pointers accordingly
-    auto *t = reinterpret_cast<FreeBlock *>(block_start);
-    t->size = header->size;
-    t->next = prev_free_block->next;
-    prev_free_block->next = t;
-    prev_free_block = t;
+    const size_t last_set = FindLastSet(size);
+    sl = (size >> (last_set - kSlIndexLog2)) ^ (1 << kSlIndexLog2);
+    fl = last_set - (kFlIndexShift - 1);
   }
+}
+
+/**
+ * @brief Maps a requested size to the first bin whose blocks are all guaranteed to fit it.
+ */
+void FreeListAllocator::MappingSearch(size_t size, size_t &fl, size_t &sl) {
+  if (size >= kSmallBlockSize) { size += (static_cast<size_t>(1) << (FindLastSet(size) - kSlIndexLog2)) - 1; }
+  MappingInsert(size, fl, sl);
+}
 
-  // Merge FreeBlocks if needed
-  if (free_block != nullptr && reinterpret_cast<uintptr_t>(free_block) == block_end) {
-    prev_free_block->size += free_block->size;
-    prev_free_block->next = free_block->next;
+FreeListAllocator::BlockHeader *FreeListAllocator::FromPayload(void *ptr) {
+  return reinterpret_cast<BlockHeader *>(reinterpret_cast<uintptr_t>(ptr) - kHeaderSize);
+}
+
+/**
+ * @brief Finds a non-empty bin at or above (fl, sl) using the bitmaps, updating fl/sl to the bin found.
+ */
+FreeListAllocator::BlockHeader *FreeListAllocator::FindSuitableBlock(size_t &fl, size_t &sl) const {
+  if (fl >= kFlIndexCount) { return nullptr; }
+
+  // look for a bin with equal or larger blocks on the same first level
+  uint32_t sl_map = sl_bitmap_[fl] & (~0U << sl);
+  if (sl_map == 0) {
+    // none, move on to the next non-empty first level
+    const uint64_t fl_map = fl_bitmap_ & (~0ULL << (fl + 1));
+    if (fl_map == 0) { return nullptr; }
+    fl = FindFirstSet(fl_map);
+    sl_map = sl_bitmap_[fl];
+  }
+  sl = FindFirstSet(sl_map);
+  return free_blocks_[fl][sl];
+}
+
+void FreeListAllocator::InsertFreeBlock(BlockHeader *block) {
+  size_t fl, sl;
+  MappingInsert(block->GetSize(), fl, sl);
+
+  BlockHeader *head = free_blocks_[fl][sl];
+  block->next_free = head;
+  block->prev_free = nullptr;
+  if (head != nullptr) { head->prev_free = block; }
+  free_blocks_[fl][sl] = block;
+
+  fl_bitmap_ |= 1ULL << fl;
+  sl_bitmap_[fl] |= 1U << sl;
+  free_memory_ += block->GetSize();
+}
+
+void FreeListAllocator::RemoveFreeBlock(BlockHeader *block) {
+  size_t fl, sl;
+  MappingInsert(block->GetSize(), fl, sl);
+
+  if (block->prev_free != nullptr) {
+    block->prev_free->next_free = block->next_free;
+  } else {
+    free_blocks_[fl][sl] = block->next_free;
   }
+  if (block->next_free != nullptr) { block->next_free->prev_free = block->prev_free; }
+
+  // clear the bitmap bits once the bin runs empty
+  if (free_blocks_[fl][sl] == nullptr) {
+    sl_bitmap_[fl] &= ~(1U << sl);
+    if (sl_bitmap_[fl] == 0) { fl_bitmap_ &= ~(1ULL << fl); }
+  }
+  free_memory_ -= block->GetSize();
+}
+
+/**
+ * @brief Shrinks the block to size, returning the trailing remainder as a new free block if it is big enough to be one.
+ *
+ * The block's physical successor is never free (free neighbours are always coalesced) so the remainder needs no
+ * merging.
+ */
+FreeListAllocator::BlockHeader *FreeListAllocator::Split(BlockHeader *block, const size_t size) {
+  if (block->GetSize() < size + kMinBlockSize) { return nullptr; }
+
+  auto *remainder = reinterpret_cast<BlockHeader *>(reinterpret_cast<uintptr_t>(block->GetPayload()) + size);
+  remainder->prev_physical = block;
+  remainder->size = block->GetSize() - size - kHeaderSize;
+  remainder->SetFree(true);
+  remainder->GetNextPhysical()->prev_physical = remainder;
+
+  block->SetSize(size);
+  return remainder;
+}
+
+FreeListAllocator::BlockHeader *FreeListAllocator::MergeWithPrevious(BlockHeader *block) {
+  BlockHeader *prev = block->prev_physical;
+  if (prev == nullptr || !prev->IsFree()) { return block; }
+
+  RemoveFreeBlock(prev);
+  prev->SetSize(prev->GetSize() + kHeaderSize + block->GetSize());
+  prev->GetNextPhysical()->prev_physical = prev;
+  return prev;
+}
+
+void FreeListAllocator::MergeWithNext(BlockHeader *block) {
+  BlockHeader *next = block->GetNextPhysical();
+  if (!next->IsFree()) { return; }
 
-  // Update the used memory and complete deallocation
-  used_memory_ -= header->size;
+  RemoveFreeBlock(next);
+  block->SetSize(block->GetSize() + kHeaderSize + next->GetSize());
+  block->GetNextPhysical()->prev_physical = block;
 }
 
-}// namespace glaceon
\ No newline at end of file
+}// namespace glaceon
@@ -1,11 +1,22 @@
 #ifndef GLACEON_GLACEON_CORE_FREELISTALLOCATOR_H_
 #define GLACEON_GLACEON_CORE_FREELISTALLOCATOR_H_
 
+#include <cstddef>
+#include <cstdint>
+
+#include "../Base.h"
 #include "Interface_Allocator.h"
 
 namespace glaceon {
 
-class FreeListAllocator : public IAllocator {
+// General purpose allocator using two-level segregated fit (TLSF).
+// http://www.gii.upv.es/tlsf/files/papers/ecrts04_tlsf.pdf
+//
+// Free blocks are binned by size into a first level (power of two) and a second level (linear subdivision of that
+// power of two).  Two bitmaps record which bins are non-empty so a fitting bin is found with a couple of bit scans,
+// making both Allocate and Deallocate O(1) regardless of how fragmented the heap is.  Every block carries a boundary
+// tag (its size plus a pointer to the physically previous block) so neighbours are coalesced immediately on free.
+class GLACEON_API FreeListAllocator : public IAllocator {
  public:
   FreeListAllocator(size_t size, void *start);
   ~FreeListAllocator() override;
@@ -13,22 +24,63 @@ class FreeListAllocator : public IAllocator {
   void *Allocate(size_t size, uint8_t alignment) override;
   void Deallocate(void *ptr) override;
 
+  [[nodiscard]] size_t GetFreeMemory() const { return free_memory_; }
+  [[nodiscard]] size_t GetLargestFreeBlock() const;
+  // 0 when all free memory is one contiguous block, approaching 1 as it is split into many small ones
+  [[nodiscard]] float GetFragmentation() const;
+
   FreeListAllocator(const FreeListAllocator &) = delete;
   FreeListAllocator &operator=(const FreeListAllocator &) = delete;
 
  private:
-  struct AllocationHeader {
-    size_t size;
-    uint8_t adjustment;// how many bytes to adjust to align the next allocation
-  };
-  struct FreeBlock {
-    size_t size;
-    FreeBlock *next;
+  static constexpr size_t kAlignLog2 = 4;
+  static constexpr size_t kAlignment = 1 << kAlignLog2;
+  static constexpr size_t kSlIndexLog2 = 4;
+  static constexpr size_t kSlIndexCount = 1 << kSlIndexLog2;
+  static constexpr size_t kFlIndexShift = kSlIndexLog2 + kAlignLog2;
+  static constexpr size_t kFlIndexMax = 40;// largest block is 1 TiB
+  static constexpr size_t kFlIndexCount = kFlIndexMax - kFlIndexShift + 1;
+  static constexpr size_t kSmallBlockSize = 1 << kFlIndexShift;
+
+  // Boundary tag in front of every block; next_free/prev_free overlay the payload and are only valid while free
+  struct BlockHeader {
+    BlockHeader *prev_physical;
+    size_t size;// payload size, low bit set when the block is free
+    BlockHeader *next_free;
+    BlockHeader *prev_free;
+
+    [[nodiscard]] size_t GetSize() const { return size & ~kFreeBit; }
+    [[nodiscard]] bool IsFree() const { return (size & kFreeBit) != 0; }
+    void SetSize(size_t new_size) { size = new_size | (size & kFreeBit); }
+    void SetFree(bool free) { size = free ? size | kFreeBit : size & ~kFreeBit; }
+    [[nodiscard]] void *GetPayload() { return reinterpret_cast<uint8_t *>(this) + kHeaderSize; }
+    [[nodiscard]] BlockHeader *GetNextPhysical() {
+      return reinterpret_cast<BlockHeader *>(reinterpret_cast<uint8_t *>(this) + kHeaderSize + GetSize());
+    }
   };
 
-  FreeBlock *free_blocks_;
-  size_t size_;
-  size_t used_memory_;
+  static constexpr size_t kFreeBit = 1;
+  // only prev_physical and size are live in a used block
+  static constexpr size_t kHeaderSize = offsetof(BlockHeader, next_free);
+  static constexpr size_t kMinPayloadSize = sizeof(BlockHeader) - kHeaderSize;
+  static constexpr size_t kMinBlockSize = sizeof(BlockHeader);
+
+  static void MappingInsert(size_t size, size_t &fl, size_t &sl);
+  static void MappingSearch(size_t size, size_t &fl, size_t &sl);
+  static BlockHeader *FromPayload(void *ptr);
+
+  BlockHeader *FindSuitableBlock(size_t &fl, size_t &sl) const;
+  void InsertFreeBlock(BlockHeader *block);
+  void RemoveFreeBlock(BlockHeader *block);
+  BlockHeader *Split(BlockHeader *block, size_t size);
+  BlockHeader *MergeWithPrevious(BlockHeader *block);
+  void MergeWithNext(BlockHeader *block);
+
+  uint64_t fl_bitmap_ = 0;
+  uint32_t sl_bitmap_[kFlIndexCount] = {};
+  BlockHeader *free_blocks_[kFlIndexCount][kSlIndexCount] = {};
+
+  size_t free_memory_ = 0;
 };
 
 }// namespace glaceon
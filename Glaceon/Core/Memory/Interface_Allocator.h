@@ -1,6 +1,8 @@
 #ifndef GLACEON_GLACEON_CORE_INTERFACE_ALLOCATOR_H_
 #define GLACEON_GLACEON_CORE_INTERFACE_ALLOCATOR_H_
 
+#include "AllocatorStats.h"
+
 namespace glaceon {
 
 class IAllocator {
@@ -8,17 +10,24 @@ class IAllocator {
   virtual ~IAllocator() = 0;
   virtual void *Allocate(size_t size, uint8_t alignment) = 0;
   virtual void Deallocate(void *ptr) = 0;
+  // false for allocators that only release memory in bulk (e.g. LinearAllocator::Clear)
+  virtual bool SupportsDeallocate() const { return true; }
 
   void *GetStart() const { return start_; }
   size_t GetSize() const { return size_; }
   size_t GetUsedMemory() const { return used_memory_; }
   size_t GetNumAllocations() const { return num_allocations_; }
 
+  // lists the allocator in AllocatorRegistry (and the memory panel) under name
+  void SetDebugName(const std::string &name) { stats_.Register(name, size_); }
+  const AllocatorStats &GetStats() const { return stats_; }
+
  protected:
   void *start_;
   size_t size_;
   size_t used_memory_;
   size_t num_allocations_;
+  AllocatorStats stats_;
 };
 
 inline IAllocator::~IAllocator() {}
@@ -35,11 +35,15 @@ void *LinearAllocator::Allocate(size_t size, uint8_t alignment) {
   if (size == 0) return nullptr;
 
   uint8_t adjustment = AlignSize(current_pos_, alignment);
-  if (used_memory_ + size + adjustment > size_) return nullptr;// no more memory available with given size and alignment
+  if (used_memory_ + size + adjustment > size_) {
+    stats_.RecordFailure();
+    return nullptr;// no more memory available with given size and alignment
+  }
 
   uintptr_t aligned_address = reinterpret_cast<uintptr_t>(current_pos_) + adjustment;
   used_memory_ += size + adjustment;
   current_pos_ = reinterpret_cast<uintptr_t *>(aligned_address + size);// Move current_pos_ by the allocated size
+  stats_.RecordAllocation(size, used_memory_);
 
   return reinterpret_cast<void *>(aligned_address);
 }
@@ -54,6 +58,7 @@ void LinearAllocator::Deallocate(void *ptr) { assert(false && "Deallocate not im
 void LinearAllocator::Clear() {
   current_pos_ = start_;
   used_memory_ = 0;
+  stats_.RecordRelease(0);
 }
 
 }// namespace glaceon
\ No newline at end of file
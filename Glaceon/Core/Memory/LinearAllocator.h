@@ -5,13 +5,14 @@
 #include "Interface_Allocator.h"
 
 namespace glaceon {
-class LinearAllocator : public IAllocator {
+class GLACEON_API LinearAllocator : public IAllocator {
  public:
   LinearAllocator(size_t size, void *start);
   ~LinearAllocator() override;
 
   void *Allocate(size_t size, uint8_t alignment) override;
   void Deallocate(void *ptr) override;
+  bool SupportsDeallocate() const override { return false; }
   void Clear();
 
   // Deleting the copy constructor to prevent copying of LinearAllocator objects
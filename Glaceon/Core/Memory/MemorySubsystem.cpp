@@ -1,10 +1,14 @@
 #include "MemorySubsystem.h"
 
+#include <atomic>
+#include <bit>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <memory>
+#include <mutex>
 
+#include "../../Profiler/Profiler.h"
 #include "../../Utils.h"
 #include "../Logger.h"
 #include "LinearAllocator.h"
@@ -12,46 +16,159 @@
 
 namespace glaceon {
 
-struct memory_stats {
-  uint64_t total_allocated;
-  uint64_t tagged_allocations[MEMORY_TAG_MAX_TAGS];
+static std::string tag_names[MEMORY_TAG_MAX_TAGS] = {"Unknown", "Array", "DynArray", "Dict", "String", "Texture"};
+
+static StackAllocator stack_alloc_ = StackAllocator(1024 * 1024, malloc(1024 * 1024));
+static const bool stack_alloc_registered_ = (stack_alloc_.SetDebugName("MemorySubsystem Stack"), true);
+
+// -------------------------- THREAD CACHE --------------------------
+
+// size classes are powers of two from 16 bytes to 1 KiB
+static constexpr uint32_t kMinSizeClassLog2 = 4;
+static constexpr uint32_t kNumSizeClasses = 7;
+static constexpr uint64_t kMaxCachedSize = 1ULL << (kMinSizeClassLog2 + kNumSizeClasses - 1);
+static constexpr uint32_t kMagazineCapacity = 64;
+static constexpr uint32_t kDepotCapacity = 16;// full magazines kept per size class
+
+static uint32_t SizeClassIndex(uint64_t size) {
+  if (size <= (1ULL << kMinSizeClassLog2)) { return 0; }
+  return std::bit_width(size - 1) - kMinSizeClassLog2;
+}
+
+static uint64_t SizeClassSize(uint32_t index) { return 1ULL << (kMinSizeClassLog2 + index); }
+
+struct Magazine {
+  uint32_t count = 0;
+  void *blocks[kMagazineCapacity];
 };
 
-static std::string tag_names[MEMORY_TAG_MAX_TAGS] = {"Unknown", "Array", "DynArray", "Dict", "String", "Texture"};
+// Shared between threads; only touched when a thread's magazine runs empty or full
+struct Depot {
+  std::mutex mutex;
+  Magazine magazines[kDepotCapacity];
+  uint32_t count = 0;
+
+  ~Depot() {
+    for (uint32_t i = 0; i < count; i++) {
+      for (uint32_t j = 0; j < magazines[i].count; j++) { free(magazines[i].blocks[j]); }
+    }
+  }
+};
 
-static memory_stats stats_ = {0, {0, 0, 0, 0, 0, 0}};
+static Depot depots_[kNumSizeClasses];
 
-static StackAllocator stack_alloc_ = StackAllocator(1024 * 1024, malloc(1024 * 1024));
+// Per-thread counters, written only by the owning thread and summed by GetStats().  Nodes are never freed; when a
+// thread exits its node is handed to the next new thread, which keeps accumulating into it, so no counts are lost.
+struct ThreadStats {
+  std::atomic<uint64_t> total_allocated{0};
+  std::atomic<uint64_t> tagged_allocations[MEMORY_TAG_MAX_TAGS] = {};
+  std::atomic<bool> in_use{true};
+  ThreadStats *next = nullptr;
+};
+
+static std::atomic<ThreadStats *> thread_stats_head_{nullptr};
+
+static ThreadStats *AcquireThreadStats() {
+  for (ThreadStats *stats = thread_stats_head_.load(std::memory_order_acquire); stats != nullptr; stats = stats->next) {
+    bool expected = false;
+    if (stats->in_use.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) { return stats; }
+  }
+
+  auto *stats = new ThreadStats();
+  stats->next = thread_stats_head_.load(std::memory_order_relaxed);
+  while (!thread_stats_head_.compare_exchange_weak(stats->next, stats, std::memory_order_release, std::memory_order_relaxed)) {}
+  return stats;
+}
 
-MemorySubsystem::MemorySubsystem() {
-  // zero out memory stats
-  GSetMemory(&stats_, 0, sizeof(stats_));
+// single writer, so a relaxed load/store pair is enough and avoids a locked instruction
+static void AddCounter(std::atomic<uint64_t> &counter, uint64_t value) {
+  counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
 }
 
+static void SubtractCounter(std::atomic<uint64_t> &counter, uint64_t value) {
+  counter.store(counter.load(std::memory_order_relaxed) - value, std::memory_order_relaxed);
+}
+
+struct ThreadCache {
+  Magazine magazines[kNumSizeClasses];
+  ThreadStats *stats = AcquireThreadStats();
+
+  ~ThreadCache() {
+    for (uint32_t i = 0; i < kNumSizeClasses; i++) {
+      for (uint32_t j = 0; j < magazines[i].count; j++) { free(magazines[i].blocks[j]); }
+    }
+    stats->in_use.store(false, std::memory_order_release);
+  }
+
+  void *Pop(uint32_t size_class) {
+    Magazine &magazine = magazines[size_class];
+    if (magazine.count == 0) {
+      Depot &depot = depots_[size_class];
+      std::lock_guard<std::mutex> lock(depot.mutex);
+      if (depot.count == 0) { return malloc(SizeClassSize(size_class)); }
+      magazine = depot.magazines[--depot.count];
+    }
+    return magazine.blocks[--magazine.count];
+  }
+
+  void Push(uint32_t size_class, void *block) {
+    Magazine &magazine = magazines[size_class];
+    if (magazine.count == kMagazineCapacity) {
+      Depot &depot = depots_[size_class];
+      std::lock_guard<std::mutex> lock(depot.mutex);
+      if (depot.count < kDepotCapacity) {
+        depot.magazines[depot.count++] = magazine;
+      } else {
+        // depot is full as well, give the memory back to the system
+        for (uint32_t i = 0; i < magazine.count; i++) { free(magazine.blocks[i]); }
+      }
+      magazine.count = 0;
+    }
+    magazine.blocks[magazine.count++] = block;
+  }
+};
+
+static thread_local ThreadCache thread_cache_;
+
+// -------------------------- MEMORY SUBSYSTEM --------------------------
+
+MemorySubsystem::MemorySubsystem() = default;
+
 MemorySubsystem::~MemorySubsystem() = default;
 
-void *MemorySubsystem::GAllocate(uint64_t size, MemoryTag tag) {
-  if (tag == MEMORY_TAG_UNKNOWN) { GWARN("GAllocate called with MEMORY_TAG_UNKNOWN.  Specifying a tag is recommended."); }
+void *MemorySubsystem::GAllocate(uint64_t size, MemoryTag tag, bool zero_memory, const std::source_location &location) {
+  if (tag == MEMORY_TAG_UNKNOWN) { GWARN_CH(Memory, "GAllocate called with MEMORY_TAG_UNKNOWN.  Specifying a tag is recommended."); }
+
+  ThreadCache &cache = thread_cache_;
 
   // update stats
-  stats_.total_allocated += size;
-  GTRACE("Total allocated: {}", stats_.total_allocated);
-  stats_.tagged_allocations[tag] += size;
-  GTRACE("Tagged allocations: {}", tag_names[tag]);
+  AddCounter(cache.stats->total_allocated, size);
+  AddCounter(cache.stats->tagged_allocations[tag], size);
+  Profiler::RecordAllocation(tag_names[tag].c_str(), size, -1, location.function_name());
 
   // TODO: allow for alignment bool?
-  return GZeroMemory(malloc(size), size);
+  void *mem_block = size <= kMaxCachedSize ? cache.Pop(SizeClassIndex(size)) : malloc(size);
+  if (zero_memory && mem_block != nullptr) { GZeroMemory(mem_block, size); }
+  return mem_block;
 }
 
-void MemorySubsystem::GFree(void *mem_block, uint64_t size, MemoryTag tag) {
-  if (tag == MEMORY_TAG_UNKNOWN) { GWARN("GFree called with MEMORY_TAG_UNKNOWN.  Specifying a tag is recommended."); }
+void MemorySubsystem::GFree(void *mem_block, uint64_t size, MemoryTag tag, const std::source_location &location) {
+  if (tag == MEMORY_TAG_UNKNOWN) { GWARN_CH(Memory, "GFree called with MEMORY_TAG_UNKNOWN.  Specifying a tag is recommended."); }
+  if (mem_block == nullptr) { return; }
 
-  // update stats
-  stats_.total_allocated -= size;
-  stats_.tagged_allocations[tag] -= size;
+  ThreadCache &cache = thread_cache_;
+
+  // update stats; blocks freed on another thread than they were allocated on wrap around, which cancels out on merge
+  SubtractCounter(cache.stats->total_allocated, size);
+  SubtractCounter(cache.stats->tagged_allocations[tag], size);
+  Profiler::RecordFree(tag_names[tag].c_str(), size, -1, location.function_name());
 
   // TODO: allow for alignment bool?
-  free(mem_block);
+  if (size <= kMaxCachedSize) {
+    cache.Push(SizeClassIndex(size), mem_block);
+  } else {
+    free(mem_block);
+  }
 }
 
 void *MemorySubsystem::GZeroMemory(void *mem_block, uint64_t size) { return memset(mem_block, 0, size); }
@@ -60,9 +177,25 @@ void *MemorySubsystem::GCopyMemory(void *dest, const void *src, uint64_t size) {
 
 void *MemorySubsystem::GSetMemory(void *dest, int value, uint64_t size) { return memset(dest, value, size); }
 
+MemoryStats MemorySubsystem::GetStats() {
+  MemoryStats stats = {};
+  for (ThreadStats *thread_stats = thread_stats_head_.load(std::memory_order_acquire); thread_stats != nullptr;
+       thread_stats = thread_stats->next) {
+    stats.total_allocated += thread_stats->total_allocated.load(std::memory_order_relaxed);
+    for (uint32_t i = 0; i < MEMORY_TAG_MAX_TAGS; i++) {
+      stats.tagged_allocations[i] += thread_stats->tagged_allocations[i].load(std::memory_order_relaxed);
+    }
+  }
+  return stats;
+}
+
+const char *MemorySubsystem::GetTagName(MemoryTag tag) { return tag_names[tag].c_str(); }
+
 // TODO: convert this to return a string
 void MemorySubsystem::PrintStats() {
-  GTRACE("System memory in use:");
+  GTRACE_CH(Memory, "System memory in use:");
+
+  const MemoryStats stats = GetStats();
 
   // print out memory stats for each memory tag type
   const uint64_t kKib = 1024;
@@ -70,27 +203,29 @@ void MemorySubsystem::PrintStats() {
   const uint64_t kGib = kMib * 1024;
 
   for (uint32_t i = 0; i < MEMORY_TAG_MAX_TAGS; i++) {
-    if (stats_.tagged_allocations[i] >= kGib) {
-      GTRACE("{}: {:03.2f} {}", tag_names[i], stats_.tagged_allocations[i] / static_cast<float>(kGib), "GiB");
-    } else if (stats_.tagged_allocations[i] >= kMib) {
-      GTRACE("{}: {:03.2f} {}", tag_names[i], stats_.tagged_allocations[i] / static_cast<float>(kMib), "MiB");
-    } else if (stats_.tagged_allocations[i] >= kKib) {
-      GTRACE("{}: {:03.2f} {}", tag_names[i], stats_.tagged_allocations[i] / static_cast<float>(kKib), "KiB");
+    if (stats.tagged_allocations[i] >= kGib) {
+      GTRACE_CH(Memory, "{}: {:03.2f} {}", tag_names[i], stats.tagged_allocations[i] / static_cast<float>(kGib), "GiB");
+    } else if (stats.tagged_allocations[i] >= kMib) {
+      GTRACE_CH(Memory, "{}: {:03.2f} {}", tag_names[i], stats.tagged_allocations[i] / static_cast<float>(kMib), "MiB");
+    } else if (stats.tagged_allocations[i] >= kKib) {
+      GTRACE_CH(Memory, "{}: {:03.2f} {}", tag_names[i], stats.tagged_allocations[i] / static_cast<float>(kKib), "KiB");
     } else {
-      GTRACE("{}: {:03.2f} {}", tag_names[i], static_cast<float>(stats_.tagged_allocations[i]), "B");
+      GTRACE_CH(Memory, "{}: {:03.2f} {}", tag_names[i], static_cast<float>(stats.tagged_allocations[i]), "B");
     }
   }
 }
 
-void *MemorySubsystem::GAllocate(uint64_t num, uint64_t size_of_obj, size_t align, MemoryTag tag) {
+void *MemorySubsystem::GAllocate(uint64_t num, uint64_t size_of_obj, size_t align, MemoryTag tag, const std::source_location &location) {
   if (num == 0 || size_of_obj == 0) { return nullptr; }
-  if (tag == MEMORY_TAG_UNKNOWN) { GWARN("GAllocate called with MEMORY_TAG. ) Specifying a tag is recommended."); }
+  if (tag == MEMORY_TAG_UNKNOWN) { GWARN_CH(Memory, "GAllocate called with MEMORY_TAG. ) Specifying a tag is recommended."); }
 
   switch (tag) {
     case MEMORY_TAG_ARRAY:
+      // recorded by the stack allocator's own stats
       return stack_alloc_.Allocate(num * size_of_obj, align);
     default:
-      GWARN("GAllocate called with unknown memory tag.  Specifying a tag is recommended.");
+      GWARN_CH(Memory, "GAllocate called with unknown memory tag.  Specifying a tag is recommended.");
+      Profiler::RecordAllocation(tag_names[tag].c_str(), num * size_of_obj, -1, location.function_name());
       // do not need to zero as calloc will do that inherently
       return calloc(num, size_of_obj);
   }
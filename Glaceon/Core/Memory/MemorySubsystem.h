@@ -1,6 +1,8 @@
 #ifndef GLACEON_GLACEON_CORE_MEMORYSUBSYSTEM_H_
 #define GLACEON_GLACEON_CORE_MEMORYSUBSYSTEM_H_
 
+#include <source_location>
+
 #include "../Base.h"
 #include "StackAllocator.h"
 
@@ -18,21 +20,36 @@ enum MemoryTag {
   MEMORY_TAG_MAX_TAGS
 };
 
-class MemorySubsystem {
+struct MemoryStats {
+  uint64_t total_allocated;
+  uint64_t tagged_allocations[MEMORY_TAG_MAX_TAGS];
+};
+
+// Small blocks (up to 1 KiB) are served from per-thread magazines of size classes that are refilled from, and spilled
+// to, a shared depot, so the common path takes no lock and never reaches malloc once warm.
+//
+// Stats are kept per thread and only ever written by their owning thread; GetStats() merges them on read.  While a
+// Profiler session runs every GAllocate/GFree is also recorded there, with the tag as allocator and the caller.
+class GLACEON_API MemorySubsystem {
  public:
   MemorySubsystem();
   ~MemorySubsystem();
 
-  // uses malloc
-  static void *GAllocate(uint64_t size, MemoryTag tag);
+  // uses the thread cache for small sizes, malloc otherwise; memory is only zeroed when asked for
+  static void *GAllocate(uint64_t size, MemoryTag tag, bool zero_memory = false,
+                         const std::source_location &location = std::source_location::current());
   // uses calloc
-  static void *GAllocate(uint64_t num, uint64_t size_of_obj, size_t align, MemoryTag tag);
-  static void GFree(void *mem_block, uint64_t size, MemoryTag tag);
+  static void *GAllocate(uint64_t num, uint64_t size_of_obj, size_t align, MemoryTag tag,
+                         const std::source_location &location = std::source_location::current());
+  // size and tag must match the GAllocate call that returned mem_block
+  static void GFree(void *mem_block, uint64_t size, MemoryTag tag, const std::source_location &location = std::source_location::current());
   static void *GZeroMemory(void *mem_block, uint64_t size);
   static void *GCopyMemory(void *dest, const void *src, uint64_t size);
   static void *GSetMemory(void *dest, int value, uint64_t size);
 
+  static MemoryStats GetStats();
   static void PrintStats();
+  static const char *GetTagName(MemoryTag tag);
 };
 
 }// namespace glaceon
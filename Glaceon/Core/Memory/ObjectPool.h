@@ -0,0 +1,170 @@
+#ifndef GLACEON_GLACEON_CORE_OBJECTPOOL_H_
+#define GLACEON_GLACEON_CORE_OBJECTPOOL_H_
+
+#include <cassert>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../Base.h"
+#include "PoolAllocator.h"
+
+namespace glaceon {
+
+// 32-bit generational reference into an ObjectPool<T>: the low 20 bits index the pool's slot table, the high 12 bits
+// hold the generation the slot had when the object was created.  Destroying an object bumps its slot's generation, so
+// handles to it no longer resolve, even after the slot is reused.
+template<typename T>
+struct Handle {
+  static constexpr uint32_t kIndexBits = 20;
+  static constexpr uint32_t kGenerationBits = 32 - kIndexBits;
+  static constexpr uint32_t kIndexMask = (1u << kIndexBits) - 1;
+  static constexpr uint32_t kGenerationMask = (1u << kGenerationBits) - 1;
+
+  uint32_t value = 0;// generations start at 1, so 0 is never a live handle
+
+  Handle() = default;
+  Handle(uint32_t index, uint32_t generation) : value((generation << kIndexBits) | index) {}
+
+  [[nodiscard]] uint32_t GetIndex() const { return value & kIndexMask; }
+  [[nodiscard]] uint32_t GetGeneration() const { return value >> kIndexBits; }
+  [[nodiscard]] bool IsNull() const { return value == 0; }
+
+  bool operator==(const Handle &other) const { return value == other.value; }
+  bool operator!=(const Handle &other) const { return value != other.value; }
+};
+
+// Owns objects of type T, constructed in place in the blocks of a growable PoolAllocator and referred to by Handle<T>.
+// Because callers never hold on to raw pointers, Compact() is free to move live objects into one contiguous chunk.
+//
+// e.g.
+//  ObjectPool<VulkanTexture> textures;
+//  Handle<VulkanTexture> texture = textures.Create(context, set, filename, input);
+//  textures.Get(texture)->Use(command_buffer);
+//  textures.Destroy(texture);
+template<typename T>
+class ObjectPool {
+ public:
+  explicit ObjectPool(size_t objects_per_chunk = 64)
+      : objects_per_chunk_(objects_per_chunk),
+        allocator_(sizeof(T), static_cast<uint8_t>(alignof(T)), objects_per_chunk) {}
+  ~ObjectPool() { Clear(); }
+
+  template<typename... Args>
+  Handle<T> Create(Args &&...args) {
+    uint32_t index;
+    if (free_slot_ != kNoSlot) {
+      index = free_slot_;
+      free_slot_ = slots_[index].next_free;
+    } else {
+      assert(slots_.size() <= Handle<T>::kIndexMask && "ObjectPool: out of handle indices");
+      index = static_cast<uint32_t>(slots_.size());
+      slots_.push_back(Slot{});
+    }
+
+    void *memory = allocator_.Allocate(sizeof(T), static_cast<uint8_t>(alignof(T)));
+    if (memory == nullptr) {
+      ReleaseSlot(index);
+      throw std::bad_alloc();
+    }
+
+    Slot &slot = slots_[index];
+    try {
+      slot.object = new (memory) T(std::forward<Args>(args)...);
+    } catch (...) {
+      allocator_.Deallocate(memory);
+      ReleaseSlot(index);
+      throw;
+    }
+    live_count_++;
+    return Handle<T>(index, slot.generation);
+  }
+
+  void Destroy(Handle<T> handle) {
+    T *object = Get(handle);
+    if (object == nullptr) { return; }
+
+    object->~T();
+    allocator_.Deallocate(object);
+    const uint32_t index = handle.GetIndex();
+    slots_[index].object = nullptr;
+    ReleaseSlot(index);
+    live_count_--;
+  }
+
+  // nullptr when the handle is null or stale
+  [[nodiscard]] T *Get(Handle<T> handle) const {
+    const uint32_t index = handle.GetIndex();
+    if (handle.IsNull() || index >= slots_.size()) { return nullptr; }
+    const Slot &slot = slots_[index];
+    return slot.generation == handle.GetGeneration() ? slot.object : nullptr;
+  }
+
+  [[nodiscard]] bool IsValid(Handle<T> handle) const { return Get(handle) != nullptr; }
+  [[nodiscard]] size_t Size() const { return live_count_; }
+  [[nodiscard]] const PoolAllocator &GetAllocator() const { return allocator_; }
+  void SetDebugName(const std::string &name) { allocator_.SetDebugName(name); }
+
+  template<typename Func>
+  void ForEach(Func &&func) {
+    for (uint32_t i = 0; i < slots_.size(); i++) {
+      if (slots_[i].object != nullptr) { func(Handle<T>(i, slots_[i].generation), *slots_[i].object); }
+    }
+  }
+
+  void Clear() {
+    for (uint32_t i = 0; i < slots_.size(); i++) {
+      if (slots_[i].object != nullptr) { Destroy(Handle<T>(i, slots_[i].generation)); }
+    }
+  }
+
+  // Moves every live object into a single chunk sized for them and releases all other chunks.  Handles stay valid,
+  // pointers previously returned by Get() do not.
+  void Compact() {
+    PoolAllocator compacted(sizeof(T), static_cast<uint8_t>(alignof(T)), objects_per_chunk_);
+    compacted.Reserve(live_count_);
+
+    for (Slot &slot : slots_) {
+      if (slot.object == nullptr) { continue; }
+      void *memory = compacted.Allocate(sizeof(T), static_cast<uint8_t>(alignof(T)));
+      T *moved = new (memory) T(std::move(*slot.object));
+      slot.object->~T();
+      slot.object = moved;
+    }
+    compacted.TakeStats(allocator_);
+    allocator_ = std::move(compacted);
+  }
+
+  ObjectPool(const ObjectPool &) = delete;
+  ObjectPool &operator=(const ObjectPool &) = delete;
+
+ private:
+  static constexpr uint32_t kNoSlot = UINT32_MAX;
+
+  struct Slot {
+    T *object = nullptr;
+    uint32_t generation = 1;
+    uint32_t next_free = kNoSlot;
+  };
+
+  // bumps the generation so outstanding handles go stale and puts the slot back on the free list
+  void ReleaseSlot(uint32_t index) {
+    Slot &slot = slots_[index];
+    slot.generation = (slot.generation + 1) & Handle<T>::kGenerationMask;
+    if (slot.generation == 0) { slot.generation = 1; }
+    slot.next_free = free_slot_;
+    free_slot_ = index;
+  }
+
+  size_t objects_per_chunk_;
+  PoolAllocator allocator_;
+  std::vector<Slot> slots_;
+  uint32_t free_slot_ = kNoSlot;
+  size_t live_count_ = 0;
+};
+
+}// namespace glaceon
+
+#endif//GLACEON_GLACEON_CORE_OBJECTPOOL_H_
@@ -1,9 +1,18 @@
 #include "PoolAllocator.h"
 
+#include <cstdlib>
+#include <utility>
+
 #include "../../Utils.h"
 
 namespace glaceon {
 
+// every block must be able to hold the free list link and keep its successor aligned
+static size_t PoolBlockSize(size_t obj_size, uint8_t alignment) {
+  size_t block_size = obj_size < sizeof(void *) ? sizeof(void *) : obj_size;
+  return (block_size + alignment - 1) & ~static_cast<size_t>(alignment - 1);
+}
+
 /**
  * @brief Constructor for PoolAllocator.
  *
@@ -14,55 +23,150 @@ namespace glaceon {
  */
 PoolAllocator::PoolAllocator(size_t obj_size, uint8_t alignment, size_t size, void *start)
     : object_alignment_(alignment),
-      object_size_(obj_size),
+      object_size_(PoolBlockSize(obj_size, alignment)),
       size_(size) {
   // Calculate adjustment for alignment
   uint8_t adjustment = AlignSize(start, alignment);
 
-  // Set the free list pointer
-  free_list_ = reinterpret_cast<void **>(reinterpret_cast<uintptr_t>(start) + adjustment);
-
   // Calculate the number of objects that can fit in the pool
-  size_t num_objects = (size - adjustment) / obj_size;
+  size_t num_objects = (size - adjustment) / object_size_;
 
   // Initialize the free list
-  void **p = free_list_;
-  for (size_t i = 0; i < num_objects - 1; i++) {
-    *p = reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(start) + adjustment + i * obj_size);
-    p++;
-  }
+  LinkBlocks(reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(start) + adjustment), num_objects);
+}
 
-  // Set the last element of the free list to nullptr
-  *p = nullptr;
+/**
+ * @brief Constructor for a growable PoolAllocator.  No memory is allocated until the first Allocate() or Reserve().
+ *
+ * @param obj_size Size of each object in the pool.
+ * @param alignment Alignment requirement for each object.
+ * @param objects_per_chunk Number of objects added each time the pool runs out.
+ */
+PoolAllocator::PoolAllocator(size_t obj_size, uint8_t alignment, size_t objects_per_chunk)
+    : object_alignment_(alignment),
+      object_size_(PoolBlockSize(obj_size, alignment)),
+      objects_per_chunk_(objects_per_chunk) {
+  assert(objects_per_chunk > 0);
+}
+
+PoolAllocator::~PoolAllocator() {
+  ReleaseChunks();
+  free_list_ = nullptr;
 }
 
-PoolAllocator::~PoolAllocator() { free_list_ = nullptr; }
+PoolAllocator::PoolAllocator(PoolAllocator &&other) noexcept
+    : object_alignment_(other.object_alignment_),
+      object_size_(other.object_size_),
+      free_list_(std::exchange(other.free_list_, nullptr)),
+      size_(std::exchange(other.size_, 0)),
+      used_memory_(std::exchange(other.used_memory_, 0)),
+      num_allocations_(std::exchange(other.num_allocations_, 0)),
+      capacity_(std::exchange(other.capacity_, 0)),
+      objects_per_chunk_(other.objects_per_chunk_),
+      chunks_(std::move(other.chunks_)),
+      stats_(std::move(other.stats_)) {
+  other.chunks_.clear();
+}
+
+PoolAllocator &PoolAllocator::operator=(PoolAllocator &&other) noexcept {
+  if (this != &other) {
+    ReleaseChunks();
+    object_alignment_ = other.object_alignment_;
+    object_size_ = other.object_size_;
+    free_list_ = std::exchange(other.free_list_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    used_memory_ = std::exchange(other.used_memory_, 0);
+    num_allocations_ = std::exchange(other.num_allocations_, 0);
+    capacity_ = std::exchange(other.capacity_, 0);
+    objects_per_chunk_ = other.objects_per_chunk_;
+    chunks_ = std::move(other.chunks_);
+    other.chunks_.clear();
+    stats_ = std::move(other.stats_);
+  }
+  return *this;
+}
 
 void *PoolAllocator::Allocate(size_t size, uint8_t alignment) {
-  // Check if the size, alignment, or free list is invalid
-  if (size == 0 || alignment == 0 || size != object_size_ || alignment != object_alignment_ || free_list_ == nullptr) {
+  // Check if the size or alignment is invalid
+  if (size == 0 || alignment == 0 || size > object_size_ || alignment > object_alignment_) {
+    stats_.RecordFailure();
     return nullptr;// Return nullptr as allocation is not possible
   }
 
+  // Grow by another chunk if the pool is exhausted
+  if (free_list_ == nullptr && (!IsGrowable() || !AddChunk(objects_per_chunk_))) {
+    stats_.RecordFailure();
+    return nullptr;
+  }
+
   // Get the pointer to the next free block
-  void *ptr = *free_list_;
+  void *ptr = free_list_;
 
   // Update the free list pointer to the next free block
   free_list_ = (void **) *free_list_;
 
   // Increase the used memory by the allocated size
-  used_memory_ += size;
+  used_memory_ += object_size_;
+  num_allocations_++;
+  stats_.RecordAllocation(object_size_, used_memory_);
 
   return ptr;// Return the allocated memory block
 }
 
 void PoolAllocator::Deallocate(void *ptr) {
+  if (ptr == nullptr) { return; }
+
   // Set the next pointer of the deallocated block to the current free list
   *((void **) ptr) = free_list_;
   // Update the free list to point to the deallocated block, making it the new head of the free list
   free_list_ = (void **) ptr;
   // Decrease the used memory by the size of the deallocated block
   used_memory_ -= object_size_;
+  num_allocations_--;
+  stats_.RecordRelease(used_memory_);
+}
+
+void PoolAllocator::Reserve(size_t num_objects) {
+  assert(IsGrowable());
+  const size_t available = capacity_ - num_allocations_;
+  if (num_objects > available) { AddChunk(num_objects - available); }
+}
+
+void PoolAllocator::TakeStats(PoolAllocator &other) {
+  stats_ = std::move(other.stats_);
+  stats_.SetCapacity(size_);
+}
+
+void PoolAllocator::LinkBlocks(void *start, size_t num_objects) {
+  if (num_objects == 0) { return; }
+
+  // Each free block stores the address of the next one, the last links to whatever was free before
+  auto address = reinterpret_cast<uintptr_t>(start);
+  for (size_t i = 0; i < num_objects - 1; i++) {
+    *reinterpret_cast<void **>(address) = reinterpret_cast<void *>(address + object_size_);
+    address += object_size_;
+  }
+  *reinterpret_cast<void **>(address) = free_list_;
+
+  free_list_ = reinterpret_cast<void **>(start);
+  capacity_ += num_objects;
+}
+
+bool PoolAllocator::AddChunk(size_t num_objects) {
+  const size_t chunk_size = num_objects * object_size_ + object_alignment_;
+  void *chunk = malloc(chunk_size);
+  if (chunk == nullptr) { return false; }
+
+  chunks_.push_back(chunk);
+  size_ += chunk_size;
+  stats_.SetCapacity(size_);
+  LinkBlocks(reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(chunk) + AlignSize(chunk, object_alignment_)), num_objects);
+  return true;
+}
+
+void PoolAllocator::ReleaseChunks() {
+  for (void *chunk : chunks_) { free(chunk); }
+  chunks_.clear();
 }
 
-}// namespace glaceon
\ No newline at end of file
+}// namespace glaceon
@@ -2,26 +2,61 @@
 #define GLACEON_GLACEON_CORE_MEMORYSUBSYSTEM_CPP_POOLALLOCATOR_H_
 
 #include <cstdint>
+#include <vector>
 
 #include "../Base.h"
+#include "AllocatorStats.h"
 namespace glaceon {
-class PoolAllocator {
+// Fixed-size block allocator.  Either carves a caller-provided region (fixed capacity), or, when constructed with an
+// object count per chunk, allocates further chunks from the heap whenever the free list runs dry.
+class GLACEON_API PoolAllocator {
  public:
   PoolAllocator(size_t obj_size, uint8_t alignment, size_t size, void *start);
+  PoolAllocator(size_t obj_size, uint8_t alignment, size_t objects_per_chunk);
   ~PoolAllocator();
 
+  // size and alignment may be smaller than the pool's, anything larger is rejected
   void *Allocate(size_t size, uint8_t alignment);
   void Deallocate(void *ptr);
 
+  // growable pools only: makes sure num_objects can be allocated without adding more chunks
+  void Reserve(size_t num_objects);
+
+  [[nodiscard]] size_t GetObjectSize() const { return object_size_; }
+  [[nodiscard]] size_t GetUsedMemory() const { return used_memory_; }
+  [[nodiscard]] size_t GetNumAllocations() const { return num_allocations_; }
+  [[nodiscard]] size_t GetCapacity() const { return capacity_; }
+  [[nodiscard]] size_t GetNumChunks() const { return chunks_.size(); }
+  [[nodiscard]] bool IsGrowable() const { return objects_per_chunk_ > 0; }
+
+  // lists the pool in AllocatorRegistry (and the memory panel) under name
+  void SetDebugName(const std::string &name) { stats_.Register(name, size_); }
+  [[nodiscard]] const AllocatorStats &GetStats() const { return stats_; }
+  // carries other's stats and registration over to this pool, for when it takes other's place
+  void TakeStats(PoolAllocator &other);
+
   PoolAllocator(const PoolAllocator &) = delete;
   PoolAllocator &operator=(const PoolAllocator &) = delete;
+  PoolAllocator(PoolAllocator &&other) noexcept;
+  PoolAllocator &operator=(PoolAllocator &&other) noexcept;
 
  private:
+  // threads num_objects blocks starting at start onto the free list
+  void LinkBlocks(void *start, size_t num_objects);
+  bool AddChunk(size_t num_objects);
+  void ReleaseChunks();
+
   uint8_t object_alignment_;
   size_t object_size_;
-  void **free_list_;
-  size_t size_;
-  size_t used_memory_;
+  void **free_list_ = nullptr;
+  size_t size_ = 0;
+  size_t used_memory_ = 0;
+  size_t num_allocations_ = 0;
+  size_t capacity_ = 0;
+
+  size_t objects_per_chunk_ = 0;// 0 for fixed pools
+  std::vector<void *> chunks_;  // heap chunks owned by growable pools
+  AllocatorStats stats_;
 };
 }// namespace glaceon
 #endif//GLACEON_GLACEON_CORE_MEMORYSUBSYSTEM_CPP_POOLALLOCATOR_H_
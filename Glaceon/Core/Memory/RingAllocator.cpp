@@ -1,12 +1,20 @@
 #include "RingAllocator.h"
 
+#include <new>
+#include <thread>
+
 #include "../../Utils.h"
 
 namespace glaceon {
 
-RingAllocator::RingAllocator(size_t size, void *start) : head_(0), tail_(0), is_full_(false) {
-  size_ = size;
-  start_ = start;
+RingAllocator::RingAllocator(size_t size, void *start) : head_(0), published_(0), tail_(0), completed_fence_(0) {
+  // block headers are placed at multiples of kBlockAlignment, so the ring itself must start and end on one
+  const uint8_t adjustment = AlignSize(start, kBlockAlignment);
+  assert(size > adjustment + 2 * kBlockAlignment);
+  assert(size - adjustment <= UINT32_MAX);
+
+  size_ = (size - adjustment) & ~(kBlockAlignment - 1);
+  start_ = reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(start) + adjustment);
   num_allocations_ = 0;
   used_memory_ = 0;
 }
@@ -18,104 +26,150 @@ RingAllocator::~RingAllocator() {
 }
 
 /**
- * @brief Allocates a block of memory from the RingAllocator.
+ * @brief Reserves a block of memory at the head of the ring.  Safe to call from any number of threads.
  *
  * @param size The size of the memory block to allocate.
  * @param alignment The alignment of the memory block.
- * @return void* A pointer to the allocated memory block, or nullptr if the allocation failed.
- *
- * This function tries to allocate a block of memory from the RingAllocator. It first checks if the size and
- * alignment are valid. Then it calculates the aligned address of the start of the memory block. 
- *
- * Next, it checks if there is enough space in the RingAllocator to allocate the requested memory block. It does this
- * by checking if the RingAllocator is not full and if the size of the memory block is less than or equal to the 
- * available space at the aligned address.
- *
- * If there is enough space, it updates the head pointer of the RingAllocator to the aligned address plus the size of
- * the memory block. If the updated head pointer exceeds the size of the RingAllocator, it wraps around to the start.
- * If the updated head pointer is equal to the tail pointer, it marks the RingAllocator as full.
+ * @return void* A pointer to the allocated memory block, or nullptr if the ring has no room left.
  *
- * Finally, it returns the aligned address as the pointer to the allocated memory block.
+ * The block (header, alignment padding and payload) is reserved with a single compare-and-swap on the head.  A block
+ * that would straddle the end of the ring is moved to its beginning and the skipped bytes are reserved along with it
+ * as an already released filler block.  If the ring looks full, released/completed blocks are reclaimed once and the
+ * reservation is retried.
  */
 void *RingAllocator::Allocate(size_t size, uint8_t alignment) {
   // Check if the size and alignment are valid
   if (size == 0 || alignment == 0) { return nullptr; }
 
-  // Calculate the aligned address of the start of the memory block
-  void *aligned_address = AlignAddress(start_, alignment);
+  const uint64_t payload_size = (size + kBlockAlignment - 1) & ~(kBlockAlignment - 1);
+
+  // distance from a block at the given ring offset to its aligned payload, leaving room for the header
+  auto payload_offset_at = [this, alignment](uint64_t offset) -> uint64_t {
+    auto block = reinterpret_cast<uintptr_t>(start_) + offset;
+    return reinterpret_cast<uintptr_t>(AlignAddress(reinterpret_cast<void *>(block + sizeof(BlockHeader)), alignment)) - block;
+  };
+
+  bool reclaimed = false;
+  uint64_t head = head_.load(std::memory_order_relaxed);
+  uint64_t skip, payload_offset, block_size, new_head;
+  for (;;) {
+    const uint64_t offset = head % size_;
+    skip = 0;
+    payload_offset = payload_offset_at(offset);
+    block_size = payload_offset + payload_size;
+    if (offset + block_size > size_) {
+      // does not fit before the end of the ring, skip the remainder and start over at the beginning
+      skip = size_ - offset;
+      payload_offset = payload_offset_at(0);
+      block_size = payload_offset + payload_size;
+    }
+    if (block_size > size_) {
+      stats_.RecordFailure();
+      return nullptr;
+    }
+
+    new_head = head + skip + block_size;
+    if (new_head - tail_.load(std::memory_order_acquire) > size_) {
+      if (reclaimed) {
+        stats_.RecordFailure();
+        return nullptr;
+      }
+      Reclaim();
+      reclaimed = true;
+      head = head_.load(std::memory_order_relaxed);
+      continue;
+    }
+    if (head_.compare_exchange_weak(head, new_head, std::memory_order_relaxed, std::memory_order_relaxed)) { break; }
+  }
 
-  // Check if there is enough space in the RingAllocator to allocate the requested memory block
-  bool enough_space = !is_full_ && size <= GetAvailableSpace(reinterpret_cast<uintptr_t>(aligned_address));
-  if (!enough_space) { return nullptr; }
+  if (skip > 0) { new (GetHeader(head)) BlockHeader{kReleased, static_cast<uint32_t>(skip), 0}; }
 
-  // Update the head pointer of the RingAllocator to the aligned address plus the size of the memory block
-  head_ = reinterpret_cast<uintptr_t>(aligned_address) + size;
-  if (head_ >= size_) { head_ -= size_; } // Wrap around to the start if the updated head pointer exceeds the size of the RingAllocator
-  if (head_ == tail_) { is_full_ = true; }// Mark the RingAllocator as full if the updated head pointer is equal to the tail pointer
+  auto *header = new (GetHeader(head + skip)) BlockHeader{kInUse, static_cast<uint32_t>(block_size), static_cast<uint32_t>(payload_offset)};
+  auto *payload = reinterpret_cast<uint8_t *>(header) + payload_offset;
+  *reinterpret_cast<uint32_t *>(payload - sizeof(uint32_t)) = static_cast<uint32_t>(payload_offset);
+
+  // publish in reservation order so Reclaim() never reads a header that has not been written yet; yield while waiting
+  // in case the thread that reserved before us got preempted, otherwise we would spin away its time slice
+  uint64_t expected = head;
+  while (!published_.compare_exchange_weak(expected, new_head, std::memory_order_release, std::memory_order_relaxed)) {
+    if (expected != head) { std::this_thread::yield(); }
+    expected = head;
+  }
 
-  return aligned_address;
+  stats_.RecordAllocation(size, GetReservedMemory());
+  return payload;
 }
 
 /**
- * @brief Deallocates a block of memory from the RingAllocator.
+ * @brief Hands a block back to the ring.  Its memory is reused once every block allocated before it is released too.
  *
- * @param ptr A pointer to the memory block to deallocate.
- *
- * This function checks if the given pointer is null. If it is, the function
- * returns immediately. Otherwise, it checks if the pointer matches the tail
- * pointer of the RingAllocator. If it does, the function updates the tail
- * pointer and marks the RingAllocator as not full.
- *
- * The function uses reinterpret_cast to convert the void pointer to an
- * unsigned integer pointer (uintptr_t) and then compares it with the tail
- * pointer of the RingAllocator. If they match, the function increments the tail
- * pointer by the size of the RingAllocator and wraps it around to the start if
- * it exceeds the size. Finally, it marks the RingAllocator as not full.
+ * @param ptr A pointer returned by Allocate(), or nullptr.
  */
 void RingAllocator::Deallocate(void *ptr) {
   // Check if the pointer is null
   if (ptr == nullptr) { return; }
 
-  // Check if the pointer matches the tail pointer of the RingAllocator
-  if (reinterpret_cast<uintptr_t>(ptr) == tail_) {
-    // Increment the tail pointer by the size of the RingAllocator
-    tail_ += size_;
-    // Wrap the tail pointer around to the start if it exceeds the size
-    if (tail_ >= size_) { tail_ = 0; }
-    // Mark the RingAllocator as not full
-    is_full_ = false;
-  }
+  GetHeaderFromPayload(ptr)->state.store(kReleased, std::memory_order_release);
+  Reclaim();
 }
 
 /**
- * @brief Calculates the amount of free space available at the given address.
+ * @brief Hands a block back to the ring once the GPU work reading it has completed.
  *
- * This function calculates the amount of free space available at the given address. It takes into account the case
- * where the head and tail pointers have wrapped around the ring buffer.
+ * @param ptr A pointer returned by Allocate().
+ * @param fence_value Value the submission consuming ptr signals; the block is reclaimed after CompleteFence(fence_value).
+ */
+void RingAllocator::Retire(void *ptr, uint64_t fence_value) {
+  assert(fence_value != kInUse && fence_value != kReleased);
+  if (ptr == nullptr) { return; }
+
+  GetHeaderFromPayload(ptr)->state.store(fence_value, std::memory_order_release);
+}
+
+void RingAllocator::CompleteFence(uint64_t completed_fence_value) {
+  assert(completed_fence_value >= completed_fence_.load(std::memory_order_relaxed));
+
+  completed_fence_.store(completed_fence_value, std::memory_order_release);
+  Reclaim();
+}
+
+size_t RingAllocator::GetReservedMemory() const {
+  return head_.load(std::memory_order_relaxed) - tail_.load(std::memory_order_relaxed);
+}
+
+RingAllocator::BlockHeader *RingAllocator::GetHeader(uint64_t position) const {
+  return reinterpret_cast<BlockHeader *>(reinterpret_cast<uintptr_t>(start_) + position % size_);
+}
+
+RingAllocator::BlockHeader *RingAllocator::GetHeaderFromPayload(void *ptr) {
+  const uint32_t payload_offset = *reinterpret_cast<uint32_t *>(reinterpret_cast<uintptr_t>(ptr) - sizeof(uint32_t));
+  return reinterpret_cast<BlockHeader *>(reinterpret_cast<uintptr_t>(ptr) - payload_offset);
+}
+
+/**
+ * @brief Advances the tail over every leading block that has been released or retired with a completed fence.
  *
- * @param address The address to check for free space.
- * @return The amount of free space available at the given address.
+ * Only one thread walks the ring at a time; if another one already is, this returns straight away and any block it
+ * missed is picked up by the next call.
  */
-uintptr_t RingAllocator::GetAvailableSpace(uintptr_t address) {
-  // If the head pointer has wrapped around the ring buffer, we need to consider both the distance from the head
-  // pointer to the given address, and the distance from the tail pointer to the given address.
-  if (head_ >= tail_) {
-    // If the given address is greater than or equal to the head pointer, we need to subtract the head pointer from
-    // the given address to get the distance.
-    if (address >= head_) {
-      // Subtract the head pointer from the given address to get the distance.
-      // The result is the amount of free space available at the given address.
-      return size_ - address + tail_;
-    }
-    // If the given address is less than the head pointer, we need to subtract the tail pointer from the given address
-    // to get the distance.
-    // The result is the amount of free space available at the given address.
-    return tail_ - address;
+void RingAllocator::Reclaim() {
+  if (reclaiming_.test_and_set(std::memory_order_acquire)) { return; }
+
+  const uint64_t old_tail = tail_.load(std::memory_order_relaxed);
+  uint64_t tail = old_tail;
+  const uint64_t published = published_.load(std::memory_order_acquire);
+  const uint64_t completed_fence = completed_fence_.load(std::memory_order_acquire);
+
+  while (tail != published) {
+    BlockHeader *header = GetHeader(tail);
+    const uint64_t state = header->state.load(std::memory_order_acquire);
+    if (state == kInUse || (state != kReleased && state > completed_fence)) { break; }
+    tail += header->size;
   }
-  // If the head pointer has not wrapped around the ring buffer, we only need to consider the distance from the
-  // tail pointer to the given address.
-  // The result is the amount of free space available at the given address.
-  return tail_ - address;
+
+  tail_.store(tail, std::memory_order_release);
+  reclaiming_.clear(std::memory_order_release);
+  if (tail != old_tail) { stats_.RecordRelease(GetReservedMemory()); }
 }
 
-}// namespace glaceon
\ No newline at end of file
+}// namespace glaceon
@@ -1,11 +1,25 @@
 #ifndef GLACEON_GLACEON_CORE_RINGALLOCATOR_H_
 #define GLACEON_GLACEON_CORE_RINGALLOCATOR_H_
 
+#include <atomic>
+#include <cstdint>
+
+#include "../Base.h"
 #include "Interface_Allocator.h"
 
 namespace glaceon {
 
-class RingAllocator : public IAllocator {
+// Multi-producer ring arena.  Any thread may Allocate(); space is reserved by bumping an atomic head and handed back
+// strictly in allocation order, so a block is only reused once every block allocated before it has been released.
+//
+// A block is given back either with Deallocate(), or with Retire() tagged with the fence value of the GPU submission
+// that reads it; retired blocks are reclaimed once CompleteFence() reports that value as reached.  start may point at
+// persistently mapped memory (e.g. a staging buffer), the allocator never touches memory it has not handed out.
+//
+// Reclamation is lazy: the tail is advanced by Deallocate()/CompleteFence() when nobody else is doing so, and by
+// Allocate() when the ring looks full.  The IAllocator counters are not maintained, use
+// GetReservedMemory() or GetStats().
+class GLACEON_API RingAllocator : public IAllocator {
  public:
   RingAllocator(size_t size, void *start);
   ~RingAllocator() override;
@@ -13,14 +27,41 @@ class RingAllocator : public IAllocator {
   void *Allocate(size_t size, uint8_t alignment) override;
   void Deallocate(void *ptr) override;
 
+  // ptr will be reclaimed once CompleteFence() has been called with fence_value or later; fence values start at 1
+  void Retire(void *ptr, uint64_t fence_value);
+  // called with the last fence value known to have signaled, values must not go backwards
+  void CompleteFence(uint64_t completed_fence_value);
+
+  // bytes between tail and head, including headers, padding and blocks not reclaimed yet
+  [[nodiscard]] size_t GetReservedMemory() const;
+
   RingAllocator(const RingAllocator &) = delete;
   RingAllocator &operator=(const RingAllocator &) = delete;
 
  private:
-  uintptr_t GetAvailableSpace(uintptr_t address);
+  // Precedes every block.  The last 4 bytes before a payload always hold the payload's distance from its header:
+  // either payload_offset itself, or a copy written into the alignment padding.
+  struct BlockHeader {
+    std::atomic<uint64_t> state;// kInUse, kReleased or the fence value the block was retired with
+    uint32_t size;              // whole block, header and padding included
+    uint32_t payload_offset;
+  };
+
+  static constexpr uint64_t kInUse = 0;
+  static constexpr uint64_t kReleased = UINT64_MAX;
+  static constexpr size_t kBlockAlignment = sizeof(BlockHeader);
+
+  BlockHeader *GetHeader(uint64_t position) const;
+  static BlockHeader *GetHeaderFromPayload(void *ptr);
+  // moves tail_ past every leading block that has been released or whose fence has completed
+  void Reclaim();
 
-  uintptr_t head_, tail_;
-  bool is_full_;
+  // monotonic byte positions, the ring offset is position % size_
+  alignas(64) std::atomic<uint64_t> head_;     // next byte to reserve
+  alignas(64) std::atomic<uint64_t> published_;// every block before this has its header written
+  alignas(64) std::atomic<uint64_t> tail_;     // first byte still in use
+  std::atomic<uint64_t> completed_fence_;
+  std::atomic_flag reclaiming_ = ATOMIC_FLAG_INIT;
 };
 
 }// namespace glaceon
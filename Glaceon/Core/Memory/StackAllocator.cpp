@@ -11,33 +11,35 @@ StackAllocator::StackAllocator(size_t size, void *start) {
 #if _DEBUG
   prev_position_ = nullptr;
 #endif// _DEBUG
-  prev_position_ = nullptr;
 
   current_pos_ = start;
   start_ = start;
   size_ = size;
   used_memory_ = 0;
+  num_allocations_ = 0;
 }
 
 StackAllocator::~StackAllocator() {
 #if _DEBUG
   prev_position_ = nullptr;
 #endif// _DEBUG
-  prev_position_ = nullptr;
   current_pos_ = nullptr;
 }
 
 void *StackAllocator::Allocate(size_t size, uint8_t alignment) {
   if (size == 0) return nullptr;
 
-  uint8_t adjustment = AlignSize(current_pos_, alignment);
-  if (used_memory_ + size + adjustment > size_) return nullptr;
-
-  void *align_address = reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(current_pos_) + adjustment);
+  // leave room for the AllocationHeader in front of the aligned address
+  void *align_address = AlignAddress(reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(current_pos_) + sizeof(AllocationHeader)), alignment);
+  uintptr_t adjustment = reinterpret_cast<uintptr_t>(align_address) - reinterpret_cast<uintptr_t>(current_pos_);
+  if (used_memory_ + size + adjustment > size_) {
+    stats_.RecordFailure();
+    return nullptr;
+  }
 
-  // Prepend the AllocationHeader to the current position
-  auto *header = (AllocationHeader *) (&align_address - sizeof(AllocationHeader));
-  header->adjustment = adjustment;
+  // Prepend the AllocationHeader to the aligned address
+  auto *header = reinterpret_cast<AllocationHeader *>(reinterpret_cast<uintptr_t>(align_address) - sizeof(AllocationHeader));
+  header->adjustment = static_cast<uint8_t>(adjustment);
 
 #if _DEBUG
   header->prev_address = prev_position_;
@@ -46,20 +48,164 @@ void *StackAllocator::Allocate(size_t size, uint8_t alignment) {
 
   current_pos_ = reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(align_address) + size);// put pointer to next free space
   used_memory_ += size + adjustment;
+  num_allocations_++;
+  stats_.RecordAllocation(size, used_memory_);
 
   return align_address;
 }
 
 void StackAllocator::Deallocate(void *ptr) {
+#if _DEBUG
   assert(ptr == prev_position_);
+#endif// _DEBUG
 
   auto *header = reinterpret_cast<AllocationHeader *>(reinterpret_cast<uintptr_t>(ptr) - sizeof(AllocationHeader));
-  used_memory_ -= reinterpret_cast<uintptr_t>(current_pos_) - header->adjustment;
   current_pos_ = reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(ptr) - header->adjustment);// set current position to next free space
+  used_memory_ = reinterpret_cast<uintptr_t>(current_pos_) - reinterpret_cast<uintptr_t>(start_);
+  num_allocations_--;
+  stats_.RecordRelease(used_memory_);
 
 #if _DEBUG
   prev_position_ = header->prev_address;
 #endif// _DEBUG
 }
 
-}// namespace glaceon
\ No newline at end of file
+StackAllocator::Marker StackAllocator::GetMarker() const {
+#if _DEBUG
+  return Marker{used_memory_, prev_position_};
+#else
+  return Marker{used_memory_};
+#endif// _DEBUG
+}
+
+/**
+ * @brief Releases every allocation made since the marker was taken in O(1).
+ *
+ * num_allocations_ is not tracked per marker; it is reset once the allocator is back at its start.
+ *
+ * @param marker A marker returned by GetMarker() that has not already been rolled back past.
+ */
+void StackAllocator::FreeToMarker(Marker marker) {
+  assert(marker.offset <= used_memory_);
+
+  current_pos_ = reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(start_) + marker.offset);
+  used_memory_ = marker.offset;
+  if (used_memory_ == 0) { num_allocations_ = 0; }
+  stats_.RecordRelease(used_memory_);
+
+#if _DEBUG
+  prev_position_ = marker.prev_position;
+#endif// _DEBUG
+}
+
+void StackAllocator::Clear() {
+  current_pos_ = start_;
+  used_memory_ = 0;
+  num_allocations_ = 0;
+  stats_.RecordRelease(0);
+
+#if _DEBUG
+  prev_position_ = nullptr;
+#endif// _DEBUG
+}
+
+// -------------------------- DOUBLE ENDED STACK ALLOCATOR --------------------------
+DoubleEndedStackAllocator::DoubleEndedStackAllocator(size_t size, void *start) {
+  assert(size > 0);// Ensure that size is greater than 0
+
+  start_ = start;
+  size_ = size;
+  used_memory_ = 0;
+  num_allocations_ = 0;
+  bottom_ = reinterpret_cast<uintptr_t>(start);
+  top_ = bottom_ + size;
+}
+
+DoubleEndedStackAllocator::~DoubleEndedStackAllocator() { start_ = nullptr; }
+
+void *DoubleEndedStackAllocator::Allocate(size_t size, uint8_t alignment) { return Allocate(size, alignment, StackSide::kBottom); }
+
+void *DoubleEndedStackAllocator::Allocate(size_t size, uint8_t alignment, StackSide side) {
+  if (size == 0 || alignment == 0) return nullptr;
+
+  // keep the AllocationHeader in front of the payload naturally aligned
+  if (alignment < alignof(AllocationHeader)) { alignment = alignof(AllocationHeader); }
+
+  uintptr_t address;
+  if (side == StackSide::kBottom) {
+    address = reinterpret_cast<uintptr_t>(AlignAddress(reinterpret_cast<void *>(bottom_ + sizeof(AllocationHeader)), alignment));
+    if (address + size > top_) {
+      stats_.RecordFailure();
+      return nullptr;
+    }
+
+    reinterpret_cast<AllocationHeader *>(address - sizeof(AllocationHeader))->prev_position = bottom_;
+    bottom_ = address + size;
+  } else {
+    address = (top_ - size) & ~static_cast<uintptr_t>(alignment - 1);
+    if (size + sizeof(AllocationHeader) > top_ - bottom_ || address - sizeof(AllocationHeader) < bottom_) {
+      stats_.RecordFailure();
+      return nullptr;
+    }
+
+    reinterpret_cast<AllocationHeader *>(address - sizeof(AllocationHeader))->prev_position = top_;
+    top_ = address - sizeof(AllocationHeader);
+  }
+
+  num_allocations_++;
+  UpdateUsedMemory();
+  stats_.RecordAllocation(size, used_memory_);
+  return reinterpret_cast<void *>(address);
+}
+
+void DoubleEndedStackAllocator::Deallocate(void *ptr) {
+  if (ptr == nullptr) return;
+
+  auto address = reinterpret_cast<uintptr_t>(ptr);
+  auto *header = reinterpret_cast<AllocationHeader *>(address - sizeof(AllocationHeader));
+  if (address > top_) {
+    assert(header->prev_position > top_);
+    top_ = header->prev_position;
+  } else {
+    assert(header->prev_position < bottom_);
+    bottom_ = header->prev_position;
+  }
+
+  num_allocations_--;
+  UpdateUsedMemory();
+  stats_.RecordRelease(used_memory_);
+}
+
+DoubleEndedStackAllocator::Marker DoubleEndedStackAllocator::GetMarker(StackSide side) const {
+  const auto start = reinterpret_cast<uintptr_t>(start_);
+  return Marker{side, side == StackSide::kBottom ? bottom_ - start : top_ - start};
+}
+
+/**
+ * @brief Releases every allocation made on the marker's side since it was taken in O(1).  The other side is untouched.
+ *
+ * @param marker A marker returned by GetMarker() that has not already been rolled back past.
+ */
+void DoubleEndedStackAllocator::FreeToMarker(Marker marker) {
+  const uintptr_t position = reinterpret_cast<uintptr_t>(start_) + marker.offset;
+  if (marker.side == StackSide::kBottom) {
+    assert(position <= bottom_);
+    bottom_ = position;
+  } else {
+    assert(position >= top_);
+    top_ = position;
+  }
+
+  UpdateUsedMemory();
+  if (used_memory_ == 0) { num_allocations_ = 0; }
+  stats_.RecordRelease(used_memory_);
+}
+
+void DoubleEndedStackAllocator::Clear(StackSide side) { FreeToMarker(Marker{side, side == StackSide::kBottom ? 0 : size_}); }
+
+void DoubleEndedStackAllocator::UpdateUsedMemory() {
+  const auto start = reinterpret_cast<uintptr_t>(start_);
+  used_memory_ = (bottom_ - start) + (start + size_ - top_);
+}
+
+}// namespace glaceon
@@ -1,22 +1,38 @@
 #ifndef GLACEON_GLACEON_CORE_STACKALLOCATOR_H_
 #define GLACEON_GLACEON_CORE_STACKALLOCATOR_H_
 
+#include "../Base.h"
 #include "Interface_Allocator.h"
 
 namespace glaceon {
 
-class StackAllocator : public IAllocator {
+// LIFO allocator.  Besides freeing the most recent allocation with Deallocate(), everything allocated after a
+// GetMarker() call can be released in one go with FreeToMarker(), or automatically with a StackMarkerScope.
+class GLACEON_API StackAllocator : public IAllocator {
  public:
+  struct Marker {
+    size_t offset;
+#if _DEBUG
+    void *prev_position;
+#endif// _DEBUG
+  };
+
   StackAllocator(size_t size, void *start);
   ~StackAllocator() override;
 
   void *Allocate(size_t size, uint8_t alignment) override;
+  // ptr must be the most recent allocation still alive
   void Deallocate(void *ptr) override;
 
+  [[nodiscard]] Marker GetMarker() const;
+  void FreeToMarker(Marker marker);
+  void Clear();
+
+  StackAllocator(const StackAllocator &) = delete;
+  StackAllocator &operator=(const StackAllocator &) = delete;
+
+ private:
   void *current_pos_;
-  void *start_;
-  size_t size_;
-  size_t used_memory_;
 
 #if _DEBUG
   void *prev_position_;
@@ -31,6 +47,69 @@ class StackAllocator : public IAllocator {
   };
 };
 
+enum class StackSide : uint8_t { kBottom, kTop };
+
+// Two stacks sharing one block: the bottom stack grows up from the start, the top stack grows down from the end, and
+// the block is only full once they meet.  Typically one side holds long-lived data (e.g. the level) and the other
+// short-lived temporaries (e.g. used while loading it), so neither fragments the other.
+class GLACEON_API DoubleEndedStackAllocator : public IAllocator {
+ public:
+  struct Marker {
+    StackSide side;
+    size_t offset;
+  };
+
+  DoubleEndedStackAllocator(size_t size, void *start);
+  ~DoubleEndedStackAllocator() override;
+
+  // allocates from the bottom stack
+  void *Allocate(size_t size, uint8_t alignment) override;
+  void *Allocate(size_t size, uint8_t alignment, StackSide side);
+  // ptr must be the most recent allocation still alive on its side
+  void Deallocate(void *ptr) override;
+
+  [[nodiscard]] Marker GetMarker(StackSide side) const;
+  void FreeToMarker(Marker marker);
+  void Clear(StackSide side);
+
+  [[nodiscard]] size_t GetFreeMemory() const { return top_ - bottom_; }
+
+  DoubleEndedStackAllocator(const DoubleEndedStackAllocator &) = delete;
+  DoubleEndedStackAllocator &operator=(const DoubleEndedStackAllocator &) = delete;
+
+ private:
+  struct AllocationHeader {
+    uintptr_t prev_position;// bottom_ or top_ before the allocation
+  };
+
+  void UpdateUsedMemory();
+
+  uintptr_t bottom_;// first free byte above the bottom stack
+  uintptr_t top_;   // one past the last free byte below the top stack
+};
+
+// Frees everything allocated from a stack allocator during its lifetime.
+//
+// e.g.
+//  {
+//    StackMarkerScope scope(level_allocator, StackSide::kTop);
+//    void *scratch = level_allocator.Allocate(size, 16, StackSide::kTop);
+//  }// scratch released here
+template<typename Allocator>
+class StackMarkerScope {
+ public:
+  template<typename... Args>
+  explicit StackMarkerScope(Allocator &allocator, Args... args) : allocator_(allocator), marker_(allocator.GetMarker(args...)) {}
+  ~StackMarkerScope() { allocator_.FreeToMarker(marker_); }
+
+  StackMarkerScope(const StackMarkerScope &) = delete;
+  StackMarkerScope &operator=(const StackMarkerScope &) = delete;
+
+ private:
+  Allocator &allocator_;
+  typename Allocator::Marker marker_;
+};
+
 }// namespace glaceon
 
 #endif//GLACEON_GLACEON_CORE_STACKALLOCATOR_H_
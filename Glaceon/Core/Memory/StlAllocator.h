@@ -0,0 +1,90 @@
+#ifndef GLACEON_GLACEON_CORE_STLALLOCATOR_H_
+#define GLACEON_GLACEON_CORE_STLALLOCATOR_H_
+
+#include <cassert>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+
+#include "../Base.h"
+#include "Interface_Allocator.h"
+
+namespace glaceon {
+
+// Typed STL allocator over any IAllocator, for containers whose type is known at compile time.
+//
+// e.g.
+//  FreeListAllocator free_list(size, start);
+//  std::vector<glm::vec3, glaceon::Allocator<glm::vec3>> positions(glaceon::Allocator<glm::vec3>(&free_list));
+template<typename T>
+class Allocator {
+ public:
+  using value_type = T;
+
+  explicit Allocator(IAllocator *allocator) noexcept : allocator_(allocator) {}
+  template<typename U>
+  Allocator(const Allocator<U> &other) noexcept : allocator_(other.GetAllocator()) {}
+
+  T *allocate(size_t n) {
+    static_assert(alignof(T) <= UINT8_MAX, "IAllocator alignment is limited to 8 bits");
+    void *ptr = allocator_->Allocate(n * sizeof(T), static_cast<uint8_t>(alignof(T)));
+    if (ptr == nullptr) { throw std::bad_alloc(); }
+    return static_cast<T *>(ptr);
+  }
+
+  void deallocate(T *ptr, size_t) noexcept {
+    if (allocator_->SupportsDeallocate()) { allocator_->Deallocate(ptr); }
+  }
+
+  [[nodiscard]] IAllocator *GetAllocator() const noexcept { return allocator_; }
+
+  template<typename U>
+  bool operator==(const Allocator<U> &other) const noexcept {
+    return allocator_ == other.GetAllocator();
+  }
+
+ private:
+  IAllocator *allocator_;
+};
+
+// std::pmr bridge over any IAllocator so the same container type (std::pmr::vector etc.) can be pointed at different
+// arenas at runtime.  Keeps a count of what was routed through it to measure how much traffic was moved off malloc.
+//
+// e.g.
+//  AllocatorResource resource(&linear_allocator);
+//  std::pmr::vector<float> vertices(&resource);
+class GLACEON_API AllocatorResource : public std::pmr::memory_resource {
+ public:
+  explicit AllocatorResource(IAllocator *allocator) : allocator_(allocator) {}
+
+  [[nodiscard]] IAllocator *GetAllocator() const { return allocator_; }
+  [[nodiscard]] uint64_t GetNumAllocations() const { return num_allocations_; }
+  [[nodiscard]] uint64_t GetBytesAllocated() const { return bytes_allocated_; }
+
+ private:
+  void *do_allocate(size_t bytes, size_t alignment) override {
+    assert(alignment <= UINT8_MAX && "IAllocator alignment is limited to 8 bits");
+    void *ptr = allocator_->Allocate(bytes, static_cast<uint8_t>(alignment));
+    if (ptr == nullptr) { throw std::bad_alloc(); }
+    num_allocations_++;
+    bytes_allocated_ += bytes;
+    return ptr;
+  }
+
+  void do_deallocate(void *ptr, size_t, size_t) override {
+    if (allocator_->SupportsDeallocate()) { allocator_->Deallocate(ptr); }
+  }
+
+  [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+    const auto *resource = dynamic_cast<const AllocatorResource *>(&other);
+    return resource != nullptr && resource->allocator_ == allocator_;
+  }
+
+  IAllocator *allocator_;
+  uint64_t num_allocations_ = 0;
+  uint64_t bytes_allocated_ = 0;
+};
+
+}// namespace glaceon
+
+#endif//GLACEON_GLACEON_CORE_STLALLOCATOR_H_
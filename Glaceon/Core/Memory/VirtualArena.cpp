@@ -0,0 +1,197 @@
+#include "VirtualArena.h"
+
+#ifdef _WIN64
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+
+#include "../../Utils.h"
+#include "../Logger.h"
+
+namespace glaceon {
+
+static constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+// commit at least this much at a time so a growing arena does not make a system call per page
+static constexpr size_t kMinCommitSize = 64 * 1024;
+
+static size_t AlignUpTo(size_t value, size_t alignment) { return (value + alignment - 1) & ~(alignment - 1); }
+
+// -------------------------- VIRTUAL MEMORY --------------------------
+
+size_t virtual_memory::GetPageSize() {
+#ifdef _WIN64
+  static const size_t page_size = [] {
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return static_cast<size_t>(info.dwPageSize);
+  }();
+#else
+  static const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+  return page_size;
+}
+
+void *virtual_memory::Reserve(size_t size, VirtualPageMode &page_mode) {
+#ifdef _WIN64
+  // large pages on Windows need SeLockMemoryPrivilege and have to be committed up front, which defeats the purpose
+  if (page_mode != VirtualPageMode::kDefault) {
+    GWARN_CH(Memory, "VirtualArena: huge pages are not supported on Windows, using regular pages");
+    page_mode = VirtualPageMode::kDefault;
+  }
+  return VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+#else
+  if (page_mode == VirtualPageMode::kExplicitHuge) {
+    // no MAP_NORESERVE: hugetlb pages are reserved now so a later page fault cannot SIGBUS
+    void *address = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (address != MAP_FAILED) { return address; }
+    GWARN_CH(Memory, "VirtualArena: not enough explicit huge pages for {} bytes, falling back to transparent huge pages", size);
+    page_mode = VirtualPageMode::kTransparentHuge;
+  }
+
+  if (page_mode == VirtualPageMode::kDefault) {
+    void *address = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return address == MAP_FAILED ? nullptr : address;
+  }
+
+  // transparent huge pages are only used for 2 MiB aligned ranges, over-reserve and trim both ends
+  void *mapping = mmap(nullptr, size + kHugePageSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (mapping == MAP_FAILED) { return nullptr; }
+
+  const auto mapping_start = reinterpret_cast<uintptr_t>(mapping);
+  const uintptr_t start = AlignUpTo(mapping_start, kHugePageSize);
+  if (start > mapping_start) { munmap(mapping, start - mapping_start); }
+  if (const size_t tail = mapping_start + kHugePageSize - start; tail > 0) { munmap(reinterpret_cast<void *>(start + size), tail); }
+
+  auto *address = reinterpret_cast<void *>(start);
+  if (madvise(address, size, MADV_HUGEPAGE) != 0) {
+    GWARN_CH(Memory, "VirtualArena: transparent huge pages are unavailable, using regular pages");
+    page_mode = VirtualPageMode::kDefault;
+  }
+  return address;
+#endif
+}
+
+bool virtual_memory::Commit(void *address, size_t size) {
+#ifdef _WIN64
+  return VirtualAlloc(address, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#else
+  return mprotect(address, size, PROT_READ | PROT_WRITE) == 0;
+#endif
+}
+
+void virtual_memory::Decommit(void *address, size_t size) {
+#ifdef _WIN64
+  VirtualFree(address, size, MEM_DECOMMIT);
+#else
+  // drop the physical pages first, then make the range inaccessible again so stale pointers fault
+  madvise(address, size, MADV_DONTNEED);
+  mprotect(address, size, PROT_NONE);
+#endif
+}
+
+void virtual_memory::Release(void *address, size_t size) {
+#ifdef _WIN64
+  (void) size;
+  VirtualFree(address, 0, MEM_RELEASE);
+#else
+  munmap(address, size);
+#endif
+}
+
+// -------------------------- VIRTUAL ARENA --------------------------
+
+/**
+ * @brief Reserves reserve_size bytes of address space; no memory is committed until the first allocation.
+ *
+ * @param reserve_size Upper bound of the arena, rounded up to the commit granularity.
+ * @param page_mode Page size to ask the OS for; falls back to smaller pages when unavailable, see GetPageMode().
+ */
+VirtualArena::VirtualArena(size_t reserve_size, VirtualPageMode page_mode) : page_mode_(page_mode) {
+  assert(reserve_size > 0);
+
+  const size_t reserve_granularity = page_mode == VirtualPageMode::kDefault ? virtual_memory::GetPageSize() : kHugePageSize;
+  size_ = AlignUpTo(reserve_size, reserve_granularity);
+  start_ = virtual_memory::Reserve(size_, page_mode_);
+  if (start_ == nullptr) {
+    GERROR_CH(Memory, "VirtualArena: failed to reserve {} bytes of address space", size_);
+    size_ = 0;
+  }
+
+  commit_granularity_ = page_mode_ == VirtualPageMode::kDefault ? std::max(virtual_memory::GetPageSize(), kMinCommitSize) : kHugePageSize;
+  used_memory_ = 0;
+  num_allocations_ = 0;
+}
+
+VirtualArena::~VirtualArena() {
+  if (start_ != nullptr) { virtual_memory::Release(start_, size_); }
+  start_ = nullptr;
+}
+
+/**
+ * @brief Bump-allocates from the arena, committing further pages when the allocation runs past the committed range.
+ *
+ * @param size The size of the memory block to allocate.
+ * @param alignment The alignment of the memory block.
+ * @return void* A pointer to the allocated memory block, or nullptr if the reservation is exhausted or the commit failed.
+ */
+void *VirtualArena::Allocate(size_t size, uint8_t alignment) {
+  if (size == 0 || alignment == 0) return nullptr;
+
+  const uintptr_t current = reinterpret_cast<uintptr_t>(start_) + used_memory_;
+  const uint8_t adjustment = AlignSize(reinterpret_cast<void *>(current), alignment);
+  const size_t end = used_memory_ + adjustment + size;
+  if (end > size_ || (end > committed_ && !CommitUpTo(end))) {
+    stats_.RecordFailure();
+    return nullptr;
+  }
+
+  used_memory_ = end;
+  num_allocations_++;
+  stats_.RecordAllocation(size, used_memory_);
+  return reinterpret_cast<void *>(current + adjustment);
+}
+
+void VirtualArena::Deallocate(void *ptr) { assert(false && "Deallocate not implemented for VirtualArena; use FreeToMarker() or Reset() instead"); }
+
+/**
+ * @brief Releases every allocation made since the marker was taken.  Pages stay committed, see Decommit().
+ *
+ * @param marker A marker returned by GetMarker() that has not already been rolled back past.
+ */
+void VirtualArena::FreeToMarker(Marker marker) {
+  assert(marker <= used_memory_);
+  used_memory_ = marker;
+  if (used_memory_ == 0) { num_allocations_ = 0; }
+  stats_.RecordRelease(used_memory_);
+}
+
+void VirtualArena::Reset(bool decommit) {
+  FreeToMarker(0);
+  if (decommit) { Decommit(); }
+}
+
+void VirtualArena::Decommit() {
+  const size_t keep = AlignUpTo(used_memory_, commit_granularity_);
+  if (committed_ <= keep) { return; }
+
+  virtual_memory::Decommit(reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(start_) + keep), committed_ - keep);
+  committed_ = keep;
+}
+
+bool VirtualArena::CommitUpTo(size_t offset) {
+  const size_t new_committed = std::min(AlignUpTo(offset, commit_granularity_), size_);
+  if (!virtual_memory::Commit(reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(start_) + committed_), new_committed - committed_)) {
+    GERROR_CH(Memory, "VirtualArena: failed to commit {} bytes", new_committed - committed_);
+    return false;
+  }
+  committed_ = new_committed;
+  return true;
+}
+
+}// namespace glaceon
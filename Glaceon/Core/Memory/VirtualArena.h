@@ -0,0 +1,81 @@
+#ifndef GLACEON_GLACEON_CORE_VIRTUALARENA_H_
+#define GLACEON_GLACEON_CORE_VIRTUALARENA_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "../Base.h"
+#include "Interface_Allocator.h"
+
+namespace glaceon {
+
+enum class VirtualPageMode : uint8_t {
+  kDefault,
+  // ask for transparent huge pages (madvise(MADV_HUGEPAGE)) and commit in 2 MiB steps; silently falls back
+  kTransparentHuge,
+  // back the range with explicit huge pages (MAP_HUGETLB); the whole range is taken from /proc/sys/vm/nr_hugepages up
+  // front, so size it accordingly.  Falls back to kTransparentHuge when the pool is too small
+  kExplicitHuge,
+};
+
+// Thin wrappers over the OS virtual memory API (mmap/madvise on Linux, VirtualAlloc on Windows).  Reserved memory takes
+// address space only; committing makes pages accessible, and they take physical memory once first touched.
+namespace virtual_memory {
+GLACEON_API size_t GetPageSize();
+// page_mode is updated to what could actually be provided; size must be a multiple of the huge page size for huge modes
+GLACEON_API void *Reserve(size_t size, VirtualPageMode &page_mode);
+GLACEON_API bool Commit(void *address, size_t size);
+// hands the pages back to the OS; the range stays reserved and can be committed again
+GLACEON_API void Decommit(void *address, size_t size);
+GLACEON_API void Release(void *address, size_t size);
+}// namespace virtual_memory
+
+// Linear/stack allocator over a reserved address range.  Pages are committed as the bump pointer reaches them, so the
+// arena can be sized for the worst case up front and still grows in place: nothing is ever relocated or copied, and
+// pointers stay valid until they are rolled back with FreeToMarker() or Reset().
+//
+// Reset()/FreeToMarker() only move the bump pointer; Decommit()/Reset(true) also return the pages above it to the OS,
+// e.g. to shrink the resident set after a level unload.
+//
+// e.g.
+//  VirtualArena mesh_arena(4ULL * 1024 * 1024 * 1024, VirtualPageMode::kTransparentHuge);// 4 GiB of address space
+//  VirtualArena::Marker level_start = mesh_arena.GetMarker();
+//  ...
+//  mesh_arena.FreeToMarker(level_start);
+//  mesh_arena.Decommit();
+class GLACEON_API VirtualArena : public IAllocator {
+ public:
+  using Marker = size_t;
+
+  explicit VirtualArena(size_t reserve_size, VirtualPageMode page_mode = VirtualPageMode::kDefault);
+  ~VirtualArena() override;
+
+  void *Allocate(size_t size, uint8_t alignment) override;
+  void Deallocate(void *ptr) override;
+  bool SupportsDeallocate() const override { return false; }
+
+  [[nodiscard]] Marker GetMarker() const { return used_memory_; }
+  void FreeToMarker(Marker marker);
+  // rolls back to the start, decommitting every page when decommit is set
+  void Reset(bool decommit = false);
+  // returns committed pages above the current position to the OS
+  void Decommit();
+
+  [[nodiscard]] size_t GetCommittedMemory() const { return committed_; }
+  [[nodiscard]] size_t GetCommitGranularity() const { return commit_granularity_; }
+  [[nodiscard]] VirtualPageMode GetPageMode() const { return page_mode_; }
+
+  VirtualArena(const VirtualArena &) = delete;
+  VirtualArena &operator=(const VirtualArena &) = delete;
+
+ private:
+  bool CommitUpTo(size_t offset);
+
+  VirtualPageMode page_mode_;
+  size_t commit_granularity_;
+  size_t committed_ = 0;
+};
+
+}// namespace glaceon
+
+#endif//GLACEON_GLACEON_CORE_VIRTUALARENA_H_
@@ -0,0 +1,138 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../Profiler/InstrumentationTimer.h"
+#include "../Profiler/Profiler.h"
+
+namespace glaceon {
+
+// ranges per thread, so a thread that got slow ones is not left working alone at the end
+static constexpr size_t kRangesPerThread = 4;
+
+// One ParallelFor(), on the caller's stack.  Threads claim ranges with next_range until they run out.
+struct ParallelJob {
+  const std::function<void(size_t, size_t)> *fn = nullptr;
+  size_t count = 0;
+  size_t range_size = 0;
+  size_t num_ranges = 0;
+  std::atomic<size_t> next_range{0};
+  std::atomic<size_t> done_ranges{0};
+  uint32_t workers_inside = 0;// guarded by mutex_, the caller waits for it to drop to 0 before the job goes away
+};
+
+static std::mutex submit_mutex_;// one ParallelFor() at a time
+static std::mutex mutex_;
+static std::condition_variable work_available_;
+static std::condition_variable work_done_;
+static std::vector<std::thread> workers_;
+static ParallelJob *job_ = nullptr;
+static uint64_t job_generation_ = 0;
+static bool stop_workers_ = false;
+static thread_local bool inside_job_ = false;
+
+static void RunRanges(ParallelJob &job) {
+  inside_job_ = true;
+  for (size_t range = job.next_range.fetch_add(1, std::memory_order_relaxed); range < job.num_ranges;
+       range = job.next_range.fetch_add(1, std::memory_order_relaxed)) {
+    const size_t begin = range * job.range_size;
+    (*job.fn)(begin, std::min(job.count, begin + job.range_size));
+    if (job.done_ranges.fetch_add(1, std::memory_order_acq_rel) + 1 == job.num_ranges) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      work_done_.notify_all();
+    }
+  }
+  inside_job_ = false;
+}
+
+static void WorkerMain(uint32_t worker_index) {
+  Profiler::SetThreadName(Profiler::InternName(fmt::format("Worker {}", worker_index)));
+  uint64_t seen_generation = 0;
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    work_available_.wait(lock, [&] { return stop_workers_ || job_generation_ != seen_generation; });
+    if (stop_workers_) { return; }
+    seen_generation = job_generation_;
+    ParallelJob *job = job_;
+    if (job == nullptr) { continue; }
+
+    job->workers_inside++;
+    lock.unlock();
+    RunRanges(*job);
+    lock.lock();
+    job->workers_inside--;
+    work_done_.notify_all();
+  }
+}
+
+// joins workers that are still running at exit
+struct WorkerGuard {
+  ~WorkerGuard() { ThreadPool::Shutdown(); }
+};
+static WorkerGuard worker_guard_;
+
+uint32_t ThreadPool::GetWorkerCount() { return std::max(std::thread::hardware_concurrency(), 1u) - 1; }
+
+/**
+ * @brief Splits [0, count) into ranges and runs fn over them on the workers and the calling thread.
+ *
+ * @param count Number of items.
+ * @param min_range Fewest items per range, so tiny ranges do not cost more to hand out than to run.
+ * @param fn Called with [begin, end) of each range, from several threads at once.
+ */
+void ThreadPool::ParallelFor(size_t count, size_t min_range, const std::function<void(size_t, size_t)> &fn) {
+  if (count == 0) { return; }
+  min_range = std::max<size_t>(min_range, 1);
+  const uint32_t worker_count = GetWorkerCount();
+  if (inside_job_ || worker_count == 0 || count <= min_range) {
+    fn(0, count);
+    return;
+  }
+
+  GLACEON_PROFILE_FUNCTION();
+  std::lock_guard<std::mutex> submit_lock(submit_mutex_);
+
+  ParallelJob job;
+  job.fn = &fn;
+  job.count = count;
+  job.num_ranges = std::min((count + min_range - 1) / min_range, kRangesPerThread * (worker_count + 1));
+  job.range_size = (count + job.num_ranges - 1) / job.num_ranges;
+  job.num_ranges = (count + job.range_size - 1) / job.range_size;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_workers_ = false;
+    while (workers_.size() < worker_count) {
+      workers_.emplace_back(WorkerMain, static_cast<uint32_t>(workers_.size()));
+    }
+    job_ = &job;
+    job_generation_++;
+  }
+  work_available_.notify_all();
+
+  RunRanges(job);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  // no worker can pick the job up once it is unpublished, then wait for those already in it
+  work_done_.wait(lock, [&] { return job.done_ranges.load(std::memory_order_acquire) == job.num_ranges; });
+  job_ = nullptr;
+  work_done_.wait(lock, [&] { return job.workers_inside == 0; });
+}
+
+void ThreadPool::Shutdown() {
+  std::lock_guard<std::mutex> submit_lock(submit_mutex_);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_workers_ = true;
+  }
+  work_available_.notify_all();
+  for (std::thread &worker : workers_) { worker.join(); }
+  workers_.clear();
+}
+
+}// namespace glaceon
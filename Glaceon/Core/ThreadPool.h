@@ -0,0 +1,31 @@
+#ifndef GLACEON_GLACEON_CORE_THREADPOOL_H_
+#define GLACEON_GLACEON_CORE_THREADPOOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "Base.h"
+
+namespace glaceon {
+
+// Worker threads for splitting CPU heavy loops, such as mesh extraction, across the cores.
+//
+// The workers start on the first ParallelFor() and sleep in between.  One ParallelFor() runs at a time, a second
+// caller waits for the first; one called from inside a job runs inline on that thread.
+class GLACEON_API ThreadPool {
+ public:
+  // Calls fn(begin, end) on consecutive ranges covering [0, count), each at least min_range long (but the last), on
+  // the workers and the calling thread.  Returns once every range is done.  fn must not throw.
+  static void ParallelFor(size_t count, size_t min_range, const std::function<void(size_t begin, size_t end)> &fn);
+
+  // hardware threads - 1, the caller of ParallelFor() being the last one
+  [[nodiscard]] static uint32_t GetWorkerCount();
+
+  // joins the workers; the next ParallelFor() starts them again
+  static void Shutdown();
+};
+
+}// namespace glaceon
+
+#endif// GLACEON_GLACEON_CORE_THREADPOOL_H_
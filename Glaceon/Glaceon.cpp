@@ -2,7 +2,15 @@
 
 #include "Application.h"
 #include "Core/Logger.h"
+#include "Core/Memory/AllocatorStats.h"
+#include "Core/Memory/FrameArena.h"
+#include "Core/ThreadPool.h"
 #include "GLFW/glfw3.h"
+#include "Profiler/FrameStats.h"
+#include "Profiler/InstrumentationTimer.h"
+#include "Profiler/MemoryPanel.h"
+#include "Profiler/PerformanceHud.h"
+#include "Profiler/Profiler.h"
 #include "Utils.h"
 #include "VulkanRenderer/VulkanBase.h"
 #include "VulkanRenderer/VulkanRenderPass.h"
@@ -12,6 +20,19 @@ namespace glaceon {
 static bool swapChainRebuild = false;
 static Application *currentApp = nullptr;
 
+// transient per-frame memory; each frame in flight gets its own arena
+static constexpr size_t kFrameArenaSize = 64 * 1024;
+static FrameArena frameArena;
+
+// F9 captures this many frames into a Chrome trace, F9 again stops early
+static constexpr uint32_t kProfileCaptureFrames = 300;
+
+#if _DEBUG
+static constexpr bool kShowDebugPanels = true;
+#else
+static constexpr bool kShowDebugPanels = false;
+#endif
+
 void ErrorCallback(int error, const char *description) { GERROR("GLFW Error: Code: {} - {}", error, description); }
 
 void CheckVkResult(VkResult result) {
@@ -27,6 +48,14 @@ void KeyboardCallback(GLFWwindow *window, int key, [[maybe_unused]] int scancode
     GINFO("Escape key pressed, closing window...");
     glfwSetWindowShouldClose(window, GLFW_TRUE);
   }
+  if (key == GLFW_KEY_F3 && action == GLFW_PRESS) { PerformanceHud::Toggle(); }
+  if (key == GLFW_KEY_F9 && action == GLFW_PRESS) {
+    if (Profiler::IsActive()) {
+      Profiler::EndSession();
+    } else {
+      Profiler::BeginSession("glaceon_trace.json", kProfileCaptureFrames);
+    }
+  }
 }
 
 static void ImGuiInitialize(VulkanContext &context, GLFWwindow *glfw_window) {
@@ -75,10 +104,17 @@ static void ImGuiInitialize(VulkanContext &context, GLFWwindow *glfw_window) {
 void MakeAssets(VulkanContext &context) {
 
   vertex_buffer_collection = new VertexBufferCollection();
-  const std::vector<glm::vec3> positions = currentApp->GetScene().vertex_positions;
-  std::vector<glm::vec3> unique_pos;
-  const std::vector<uint32_t> indexes = GetIndexFromVertexData(positions, unique_pos);
-  vertex_buffer_collection->Add(unique_pos, indexes);
+  const MeshFile &mesh_file = currentApp->GetScene().mesh_file;
+  if (mesh_file.IsOpen()) {
+    // cooked, the mapped pages go straight into the staging buffers
+    vertex_buffer_collection->Finalize(MeshType::kVertex, mesh_file.GetPositions(), mesh_file.GetIndices(), context.GetVulkanLogicalDevice(),
+                                       context.GetVulkanPhysicalDevice(), context.GetVulkanDevice().GetVkGraphicsQueue(),
+                                       context.GetVulkanCommandPool().GetVkMainCommandBuffer());
+  } else {
+    // imported, the indices are already in the order the importer optimized them for
+    const Scene &scene = currentApp->GetScene();
+    vertex_buffer_collection->Add(scene.vertex_positions, scene.vertex_indices);
+  }
 
   // std::vector<float> triangle_vertices = {
   //     0.0f,  -0.1f, 0.0f, 1.0f, 0.0f, 0.5f, 0.0f,// 0
@@ -127,30 +163,34 @@ void MakeAssets(VulkanContext &context) {
   // };
   // vertex_buffer_collection->Add(MeshType::STAR, star_vertices, star_indexes);
 
-  vertex_buffer_collection->Finalize(context.GetVulkanLogicalDevice(), context.GetVulkanPhysicalDevice(),
-                                     context.GetVulkanDevice().GetVkGraphicsQueue(), context.GetVulkanCommandPool().GetVkMainCommandBuffer());
+  if (!mesh_file.IsOpen()) {
+    vertex_buffer_collection->Finalize(context.GetVulkanLogicalDevice(), context.GetVulkanPhysicalDevice(),
+                                       context.GetVulkanDevice().GetVkGraphicsQueue(), context.GetVulkanCommandPool().GetVkMainCommandBuffer());
+  }
 
   // Materials
   // TODO: Fix this to get the file path directly from assimp importer
   std::unordered_map<MeshType, const char *> filenames = {{MeshType::kVertex, "../../models/swiggle_texture.png"}};
   int idx = 0;
+  texture_pool_.SetDebugName("Textures");
   VulkanTextureInput input = {.format = vk::Format::eR8G8B8A8Unorm};
   for (auto &kPair : filenames) {
     vk::DescriptorSet set = context.GetVulkanDescriptorPool().GetDescriptorSet(DescriptorPoolType::MESH)[idx];
-    auto *texture = new VulkanTexture(context, set, kPair.second, input);
+    Handle<VulkanTexture> texture = texture_pool_.Create(context, set, kPair.second, input);
     materials_.insert(std::make_pair(kPair.first, texture));
     idx++;
   }
 }
 
-void PrepareScene(vk::CommandBuffer command_buffer) {
+void PrepareScene(VulkanCommandRecorder &recorder) {
   vk::Buffer vertex_buffers[] = {vertex_buffer_collection->vertex_buffer_.buffer};
   vk::DeviceSize offsets[] = {0};
-  command_buffer.bindVertexBuffers(0, 1, vertex_buffers, offsets);
-  command_buffer.bindIndexBuffer(vertex_buffer_collection->index_buffer_.buffer, 0, vk::IndexType::eUint32);
+  recorder.BindVertexBuffers(0, 1, vertex_buffers, offsets);
+  recorder.BindIndexBuffer(vertex_buffer_collection->index_buffer_.buffer, 0, vk::IndexType::eUint32);
 }
 
 void PrepareFrame(uint32_t image_index, VulkanContext &context) {
+  GLACEON_PROFILE_FUNCTION();
   glm::vec3 eye = {1.0f, 0.0f, -1.0f};
   glm::vec3 center = {0.0f, 0.0f, 0.0f};
   glm::vec3 up = {0.0f, 0.0f, -1.0f};
@@ -192,22 +232,24 @@ void PrepareFrame(uint32_t image_index, VulkanContext &context) {
 /**
  * Renders requested number of MeshType objects.
  *
- * @param command_buffer The Vulkan command buffer to render the objects.
+ * @param recorder Records into the frame's command buffer and counts the draw.
  * @param mesh_type The type of mesh to render.
  * @param start_instance The starting instance for rendering.
  * @param instance_count The number of instances to render.
  */
-void RenderObjects(vk::CommandBuffer &command_buffer, MeshType mesh_type, uint32_t &start_instance, uint32_t instance_count) {
+void RenderObjects(VulkanCommandRecorder &recorder, MeshType mesh_type, uint32_t &start_instance, uint32_t instance_count) {
   // ------ Draw triangles ------
   int first_index = vertex_buffer_collection->first_indexes_.find(mesh_type)->second;
   int index_count = vertex_buffer_collection->index_counts_.find(mesh_type)->second;
   // we are attaching descriptor set for the mesh (which just has one binding, the combined image sampler)
-  materials_[mesh_type]->Use(command_buffer);
-  command_buffer.drawIndexed(index_count, instance_count, first_index, 0, start_instance);
+  texture_pool_.Get(materials_[mesh_type])->Use(recorder);
+  recorder.DrawIndexed(index_count, instance_count, first_index, 0, start_instance);
   start_instance += instance_count;
 }
 
 static void RecordDrawCommands(vk::CommandBuffer command_buffer, uint32_t image_index) {
+  GLACEON_PROFILE_FUNCTION();
+  FramePhaseScope phase_scope(FramePhase::kRecord);
   VulkanContext &context = currentApp->GetVulkanContext();
 
   vk::CommandBufferBeginInfo begin_info = {};
@@ -217,6 +259,12 @@ static void RecordDrawCommands(vk::CommandBuffer command_buffer, uint32_t image_
     return;
   }
 
+  VulkanGpuProfiler &gpu_profiler = context.GetVulkanGpuProfiler();
+  gpu_profiler.BeginFrame(command_buffer, image_index);
+  VulkanRenderStats &render_stats = context.GetVulkanRenderStats();
+  render_stats.BeginFrame(command_buffer, image_index);
+  VulkanCommandRecorder recorder = render_stats.GetRecorder(command_buffer);
+
   vk::RenderPassBeginInfo render_pass_info = {};
   render_pass_info.sType = vk::StructureType::eRenderPassBeginInfo;
   render_pass_info.renderPass = context.GetVulkanRenderPass().GetVkRenderPass();
@@ -230,37 +278,46 @@ static void RecordDrawCommands(vk::CommandBuffer command_buffer, uint32_t image_
   clear_value.color.float32[3] = 1.0f;
   vk::ClearValue depth_clear = vk::ClearDepthStencilValue(1.0f, 0);
 
-  std::vector<vk::ClearValue> clear_values = {clear_value, depth_clear};
+  FrameVector<vk::ClearValue> clear_values(frameArena.GetAllocator<vk::ClearValue>());
+  clear_values.reserve(2);
+  clear_values.push_back(clear_value);
+  clear_values.push_back(depth_clear);
   render_pass_info.clearValueCount = static_cast<uint32_t>(clear_values.size());
   render_pass_info.pClearValues = clear_values.data();
 
+  // closed in SubmitCommandBuffer() after the render pass ends
+  gpu_profiler.BeginScope(command_buffer, "RenderPass");
+  render_stats.BeginPipelineStatistics(command_buffer);
   command_buffer.beginRenderPass(&render_pass_info, vk::SubpassContents::eInline);
 
   vk::Pipeline pipeline = context.GetVulkanPipeline().GetVkPipeline();
 
   // frame descriptors have two bindings to describe the frame, the camera and the model vertex buffer
-  std::vector<vk::DescriptorSet> sets = {context.GetVulkanDescriptorPool().GetDescriptorSet(DescriptorPoolType::FRAME)};
-  command_buffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, context.GetVulkanPipeline().GetVkPipelineLayout(), 0,
-                                    static_cast<uint32_t>(sets.size()), sets.data(), 0, nullptr);
+  FrameVector<vk::DescriptorSet> sets(frameArena.GetAllocator<vk::DescriptorSet>());
+  sets.push_back(context.GetVulkanDescriptorPool().GetDescriptorSet(DescriptorPoolType::FRAME));
+  recorder.BindDescriptorSets(vk::PipelineBindPoint::eGraphics, context.GetVulkanPipeline().GetVkPipelineLayout(), 0,
+                              static_cast<uint32_t>(sets.size()), sets.data(), 0, nullptr);
   PrepareFrame(image_index, context);
 
   // Gets the vertex buffer data from TriangleMesh and pushes it as uniform data in anticipation for the vertex shader to use.
-  PrepareScene(command_buffer);
+  PrepareScene(recorder);
 
-  command_buffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline);
+  recorder.BindPipeline(vk::PipelineBindPoint::eGraphics, pipeline);
 
   uint32_t start_instance = 0;
   std::vector<glm::vec3> const &kTrianglePositions = currentApp->GetScene().triangle_positions_;
   std::vector<glm::vec3> const &kSquarePositions = currentApp->GetScene().square_positions_;
   std::vector<glm::vec3> const &kStarPositions = currentApp->GetScene().star_positions_;
 
-  std::vector<glm::vec3> const &kVertexPositions = currentApp->GetScene().vertex_positions;
-
-  RenderObjects(command_buffer, MeshType::kVertex, start_instance, static_cast<uint32_t>(kVertexPositions.size()));
+  {
+    GpuProfileScope draw_scope(gpu_profiler, command_buffer, "Draw");
+    // the model's triangles, drawn once
+    RenderObjects(recorder, MeshType::kVertex, start_instance, 1);
+  }
 
-  // RenderObjects(command_buffer, MeshType::TRIANGLE, start_instance, static_cast<uint32_t>(kTrianglePositions.size()));
-  // RenderObjects(command_buffer, MeshType::SQUARE, start_instance, static_cast<uint32_t>(kSquarePositions.size()));
-  // RenderObjects(command_buffer, MeshType::STAR, start_instance, static_cast<uint32_t>(kStarPositions.size()));
+  // RenderObjects(recorder, MeshType::TRIANGLE, start_instance, static_cast<uint32_t>(kTrianglePositions.size()));
+  // RenderObjects(recorder, MeshType::SQUARE, start_instance, static_cast<uint32_t>(kSquarePositions.size()));
+  // RenderObjects(recorder, MeshType::STAR, start_instance, static_cast<uint32_t>(kStarPositions.size()));
 }
 
 /**
@@ -269,11 +326,12 @@ static void RecordDrawCommands(vk::CommandBuffer command_buffer, uint32_t image_
  * @param context The Vulkan context containing necessary objects for rendering.
  */
 static void SetupRender(VulkanContext &context) {
-  std::vector<vk::Fence> in_flight_fences = context.GetVulkanSync().GetInFlightFences();
+  GLACEON_PROFILE_FUNCTION();
+  FramePhaseScope phase_scope(FramePhase::kAcquire);
+  const std::vector<vk::Fence> &in_flight_fences = context.GetVulkanSync().GetInFlightFences();
   vk::Device device = context.GetVulkanLogicalDevice();
   vk::SwapchainKHR swap_chain = context.GetVulkanSwapChain().GetVkSwapchain();
-  std::vector<vk::Semaphore> image_available_semaphores = context.GetVulkanSync().GetImageAvailableSemaphores();
-  std::vector<vk::Semaphore> render_complete_semaphores = context.GetVulkanSync().GetRenderFinishedSemaphores();
+  const std::vector<vk::Semaphore> &image_available_semaphores = context.GetVulkanSync().GetImageAvailableSemaphores();
 
   (void) device.waitForFences(1, &in_flight_fences[context.current_frame_index_], VK_TRUE, UINT64_MAX);
   // get image from swap chain
@@ -283,6 +341,11 @@ static void SetupRender(VulkanContext &context) {
   vk::Result res = device.acquireNextImageKHR(swap_chain, UINT64_MAX, image_available_semaphores[context.semaphore_index_], VK_NULL_HANDLE,
                                               &context.current_frame_index_);
 
+  // the acquired image can belong to a different frame than the one waited on above, make sure it is done as well
+  (void) device.waitForFences(1, &in_flight_fences[context.current_frame_index_], VK_TRUE, UINT64_MAX);
+  // the frame's fence has signaled, nothing allocated from its arena can still be in use
+  frameArena.BeginFrame(context.current_frame_index_);
+
   // reset the fence - "close the fence behind us"
   VK_CHECK(device.resetFences(1, &in_flight_fences[context.current_frame_index_]), "Failed to reset fences");
 
@@ -292,13 +355,15 @@ static void SetupRender(VulkanContext &context) {
   }
 
   // get the frame's own command buffer
-  std::vector<vk::CommandBuffer> frame_command_buffers = context.GetVulkanCommandPool().GetVkFrameCommandBuffers();
+  const std::vector<vk::CommandBuffer> &frame_command_buffers = context.GetVulkanCommandPool().GetVkFrameCommandBuffers();
   vk::CommandBuffer command_buffer = frame_command_buffers[context.current_frame_index_];
   command_buffer.reset();
 }
 
 static void FramePresent(VulkanContext &context) {
-  std::vector<vk::Semaphore> render_complete_semaphores = context.GetVulkanSync().GetRenderFinishedSemaphores();
+  GLACEON_PROFILE_FUNCTION();
+  FramePhaseScope phase_scope(FramePhase::kPresent);
+  const std::vector<vk::Semaphore> &render_complete_semaphores = context.GetVulkanSync().GetRenderFinishedSemaphores();
   vk::SwapchainKHR swap_chain = context.GetVulkanSwapChain().GetVkSwapchain();
   vk::Queue present_queue = context.GetVulkanDevice().GetVkPresentQueue();
 
@@ -327,14 +392,20 @@ static void FramePresent(VulkanContext &context) {
 }
 
 void SubmitCommandBuffer(VulkanContext &context) {
-  std::vector<vk::Fence> in_flight_fences = context.GetVulkanSync().GetInFlightFences();
+  GLACEON_PROFILE_FUNCTION();
+  FramePhaseScope phase_scope(FramePhase::kSubmit);
+  const std::vector<vk::Fence> &in_flight_fences = context.GetVulkanSync().GetInFlightFences();
   vk::Queue graphics_queue = context.GetVulkanDevice().GetVkGraphicsQueue();
-  std::vector<vk::Semaphore> image_available_semaphores = context.GetVulkanSync().GetImageAvailableSemaphores();
-  std::vector<vk::Semaphore> render_complete_semaphores = context.GetVulkanSync().GetRenderFinishedSemaphores();
+  const std::vector<vk::Semaphore> &image_available_semaphores = context.GetVulkanSync().GetImageAvailableSemaphores();
+  const std::vector<vk::Semaphore> &render_complete_semaphores = context.GetVulkanSync().GetRenderFinishedSemaphores();
 
   // current frame command buffer
   vk::CommandBuffer command_buffer = context.GetVulkanCommandPool().GetVkFrameCommandBuffers()[context.current_frame_index_];
   command_buffer.endRenderPass();
+  context.GetVulkanGpuProfiler().EndScope(command_buffer);// RenderPass
+  context.GetVulkanGpuProfiler().EndFrame(command_buffer);
+  context.GetVulkanRenderStats().EndPipelineStatistics(command_buffer);
+  context.GetVulkanRenderStats().EndFrame();
   command_buffer.end();
 
   // submit the command buffer
@@ -358,6 +429,87 @@ void SubmitCommandBuffer(VulkanContext &context) {
 //   GTRACE("WHOA, framebuffer resize callback");
 // }
 
+#if _DEBUG
+// windows that are always up in debug builds
+static void DrawDebugPanels(VulkanContext &context) {
+  //      bool show_demo = true;
+  //      ImGui::ShowDemoWindow(&show_demo);
+
+  ImGui::Begin("FPS");
+  const ImGuiIO &io = ImGui::GetIO();
+  ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / io.Framerate, io.Framerate);
+  const FrameStatsSummary frame_stats = FrameStats::GetSummary();
+  ImGui::Text("Hitches: %u in the last %u frames", frame_stats.window_hitches, frame_stats.num_frames);
+  if (ImGui::BeginTable("frame_stats", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+    ImGui::TableSetupColumn("ms");
+    ImGui::TableSetupColumn("p50");
+    ImGui::TableSetupColumn("p95");
+    ImGui::TableSetupColumn("p99");
+    ImGui::TableSetupColumn("max");
+    ImGui::TableHeadersRow();
+    auto draw_row = [](const char *name, const FrameTimeStats &stats) {
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn();
+      ImGui::TextUnformatted(name);
+      for (float value : {stats.p50, stats.p95, stats.p99, stats.max}) {
+        ImGui::TableNextColumn();
+        ImGui::Text("%.3f", value);
+      }
+    };
+    draw_row("Frame", frame_stats.frame);
+    for (uint32_t phase = 0; phase < kNumFramePhases; phase++) {
+      draw_row(FrameStats::GetPhaseName(static_cast<FramePhase>(phase)), frame_stats.phases[phase]);
+    }
+    ImGui::EndTable();
+  }
+
+  // GPU results lag a few frames behind, compare against the typical CPU frame rather than the last one
+  const VulkanGpuProfiler &gpu_profiler = context.GetVulkanGpuProfiler();
+  if (gpu_profiler.IsEnabled()) {
+    const float gpu_ms = gpu_profiler.GetFrameTime();
+    ImGui::Text("GPU %.3f ms, %s-bound", gpu_ms, gpu_ms > 0.9f * frame_stats.frame.p50 ? "GPU" : "CPU");
+    for (const GpuScopeResult &result : gpu_profiler.GetResults()) {
+      ImGui::Text("%*s%s: %.3f ms", static_cast<int>(2 * result.depth), "", result.name, result.milliseconds);
+    }
+  }
+
+  // counters cover the scene only, ImGui records its own draws straight into the command buffer
+  VulkanRenderStats &render_stats = context.GetVulkanRenderStats();
+  const DrawCounters &counters = render_stats.GetDrawCounters();
+  ImGui::Text("Draws %u, instances %u, triangles %llu", counters.draw_calls, counters.instances,
+              static_cast<unsigned long long>(counters.triangles));
+  ImGui::Text("Binds: pipeline %u, descriptor set %u, vertex buffer %u, index buffer %u", counters.pipeline_binds,
+              counters.descriptor_set_binds, counters.vertex_buffer_binds, counters.index_buffer_binds);
+  if (render_stats.IsPipelineStatisticsSupported()) {
+    bool pipeline_statistics = render_stats.IsPipelineStatisticsEnabled();
+    if (ImGui::Checkbox("Pipeline statistics", &pipeline_statistics)) { render_stats.SetPipelineStatisticsEnabled(pipeline_statistics); }
+    if (pipeline_statistics) {
+      // the whole render pass, ImGui included
+      const PipelineStatistics &statistics = render_stats.GetPipelineStatistics();
+      ImGui::Text("IA vertices %llu, primitives %llu", static_cast<unsigned long long>(statistics.input_assembly_vertices),
+                  static_cast<unsigned long long>(statistics.input_assembly_primitives));
+      ImGui::Text("VS invocations %llu", static_cast<unsigned long long>(statistics.vertex_shader_invocations));
+      ImGui::Text("Clipping in %llu, out %llu", static_cast<unsigned long long>(statistics.clipping_invocations),
+                  static_cast<unsigned long long>(statistics.clipping_primitives));
+      ImGui::Text("FS invocations %llu", static_cast<unsigned long long>(statistics.fragment_shader_invocations));
+    }
+  }
+  ImGui::End();
+
+  DrawMemoryPanel();
+
+  ImGui::Begin("Log");
+  for (size_t i = 0; i < kNumLogChannels; i++) {
+    const auto channel = static_cast<LogChannel>(i);
+    int level = Logger::GetLevel(channel);
+    if (ImGui::Combo(Logger::GetChannelName(channel), &level, "trace\0debug\0info\0warning\0error\0critical\0off\0")) {
+      Logger::SetLevel(channel, static_cast<spdlog::level::level_enum>(level));
+    }
+  }
+  ImGui::End();
+}
+#endif
+
 // ----------------- Application Class Functions ----------------------
 
 void GLACEON_API RunGame(Application *app) {
@@ -367,6 +519,7 @@ void GLACEON_API RunGame(Application *app) {
   }
 
   currentApp = app;
+  Profiler::SetThreadName("Main");
 
   if (!glfwInit()) {
     GTRACE("GLFW initialization failed");
@@ -489,6 +642,9 @@ void GLACEON_API RunGame(Application *app) {
   context.GetVulkanSwapChain().UpdateDescriptorResources();
   context.GetVulkanCommandPool().Initialize();
   context.GetVulkanSync().Initialize();
+  context.GetVulkanGpuProfiler().Initialize();
+  context.GetVulkanRenderStats().Initialize();
+  frameArena.Initialize(static_cast<uint32_t>(context.GetVulkanSwapChain().GetSwapChainFrames().size()), kFrameArenaSize);
 
   GraphicsPipelineConfig config = {
       .vertex_shader_file = "../../shaders/vert.spv",
@@ -500,9 +656,7 @@ void GLACEON_API RunGame(Application *app) {
   int w, h;
   glfwGetFramebufferSize(glfw_window, &w, &h);
 
-#if _DEBUG
   ImGuiInitialize(context, glfw_window);
-#endif
 
   int width, height;
   ImGuiIO &io = ImGui::GetIO();
@@ -512,9 +666,12 @@ void GLACEON_API RunGame(Application *app) {
   MakeAssets(context);
 
   // ----------------------------- MAIN LOOP ----------------------------- //
-  while (!glfwWindowShouldClose(glfw_window)) {
+  while (!glfwWindowShouldClose(glfw_window) && !app->IsShutdownRequested()) {
     glfwPollEvents();
-    app->OnUpdate();
+    {
+      GLACEON_PROFILE_SCOPE("OnUpdate");
+      app->OnUpdate();
+    }
 
     glfwGetFramebufferSize(glfw_window, &width, &height);
 
@@ -527,7 +684,11 @@ void GLACEON_API RunGame(Application *app) {
         context.GetVulkanPipeline().Rebuild();
         context.GetVulkanCommandPool().RebuildCommandBuffers();
         context.GetVulkanSync().Rebuild();
+        context.GetVulkanGpuProfiler().Rebuild();
+        context.GetVulkanRenderStats().Rebuild();
+        frameArena.Initialize(static_cast<uint32_t>(context.GetVulkanSwapChain().GetSwapChainFrames().size()), kFrameArenaSize);
         context.current_frame_index_ = 0;
+        FrameStats::RestartWarmup();
       }
       swapChainRebuild = false;
     }
@@ -538,54 +699,70 @@ void GLACEON_API RunGame(Application *app) {
     SetupRender(context);
     RecordDrawCommands(context.GetVulkanCommandPool().GetVkFrameCommandBuffers()[context.current_frame_index_], context.current_frame_index_);
 
-#if _DEBUG
-    // ------------------ Render ImGui Frame ------------------ //
-    ImGui_ImplGlfw_NewFrame();
-    ImGui::NewFrame();
+    // debug builds always show their panels; otherwise ImGui only runs, and records draws, while the HUD is up
+    if (kShowDebugPanels || PerformanceHud::IsVisible()) {
+      ImGui_ImplGlfw_NewFrame();
+      ImGui::NewFrame();
 
-    {
-      //      bool show_demo = true;
-      //      ImGui::ShowDemoWindow(&show_demo);
+      {
+        GLACEON_PROFILE_SCOPE("ImGui Panels");
+#if _DEBUG
+        DrawDebugPanels(context);
+#endif
+        if (PerformanceHud::IsVisible()) { PerformanceHud::Draw(context); }
+      }
 
-      ImGui::Begin("FPS");
-      ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / io.Framerate, io.Framerate);
-      ImGui::End();
-    }
+      ImGui::Render();
 
-    // Rendering
-    ImGui::Render();
+      // needed for multi-port support
+      if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable) {
+        ImGui::UpdatePlatformWindows();
+        ImGui::RenderPlatformWindowsDefault();
+        // FIXME: moving imgui windows outside glfw window causes validation errors related to render pass (vkCmdDrawIndexed())
+      }
 
-    // needed for multi-port support
-    if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable) {
-      ImGui::UpdatePlatformWindows();
-      ImGui::RenderPlatformWindowsDefault();
-      // FIXME: moving imgui windows outside glfw window causes validation errors related to render pass (vkCmdDrawIndexed())
+      ImDrawData *draw_data = ImGui::GetDrawData();
+      vk::CommandBuffer command_buffer = context.GetVulkanCommandPool().GetVkFrameCommandBuffers()[context.current_frame_index_];
+      GpuProfileScope imgui_scope(context.GetVulkanGpuProfiler(), command_buffer, "ImGui");
+      ImGui_ImplVulkan_RenderDrawData(draw_data, command_buffer);
     }
 
-    ImDrawData *draw_data = ImGui::GetDrawData();
-    ImGui_ImplVulkan_RenderDrawData(draw_data, context.GetVulkanCommandPool().GetVkFrameCommandBuffers()[context.current_frame_index_]);
-#endif
-
     SubmitCommandBuffer(context);
     FramePresent(context);
+    context.GetVulkanMemoryAllocator().EndFrame();
+    AllocatorRegistry::EndFrame();
+    FrameStats::EndFrame();
+    Profiler::EndFrame();
   }
 
   context.GetVulkanLogicalDevice().waitIdle();
+  // write out a capture that was still running when the window closed
+  Profiler::EndSession();
 
-#if _DEBUG
   ImGui_ImplVulkan_Shutdown();
   ImGui_ImplGlfw_Shutdown();
   ImGui::DestroyContext();
-#endif
+
+  GINFO("FrameArena: peak {} of {} bytes per frame, {} allocations spilled to the heap", frameArena.GetPeakUsedMemory(),
+        frameArena.GetBytesPerFrame(), frameArena.GetTotalSpills());
+  AllocatorRegistry::PrintStats();
+  FrameStats::PrintStats();
+  FrameStats::WriteCsv("frame_stats.csv");
+  context.GetVulkanMemoryAllocator().WriteStatsJson("vma_stats.json");
+  frameArena.Destroy();
 
   delete vertex_buffer_collection;
-  for (auto &[_, texture] : materials_) { delete texture; }
+  texture_pool_.Clear();
+  materials_.clear();
 
   context.Destroy();
 
   glfwDestroyWindow(glfw_window);
   glfwTerminate();
   app->OnShutdown();
+  ThreadPool::Shutdown();
+  DeferredLog::Stop();
+  Logger::Shutdown();
 }
 
 }// namespace glaceon
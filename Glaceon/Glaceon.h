@@ -3,6 +3,7 @@
 
 #include "Application.h"
 #include "Core/Base.h"
+#include "Core/Memory/ObjectPool.h"
 #include "VertexBufferCollection.h"
 #include "VulkanRenderer/VulkanTexture.h"
 #include "pch.h"
@@ -12,7 +13,8 @@ namespace glaceon {
 void GLACEON_API RunGame(Application *app);
 
 VertexBufferCollection *vertex_buffer_collection = nullptr;
-std::unordered_map<MeshType, VulkanTexture *> materials_;
+ObjectPool<VulkanTexture> texture_pool_;
+std::unordered_map<MeshType, Handle<VulkanTexture>> materials_;
 
 }// namespace glaceon
 #endif// GLACEON_GLACEON_GLACEON_H_
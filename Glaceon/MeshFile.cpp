@@ -0,0 +1,247 @@
+#include "MeshFile.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <utility>
+
+#include "Core/Logger.h"
+#include "Profiler/InstrumentationTimer.h"
+
+namespace glaceon {
+
+static_assert(std::endian::native == std::endian::little, "mesh files are little endian");
+static_assert(sizeof(glm::vec3) == 12 && sizeof(glm::vec2) == 8 && sizeof(glm::vec4) == 16, "streams are tightly packed");
+static_assert(sizeof(MeshFileSubmesh) == 20, "MeshFileSubmesh is written as is");
+
+static uint64_t AlignUpTo(uint64_t value, uint64_t alignment) { return (value + alignment - 1) & ~(alignment - 1); }
+
+// Checks what the section sizes cannot tell: every index lies below vertex_count, every submesh within the vertices and
+// indices, and every submesh's indices within its own vertices.  Both the writer and MeshFile::Open() run it, so users
+// of a mesh file can take its indices as they are.
+static bool ValidateIndices(const std::string &file_path, std::span<const uint32_t> indices, std::span<const MeshFileSubmesh> submeshes,
+                            uint64_t vertex_count) {
+  for (const uint32_t index : indices) {
+    if (index >= vertex_count) {
+      GERROR_CH(Assets, "{}: index {} of {} vertices", file_path, index, vertex_count);
+      return false;
+    }
+  }
+  for (const MeshFileSubmesh &submesh : submeshes) {
+    if (uint64_t{submesh.first_vertex} + submesh.vertex_count > vertex_count
+        || uint64_t{submesh.first_index} + submesh.index_count > indices.size()) {
+      GERROR_CH(Assets, "{}: submesh outside its {} vertices and {} indices", file_path, vertex_count, indices.size());
+      return false;
+    }
+    for (const uint32_t index : indices.subspan(submesh.first_index, submesh.index_count)) {
+      if (index < submesh.first_vertex || index - submesh.first_vertex >= submesh.vertex_count) {
+        GERROR_CH(Assets, "{}: index {} outside its submesh's vertices [{}, {})", file_path, index, submesh.first_vertex,
+                  uint64_t{submesh.first_vertex} + submesh.vertex_count);
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// -------------------------- WRITING --------------------------
+
+static bool ValidateMeshFileData(const std::string &file_path, const MeshFileData &data) {
+  const size_t vertex_count = data.positions.size();
+  if (vertex_count == 0) {
+    GERROR_CH(Assets, "Cannot write a mesh file without vertices");
+    return false;
+  }
+  if (vertex_count > std::numeric_limits<uint32_t>::max() || data.indices.size() > std::numeric_limits<uint32_t>::max()) {
+    GERROR_CH(Assets, "Cannot write a mesh file of {} vertices and {} indices, 32-bit counts only", vertex_count, data.indices.size());
+    return false;
+  }
+  if ((!data.normals.empty() && data.normals.size() != vertex_count) || (!data.uvs.empty() && data.uvs.size() != vertex_count)
+      || (!data.tangents.empty() && data.tangents.size() != vertex_count)) {
+    GERROR_CH(Assets, "Cannot write a mesh file with a vertex stream of another length than the {} positions", vertex_count);
+    return false;
+  }
+  if (data.indices.size() % 3 != 0) {
+    GERROR_CH(Assets, "Cannot write a mesh file of {} indices, not a triangle list", data.indices.size());
+    return false;
+  }
+  return ValidateIndices(file_path, data.indices, data.submeshes, vertex_count);
+}
+
+template<typename T>
+static MeshFileSection PlaceSection(std::span<const T> stream, uint64_t &offset) {
+  if (stream.empty()) { return {}; }
+  const MeshFileSection section = {.offset = offset, .size = stream.size_bytes()};
+  offset = AlignUpTo(offset + section.size, kMeshFileAlignment);
+  return section;
+}
+
+template<typename T>
+static void WriteSection(std::ofstream &file, const MeshFileSection &section, std::span<const T> stream) {
+  if (section.size == 0) { return; }
+  static constexpr char kPadding[kMeshFileAlignment] = {};
+  file.write(kPadding, static_cast<std::streamsize>(section.offset - static_cast<uint64_t>(file.tellp())));
+  file.write(reinterpret_cast<const char *>(stream.data()), static_cast<std::streamsize>(section.size));
+}
+
+/**
+ * @brief Lays the streams out after a MeshFileHeader, each aligned to kMeshFileAlignment, and writes them to file_path.
+ *
+ * @param file_path Where to write the mesh file, an existing file is replaced.
+ * @param data Streams to write; every index has to lie within its submesh's vertices, see ValidateIndices().
+ * @return false if data is inconsistent or the file cannot be written.
+ */
+bool WriteMeshFile(const std::string &file_path, const MeshFileData &data) {
+  GLACEON_PROFILE_FUNCTION();
+  if (!ValidateMeshFileData(file_path, data)) { return false; }
+
+  MeshFileHeader header = {};
+  std::memcpy(header.magic, kMeshFileMagic, sizeof(header.magic));
+  header.version = kMeshFileVersion;
+  header.header_size = sizeof(MeshFileHeader);
+  header.vertex_count = static_cast<uint32_t>(data.positions.size());
+  header.index_count = static_cast<uint32_t>(data.indices.size());
+  header.submesh_count = static_cast<uint32_t>(data.submeshes.size());
+
+  uint64_t offset = AlignUpTo(sizeof(MeshFileHeader), kMeshFileAlignment);
+  header.submeshes = PlaceSection(data.submeshes, offset);
+  header.positions = PlaceSection(data.positions, offset);
+  header.normals = PlaceSection(data.normals, offset);
+  header.uvs = PlaceSection(data.uvs, offset);
+  header.tangents = PlaceSection(data.tangents, offset);
+  header.indices = PlaceSection(data.indices, offset);
+  header.file_size = 0;
+  for (const MeshFileSection &section : {header.submeshes, header.positions, header.normals, header.uvs, header.tangents, header.indices}) {
+    header.file_size = std::max(header.file_size, section.offset + section.size);
+  }
+
+  // unique, another process may be writing the same file, e.g. to the import cache
+  const std::string temp_path = fmt::format("{}.{:08x}.tmp", file_path, std::random_device()());
+  {
+    std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+      GERROR_CH(Assets, "Cannot open {} for writing", temp_path);
+      return false;
+    }
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    WriteSection(file, header.submeshes, data.submeshes);
+    WriteSection(file, header.positions, data.positions);
+    WriteSection(file, header.normals, data.normals);
+    WriteSection(file, header.uvs, data.uvs);
+    WriteSection(file, header.tangents, data.tangents);
+    WriteSection(file, header.indices, data.indices);
+    file.close();
+    if (!file) {
+      GERROR_CH(Assets, "Failed to write {}", temp_path);
+      std::filesystem::remove(temp_path);
+      return false;
+    }
+  }
+
+  std::error_code error;
+  std::filesystem::rename(temp_path, file_path, error);
+  if (error) {
+    GERROR_CH(Assets, "Cannot replace {} - {}", file_path, error.message());
+    std::filesystem::remove(temp_path, error);
+    return false;
+  }
+  return true;
+}
+
+// -------------------------- READING --------------------------
+
+MeshFile::MeshFile(MeshFile &&other) noexcept : file_(std::move(other.file_)), header_(std::exchange(other.header_, nullptr)) {}
+
+MeshFile &MeshFile::operator=(MeshFile &&other) noexcept {
+  if (this != &other) {
+    file_ = std::move(other.file_);
+    header_ = std::exchange(other.header_, nullptr);
+  }
+  return *this;
+}
+
+// the section lies in the file and holds exactly count elements of element_size, or is empty when that is allowed
+static bool IsValidSection(const MeshFileHeader &header, const MeshFileSection &section, uint64_t count, uint64_t element_size,
+                           bool optional) {
+  if (section.size == 0) { return optional || count == 0; }
+  return section.offset % kMeshFileAlignment == 0 && section.offset >= header.header_size && section.offset <= header.file_size
+      && section.size <= header.file_size - section.offset && section.size == count * element_size;
+}
+
+/**
+ * @brief Maps a cooked mesh, checks that its header describes the file and that its indices stay within their
+ * submeshes' vertices.  The indices are the only stream it reads.
+ *
+ * @param file_path Path to a .gmesh written by WriteMeshFile().
+ * @return false if the file cannot be mapped, is not a mesh file, is of another version, is truncated or has an index
+ * out of range.
+ */
+bool MeshFile::Open(const std::string &file_path) {
+  GLACEON_PROFILE_FUNCTION();
+  Close();
+  if (!file_.Open(file_path)) { return false; }
+
+  if (file_.GetSize() < sizeof(MeshFileHeader)) {
+    GERROR_CH(Assets, "{} is not a mesh file", file_path);
+    file_.Close();
+    return false;
+  }
+  const auto *header = reinterpret_cast<const MeshFileHeader *>(file_.GetData());
+  if (std::memcmp(header->magic, kMeshFileMagic, sizeof(kMeshFileMagic)) != 0 || header->header_size != sizeof(MeshFileHeader)) {
+    GERROR_CH(Assets, "{} is not a mesh file", file_path);
+    file_.Close();
+    return false;
+  }
+  if (header->version != kMeshFileVersion) {
+    GERROR_CH(Assets, "{} is a version {} mesh file, cook it again for version {}", file_path, header->version, kMeshFileVersion);
+    file_.Close();
+    return false;
+  }
+
+  const bool valid = header->file_size == file_.GetSize() && header->vertex_count > 0 && header->index_count % 3 == 0
+      && IsValidSection(*header, header->submeshes, header->submesh_count, sizeof(MeshFileSubmesh), false)
+      && IsValidSection(*header, header->positions, header->vertex_count, sizeof(glm::vec3), false)
+      && IsValidSection(*header, header->normals, header->vertex_count, sizeof(glm::vec3), true)
+      && IsValidSection(*header, header->uvs, header->vertex_count, sizeof(glm::vec2), true)
+      && IsValidSection(*header, header->tangents, header->vertex_count, sizeof(glm::vec4), true)
+      && IsValidSection(*header, header->indices, header->index_count, sizeof(uint32_t), false);
+  if (!valid) {
+    GERROR_CH(Assets, "{} is truncated or damaged, cook it again", file_path);
+    file_.Close();
+    return false;
+  }
+
+  header_ = header;
+  if (!ValidateIndices(file_path, GetIndices(), GetSubmeshes(), header_->vertex_count)) {
+    Close();
+    return false;
+  }
+  GDEBUG_CH(Assets, "Mapped {}: {} vertices, {} indices, {} submeshes", file_path, header_->vertex_count, header_->index_count,
+            header_->submesh_count);
+  return true;
+}
+
+void MeshFile::Close() {
+  header_ = nullptr;
+  file_.Close();
+}
+
+template<typename T>
+std::span<const T> MeshFile::GetSection(const MeshFileSection MeshFileHeader::*section) const {
+  if (header_ == nullptr || (header_->*section).size == 0) { return {}; }
+  const MeshFileSection &placed = header_->*section;
+  return {reinterpret_cast<const T *>(file_.GetData() + placed.offset), placed.size / sizeof(T)};
+}
+
+std::span<const glm::vec3> MeshFile::GetPositions() const { return GetSection<glm::vec3>(&MeshFileHeader::positions); }
+std::span<const glm::vec3> MeshFile::GetNormals() const { return GetSection<glm::vec3>(&MeshFileHeader::normals); }
+std::span<const glm::vec2> MeshFile::GetUvs() const { return GetSection<glm::vec2>(&MeshFileHeader::uvs); }
+std::span<const glm::vec4> MeshFile::GetTangents() const { return GetSection<glm::vec4>(&MeshFileHeader::tangents); }
+std::span<const uint32_t> MeshFile::GetIndices() const { return GetSection<uint32_t>(&MeshFileHeader::indices); }
+std::span<const MeshFileSubmesh> MeshFile::GetSubmeshes() const { return GetSection<MeshFileSubmesh>(&MeshFileHeader::submeshes); }
+
+}// namespace glaceon
@@ -0,0 +1,103 @@
+#ifndef GLACEON_GLACEON_MESHFILE_H_
+#define GLACEON_GLACEON_MESHFILE_H_
+
+#include <cstdint>
+#include <span>
+#include <string>
+
+#include <glm/glm.hpp>
+
+#include "Core/Base.h"
+#include "Core/MappedFile.h"
+
+namespace glaceon {
+
+// Cooked mesh files (.gmesh), written offline by GlaceonMeshCooker or by the AssimpImporter's import cache from anything
+// assimp reads, so the engine does not run the importer at startup.  Little endian:
+//
+//  MeshFileHeader
+//  sections, each starting on a kMeshFileAlignment boundary: submeshes, positions, normals, uvs, tangents, indices
+//
+// The streams are laid out exactly as they are uploaded, so a loaded file is used in place through the mapping.
+// Bump kMeshFileVersion on any change to the layout; files of another version are refused and have to be cooked again.
+inline constexpr char kMeshFileMagic[4] = {'G', 'M', 'S', 'H'};
+inline constexpr uint32_t kMeshFileVersion = 1;
+inline constexpr uint64_t kMeshFileAlignment = 64;
+
+// bytes from the start of the file
+struct MeshFileSection {
+  uint64_t offset = 0;
+  uint64_t size = 0;
+};
+
+struct MeshFileSubmesh {
+  uint32_t first_vertex = 0;
+  uint32_t vertex_count = 0;
+  uint32_t first_index = 0;
+  uint32_t index_count = 0;
+  uint32_t material_index = 0;
+};
+
+struct MeshFileHeader {
+  char magic[4];
+  uint32_t version;
+  uint32_t header_size;
+  uint32_t vertex_count;
+  uint32_t index_count;
+  uint32_t submesh_count;
+  uint64_t file_size;
+  MeshFileSection submeshes;// MeshFileSubmesh
+  MeshFileSection positions;// glm::vec3
+  MeshFileSection normals;  // glm::vec3, the optional streams are either empty or have one entry per vertex
+  MeshFileSection uvs;      // glm::vec2
+  MeshFileSection tangents; // glm::vec4, w is the handedness of the bitangent
+  MeshFileSection indices;  // uint32_t triangle lists, into the whole vertex range but within their submesh's vertices
+};
+static_assert(sizeof(MeshFileHeader) == 128, "MeshFileHeader is written as is");
+
+// What WriteMeshFile() lays out, same conventions as MeshFileHeader
+struct MeshFileData {
+  std::span<const glm::vec3> positions;
+  std::span<const glm::vec3> normals;
+  std::span<const glm::vec2> uvs;
+  std::span<const glm::vec4> tangents;
+  std::span<const uint32_t> indices;
+  std::span<const MeshFileSubmesh> submeshes;
+};
+
+// Checks data and writes it to file_path, through a temporary file so a failed write never leaves half a file behind
+bool GLACEON_API WriteMeshFile(const std::string &file_path, const MeshFileData &data);
+
+// A cooked mesh mapped read-only.  Opening checks the header and the indices, the streams point into the mapping and
+// are valid until Close() or the MeshFile goes away.
+class GLACEON_API MeshFile {
+ public:
+  MeshFile() = default;
+  MeshFile(MeshFile &&other) noexcept;
+  MeshFile &operator=(MeshFile &&other) noexcept;
+
+  // false (and logged) if the file is missing, truncated, of another version or indexes outside its vertices
+  bool Open(const std::string &file_path);
+  void Close();
+
+  [[nodiscard]] bool IsOpen() const { return header_ != nullptr; }
+  [[nodiscard]] uint32_t GetVertexCount() const { return header_ != nullptr ? header_->vertex_count : 0; }
+
+  [[nodiscard]] std::span<const glm::vec3> GetPositions() const;
+  [[nodiscard]] std::span<const glm::vec3> GetNormals() const;
+  [[nodiscard]] std::span<const glm::vec2> GetUvs() const;
+  [[nodiscard]] std::span<const glm::vec4> GetTangents() const;
+  [[nodiscard]] std::span<const uint32_t> GetIndices() const;
+  [[nodiscard]] std::span<const MeshFileSubmesh> GetSubmeshes() const;
+
+ private:
+  template<typename T>
+  std::span<const T> GetSection(const MeshFileSection MeshFileHeader::*section) const;
+
+  MappedFile file_;
+  const MeshFileHeader *header_ = nullptr;
+};
+
+}// namespace glaceon
+
+#endif// GLACEON_GLACEON_MESHFILE_H_
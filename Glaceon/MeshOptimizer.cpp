@@ -0,0 +1,242 @@
+#include "MeshOptimizer.h"
+
+#include "Profiler/InstrumentationTimer.h"
+
+namespace glaceon {
+
+// FIFO cache of vertex indices.  A vertex is cached while fewer than cache_size misses happened since its own, so a
+// miss costs one timestamp write and nothing is ever evicted explicitly.
+class FifoVertexCache {
+ public:
+  FifoVertexCache(size_t vertex_count, uint32_t cache_size) : timestamps_(vertex_count, 0), cache_size_(cache_size), time_(cache_size + 1) {}
+
+  // true on a miss, which puts the vertex in the cache
+  bool Access(uint32_t vertex) {
+    if (time_ - timestamps_[vertex] <= cache_size_) { return false; }
+    timestamps_[vertex] = time_++;
+    return true;
+  }
+
+  uint32_t AccessTriangle(const uint32_t *triangle) { return Access(triangle[0]) + Access(triangle[1]) + Access(triangle[2]); }
+
+  // ages every vertex out
+  void Clear() { time_ += cache_size_ + 1; }
+
+ private:
+  std::vector<uint32_t> timestamps_;
+  uint32_t cache_size_;
+  uint32_t time_;
+};
+
+VertexCacheStats AnalyzeVertexCache(std::span<const uint32_t> indices, size_t vertex_count, uint32_t cache_size) {
+  VertexCacheStats stats;
+  stats.triangles = static_cast<uint32_t>(indices.size() / 3);
+
+  FifoVertexCache cache(vertex_count, cache_size);
+  std::vector<bool> referenced(vertex_count, false);
+  for (size_t i = 0; i < 3 * static_cast<size_t>(stats.triangles); i++) {
+    if (cache.Access(indices[i])) { stats.vertices_transformed++; }
+    if (!referenced[indices[i]]) {
+      referenced[indices[i]] = true;
+      stats.vertices_referenced++;
+    }
+  }
+
+  if (stats.triangles > 0) { stats.acmr = static_cast<float>(stats.vertices_transformed) / static_cast<float>(stats.triangles); }
+  if (stats.vertices_referenced > 0) {
+    stats.atvr = static_cast<float>(stats.vertices_transformed) / static_cast<float>(stats.vertices_referenced);
+  }
+  return stats;
+}
+
+/**
+ * @brief Tipsify (Sander, Nehab and Barczak, "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw").
+ *
+ * Emits every remaining triangle around a fanning vertex, then fans around the vertex just emitted that will still be
+ * in the cache after its own remaining triangles are emitted and entered it earliest.  When no such vertex is left it
+ * backtracks through a stack of recently emitted vertices, and past that walks the vertices in order.
+ *
+ * @param indices Triangle list, reordered in place.
+ * @param vertex_count One past the highest index.
+ * @param cache_size Entries of the FIFO cache to optimize for.
+ */
+void OptimizeVertexCache(std::span<uint32_t> indices, size_t vertex_count, uint32_t cache_size) {
+  GLACEON_PROFILE_FUNCTION();
+  const size_t triangle_count = indices.size() / 3;
+  if (triangle_count == 0) { return; }
+
+  // triangles around every vertex, packed: those of vertex v are adjacency[first_triangle[v] .. first_triangle[v + 1])
+  std::vector<uint32_t> live_triangles(vertex_count, 0);
+  for (size_t i = 0; i < 3 * triangle_count; i++) { live_triangles[indices[i]]++; }
+  std::vector<uint32_t> first_triangle(vertex_count + 1, 0);
+  for (size_t v = 0; v < vertex_count; v++) { first_triangle[v + 1] = first_triangle[v] + live_triangles[v]; }
+  std::vector<uint32_t> adjacency(3 * triangle_count);
+  std::vector<uint32_t> fill(first_triangle.begin(), first_triangle.end() - 1);
+  for (size_t i = 0; i < 3 * triangle_count; i++) { adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3); }
+
+  std::vector<uint32_t> timestamps(vertex_count, 0);
+  uint32_t time = cache_size + 1;
+  std::vector<bool> emitted(triangle_count, false);
+  std::vector<uint32_t> dead_ends;
+  std::vector<uint32_t> candidates;
+  std::vector<uint32_t> ordered;
+  ordered.reserve(3 * triangle_count);
+  size_t next_unvisited = 0;
+
+  const auto skip_dead_end = [&]() -> int64_t {
+    while (!dead_ends.empty()) {
+      const uint32_t vertex = dead_ends.back();
+      dead_ends.pop_back();
+      if (live_triangles[vertex] > 0) { return vertex; }
+    }
+    for (; next_unvisited < vertex_count; next_unvisited++) {
+      if (live_triangles[next_unvisited] > 0) { return static_cast<int64_t>(next_unvisited); }
+    }
+    return -1;
+  };
+
+  for (int64_t fan = skip_dead_end(); fan >= 0;) {
+    candidates.clear();
+    for (uint32_t a = first_triangle[fan]; a < first_triangle[fan + 1]; a++) {
+      const uint32_t triangle = adjacency[a];
+      if (emitted[triangle]) { continue; }
+      emitted[triangle] = true;
+      for (size_t k = 0; k < 3; k++) {
+        const uint32_t vertex = indices[3 * triangle + k];
+        ordered.push_back(vertex);
+        dead_ends.push_back(vertex);
+        candidates.push_back(vertex);
+        live_triangles[vertex]--;
+        if (time - timestamps[vertex] > cache_size) { timestamps[vertex] = time++; }
+      }
+    }
+
+    int64_t next = -1;
+    int64_t best_priority = -1;
+    for (const uint32_t vertex : candidates) {
+      if (live_triangles[vertex] == 0) { continue; }
+      // each remaining triangle misses on at most 2 more vertices, it has to stay in the cache through those
+      const int64_t age = time - timestamps[vertex];
+      const int64_t priority = age + 2 * static_cast<int64_t>(live_triangles[vertex]) <= cache_size ? age : 0;
+      if (priority > best_priority) {
+        best_priority = priority;
+        next = vertex;
+      }
+    }
+    fan = next >= 0 ? next : skip_dead_end();
+  }
+
+  std::copy(ordered.begin(), ordered.end(), indices.begin());
+}
+
+/**
+ * @brief Sorts clusters of the cache order by how likely they are to occlude the rest of the mesh, view independently.
+ *
+ * A cluster's key is the distance of its area weighted centroid from the mesh's along its average normal, so clusters
+ * on the outside facing away from the middle, the ones seen from most directions, are drawn first.
+ *
+ * @param indices Cache optimized triangle list, its clusters reordered in place.
+ * @param positions Vertex positions the indices refer to.
+ * @param threshold How much worse than the whole list's ACMR a cluster may be from a cold cache.
+ * @param cache_size Entries of the FIFO cache the list was optimized for.
+ */
+void OptimizeOverdraw(std::span<uint32_t> indices, std::span<const glm::vec3> positions, float threshold, uint32_t cache_size) {
+  GLACEON_PROFILE_FUNCTION();
+  const size_t triangle_count = indices.size() / 3;
+  if (triangle_count < 2) { return; }
+
+  // where the cache order started over, every vertex of the triangle missed
+  FifoVertexCache cache(positions.size(), cache_size);
+  std::vector<uint8_t> misses(triangle_count);
+  uint64_t total_misses = 0;
+  for (size_t t = 0; t < triangle_count; t++) {
+    misses[t] = static_cast<uint8_t>(cache.AccessTriangle(&indices[3 * t]));
+    total_misses += misses[t];
+  }
+  const float limit = threshold * static_cast<float>(total_misses) / static_cast<float>(triangle_count);
+
+  std::vector<uint32_t> cluster_starts;
+  for (size_t hard_start = 0; hard_start < triangle_count;) {
+    size_t hard_end = hard_start + 1;
+    while (hard_end < triangle_count && misses[hard_end] != 3) { hard_end++; }
+
+    size_t start = hard_start;
+    uint32_t cluster_misses = 0;
+    cluster_starts.push_back(static_cast<uint32_t>(start));
+    cache.Clear();
+    for (size_t t = hard_start; t + 1 < hard_end; t++) {
+      cluster_misses += cache.AccessTriangle(&indices[3 * t]);
+      if (static_cast<float>(cluster_misses) <= limit * static_cast<float>(t + 1 - start)) {
+        start = t + 1;
+        cluster_starts.push_back(static_cast<uint32_t>(start));
+        cluster_misses = 0;
+        cache.Clear();
+      }
+    }
+    hard_start = hard_end;
+  }
+  cluster_starts.push_back(static_cast<uint32_t>(triangle_count));
+  const size_t cluster_count = cluster_starts.size() - 1;
+  if (cluster_count < 2) { return; }
+
+  struct Cluster {
+    glm::vec3 centroid = glm::vec3(0.0f);// area weighted sum until divided
+    glm::vec3 normal = glm::vec3(0.0f);  // sum of the triangles' cross products, so area weighted too
+    float area = 0.0f;
+    float key = 0.0f;
+  };
+  std::vector<Cluster> clusters(cluster_count);
+  glm::vec3 mesh_centroid(0.0f);
+  float mesh_area = 0.0f;
+  for (size_t c = 0; c < cluster_count; c++) {
+    Cluster &cluster = clusters[c];
+    for (size_t t = cluster_starts[c]; t < cluster_starts[c + 1]; t++) {
+      const glm::vec3 &p0 = positions[indices[3 * t]];
+      const glm::vec3 &p1 = positions[indices[3 * t + 1]];
+      const glm::vec3 &p2 = positions[indices[3 * t + 2]];
+      const glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+      const float area = glm::length(normal);
+      cluster.centroid += (p0 + p1 + p2) * (area / 3.0f);
+      cluster.normal += normal;
+      cluster.area += area;
+    }
+    mesh_centroid += cluster.centroid;
+    mesh_area += cluster.area;
+  }
+  if (mesh_area > 0.0f) { mesh_centroid /= mesh_area; }
+
+  for (Cluster &cluster : clusters) {
+    const float normal_length = glm::length(cluster.normal);
+    if (cluster.area > 0.0f && normal_length > 0.0f) {
+      cluster.key = glm::dot(cluster.centroid / cluster.area - mesh_centroid, cluster.normal / normal_length);
+    }
+  }
+
+  std::vector<uint32_t> order(cluster_count);
+  for (uint32_t c = 0; c < cluster_count; c++) { order[c] = c; }
+  std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return clusters[a].key > clusters[b].key; });
+
+  std::vector<uint32_t> sorted;
+  sorted.reserve(3 * triangle_count);
+  for (const uint32_t c : order) {
+    sorted.insert(sorted.end(), indices.begin() + 3 * cluster_starts[c], indices.begin() + 3 * cluster_starts[c + 1]);
+  }
+  std::copy(sorted.begin(), sorted.end(), indices.begin());
+}
+
+std::vector<uint32_t> OptimizeVertexFetch(std::span<uint32_t> indices, size_t vertex_count) {
+  GLACEON_PROFILE_FUNCTION();
+  constexpr uint32_t kUnused = UINT32_MAX;
+  std::vector<uint32_t> remap(vertex_count, kUnused);
+  uint32_t next = 0;
+  for (uint32_t &index : indices) {
+    if (remap[index] == kUnused) { remap[index] = next++; }
+    index = remap[index];
+  }
+  for (uint32_t &new_index : remap) {
+    if (new_index == kUnused) { new_index = next++; }
+  }
+  return remap;
+}
+
+}// namespace glaceon
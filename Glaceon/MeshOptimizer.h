@@ -0,0 +1,60 @@
+#ifndef GLACEON_GLACEON_MESHOPTIMIZER_H_
+#define GLACEON_GLACEON_MESHOPTIMIZER_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Core/Base.h"
+
+namespace glaceon {
+
+// Reorders indexed triangle lists for the GPU, run on meshes as they are imported:
+//  1. OptimizeVertexCache()  triangles in an order that reuses recently transformed vertices (Tipsify)
+//  2. OptimizeOverdraw()     clusters of that order sorted so likely occluders are drawn first, within a bound on
+//                            how much of the cache reuse it gives up
+//  3. OptimizeVertexFetch()  vertices renumbered in order of first use, so vertex fetches walk memory forward
+// Every step only reorders, the triangles and their winding stay the same.
+
+// FIFO post-transform cache the triangle order is tuned for and measured against
+inline constexpr uint32_t kVertexCacheSize = 16;
+
+struct VertexCacheStats {
+  uint32_t triangles = 0;
+  uint32_t vertices_transformed = 0;// cache misses
+  uint32_t vertices_referenced = 0; // distinct vertices used by the indices
+  float acmr = 0.0f;                // average cache miss ratio, transformed per triangle: 3 at worst, ~0.5 on a regular grid
+  float atvr = 0.0f;                // average transform to vertex ratio, transformed per referenced: 1 at best
+};
+
+// Simulates a FIFO cache of cache_size vertices over the triangle list
+VertexCacheStats GLACEON_API AnalyzeVertexCache(std::span<const uint32_t> indices, size_t vertex_count, uint32_t cache_size = kVertexCacheSize);
+
+// Reorders the triangles of indices for a FIFO cache of cache_size vertices, in linear time
+void GLACEON_API OptimizeVertexCache(std::span<uint32_t> indices, size_t vertex_count, uint32_t cache_size = kVertexCacheSize);
+
+// Reorders clusters of triangles of a cache optimized list so outward facing ones on the outside of the mesh come first.
+// Clusters end where the cache order starts over, and as soon as their ACMR from a cold cache is within threshold
+// times the whole list's; a higher threshold gives smaller clusters, fewer overdrawn pixels and more cache misses.
+void GLACEON_API OptimizeOverdraw(std::span<uint32_t> indices, std::span<const glm::vec3> positions, float threshold = 1.05f,
+                                  uint32_t cache_size = kVertexCacheSize);
+
+// Renumbers vertices in order of first use in indices and rewrites them.  Returns the new index of every vertex, pass it
+// to RemapVertices() for each vertex stream; vertices no triangle uses go last, in their original order.
+std::vector<uint32_t> GLACEON_API OptimizeVertexFetch(std::span<uint32_t> indices, size_t vertex_count);
+
+// Moves stream[i] to stream[remap[i]]
+template<typename T>
+void RemapVertices(std::span<T> stream, std::span<const uint32_t> remap) {
+  std::vector<T> remapped(stream.size());
+  for (size_t i = 0; i < stream.size(); i++) { remapped[remap[i]] = stream[i]; }
+  std::copy(remapped.begin(), remapped.end(), stream.begin());
+}
+
+}// namespace glaceon
+
+#endif// GLACEON_GLACEON_MESHOPTIMIZER_H_
@@ -0,0 +1,128 @@
+// Replacements of the global operator new/delete that count every allocation and record it with the Profiler, built
+// only with GLACEON_TRACK_GLOBAL_NEW (see the CMake option of the same name).  Without it the count stays 0.
+//
+// On Linux the replacement is process wide.  On Windows it only covers allocations made by code in the Glaceon DLL,
+// since every module there links its own operator new.
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include "Profiler.h"
+
+namespace glaceon {
+
+#if GLACEON_TRACK_GLOBAL_NEW
+
+// counted outside of sessions too, FrameStats uses it to catch frames that allocate
+static std::atomic<uint64_t> global_allocation_count_{0};
+
+uint64_t Profiler::GetGlobalAllocationCount() { return global_allocation_count_.load(std::memory_order_relaxed); }
+bool Profiler::IsCountingGlobalAllocations() { return true; }
+
+static constexpr const char *kAllocatorName = "operator new";
+
+// The block's size is kept in front of the pointer handed out, in a header that keeps its alignment, so the unsized
+// operator delete can report how much was freed.
+static size_t GetHeaderSize(size_t alignment) { return std::max(alignof(std::max_align_t), alignment); }
+
+static void *AllocateTracked(size_t size, size_t alignment) {
+  if (size == 0) { size = 1; }
+  const size_t header_size = GetHeaderSize(alignment);
+
+  void *block = nullptr;
+  if (alignment <= alignof(std::max_align_t)) {
+    block = std::malloc(header_size + size);
+  } else {
+#ifdef _WIN32
+    block = _aligned_malloc(header_size + size, alignment);
+#else
+    if (posix_memalign(&block, alignment, header_size + size) != 0) { block = nullptr; }
+#endif
+  }
+  if (block == nullptr) { throw std::bad_alloc(); }
+
+  auto *ptr = static_cast<std::byte *>(block) + header_size;
+  reinterpret_cast<size_t *>(ptr)[-1] = size;
+  global_allocation_count_.fetch_add(1, std::memory_order_relaxed);
+  Profiler::RecordAllocation(kAllocatorName, size);
+  return ptr;
+}
+
+static void FreeTracked(void *ptr, size_t alignment) {
+  if (ptr == nullptr) { return; }
+  const size_t size = static_cast<size_t *>(ptr)[-1];
+  Profiler::RecordFree(kAllocatorName, size);
+
+  void *block = static_cast<std::byte *>(ptr) - GetHeaderSize(alignment);
+#ifdef _WIN32
+  if (alignment > alignof(std::max_align_t)) {
+    _aligned_free(block);
+    return;
+  }
+#endif
+  std::free(block);
+}
+
+#else
+
+uint64_t Profiler::GetGlobalAllocationCount() { return 0; }
+bool Profiler::IsCountingGlobalAllocations() { return false; }
+
+#endif// GLACEON_TRACK_GLOBAL_NEW
+
+}// namespace glaceon
+
+#if GLACEON_TRACK_GLOBAL_NEW
+
+// Every form is replaced, rather than relying on the standard library forwarding the nothrow and array ones, so no
+// block can be allocated by one implementation and freed by the other.  The size is read from the header, sized
+// deletes ignore theirs.
+static constexpr size_t kDefaultAlignment = alignof(std::max_align_t);
+
+void *operator new(size_t size) { return glaceon::AllocateTracked(size, kDefaultAlignment); }
+void *operator new[](size_t size) { return glaceon::AllocateTracked(size, kDefaultAlignment); }
+void *operator new(size_t size, std::align_val_t alignment) { return glaceon::AllocateTracked(size, static_cast<size_t>(alignment)); }
+void *operator new[](size_t size, std::align_val_t alignment) { return glaceon::AllocateTracked(size, static_cast<size_t>(alignment)); }
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+  try {
+    return glaceon::AllocateTracked(size, kDefaultAlignment);
+  } catch (const std::bad_alloc &) { return nullptr; }
+}
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+  try {
+    return glaceon::AllocateTracked(size, kDefaultAlignment);
+  } catch (const std::bad_alloc &) { return nullptr; }
+}
+void *operator new(size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+  try {
+    return glaceon::AllocateTracked(size, static_cast<size_t>(alignment));
+  } catch (const std::bad_alloc &) { return nullptr; }
+}
+void *operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+  try {
+    return glaceon::AllocateTracked(size, static_cast<size_t>(alignment));
+  } catch (const std::bad_alloc &) { return nullptr; }
+}
+
+void operator delete(void *ptr) noexcept { glaceon::FreeTracked(ptr, kDefaultAlignment); }
+void operator delete[](void *ptr) noexcept { glaceon::FreeTracked(ptr, kDefaultAlignment); }
+void operator delete(void *ptr, size_t) noexcept { glaceon::FreeTracked(ptr, kDefaultAlignment); }
+void operator delete[](void *ptr, size_t) noexcept { glaceon::FreeTracked(ptr, kDefaultAlignment); }
+void operator delete(void *ptr, const std::nothrow_t &) noexcept { glaceon::FreeTracked(ptr, kDefaultAlignment); }
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept { glaceon::FreeTracked(ptr, kDefaultAlignment); }
+
+void operator delete(void *ptr, std::align_val_t alignment) noexcept { glaceon::FreeTracked(ptr, static_cast<size_t>(alignment)); }
+void operator delete[](void *ptr, std::align_val_t alignment) noexcept { glaceon::FreeTracked(ptr, static_cast<size_t>(alignment)); }
+void operator delete(void *ptr, size_t, std::align_val_t alignment) noexcept { glaceon::FreeTracked(ptr, static_cast<size_t>(alignment)); }
+void operator delete[](void *ptr, size_t, std::align_val_t alignment) noexcept { glaceon::FreeTracked(ptr, static_cast<size_t>(alignment)); }
+void operator delete(void *ptr, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+  glaceon::FreeTracked(ptr, static_cast<size_t>(alignment));
+}
+void operator delete[](void *ptr, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+  glaceon::FreeTracked(ptr, static_cast<size_t>(alignment));
+}
+
+#endif// GLACEON_TRACK_GLOBAL_NEW
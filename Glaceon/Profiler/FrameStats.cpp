@@ -0,0 +1,199 @@
+#include "FrameStats.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <fstream>
+#include <span>
+
+#include "../Core/Logger.h"
+#include "Profiler.h"
+
+namespace glaceon {
+
+static const char *phase_names_[kNumFramePhases] = {"Acquire", "Record", "Submit", "Present"};
+// weight of the newest frame in the running average hitches are measured against
+static constexpr float kAverageWeight = 0.05f;
+
+struct FrameTimes {
+  uint64_t frame_index;
+  float frame_ms;
+  float phase_ms[kNumFramePhases];
+  uint32_t allocations;
+  bool hitch;
+  bool allocated;// allocated past the warm-up
+};
+
+static std::array<FrameTimes, FrameStats::kWindowSize> frames_;
+static uint32_t num_frames_ = 0;// valid entries in frames_
+static uint32_t next_frame_ = 0;// ring position the next frame is written to
+static float current_phase_ms_[kNumFramePhases] = {};
+static std::chrono::steady_clock::time_point last_frame_end_;
+static bool has_last_frame_end_ = false;
+static float average_frame_ms_ = 0.0f;
+static uint64_t total_frames_ = 0;
+static uint64_t total_hitches_ = 0;
+static uint64_t last_allocation_count_ = 0;
+static uint32_t warmup_frames_left_ = FrameStats::kWarmupFrames;
+static uint64_t total_allocating_frames_ = 0;
+static bool warned_allocating_frame_ = false;
+// the values GetSummary() sorts, kept around so drawing the stats every frame does not allocate
+static std::array<float, FrameStats::kWindowSize> sort_scratch_;
+
+// nearest-rank percentile of sorted values
+static float Percentile(std::span<const float> sorted, float percentile) {
+  const auto rank = static_cast<size_t>(std::ceil(percentile * static_cast<float>(sorted.size())));
+  return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+static FrameTimeStats ComputeStats(std::span<float> values) {
+  FrameTimeStats stats;
+  if (values.empty()) { return stats; }
+
+  std::sort(values.begin(), values.end());
+  double sum = 0.0;
+  for (float value : values) { sum += value; }
+  stats.mean = static_cast<float>(sum / static_cast<double>(values.size()));
+  stats.p50 = Percentile(values, 0.50f);
+  stats.p95 = Percentile(values, 0.95f);
+  stats.p99 = Percentile(values, 0.99f);
+  stats.max = values.back();
+  return stats;
+}
+
+// oldest first
+template<typename Func>
+static void ForEachFrame(Func &&func) {
+  const uint32_t first = num_frames_ < FrameStats::kWindowSize ? 0 : next_frame_;
+  for (uint32_t i = 0; i < num_frames_; i++) { func(frames_[(first + i) % FrameStats::kWindowSize]); }
+}
+
+void FrameStats::AddPhaseTime(FramePhase phase, float milliseconds) { current_phase_ms_[static_cast<uint32_t>(phase)] += milliseconds; }
+
+/**
+ * @brief Stores the frame's phase times in the window and resets them for the next frame.  The first call only starts
+ * the clock.
+ */
+void FrameStats::EndFrame() {
+  const auto now = std::chrono::steady_clock::now();
+  if (!has_last_frame_end_) {
+    has_last_frame_end_ = true;
+    last_frame_end_ = now;
+    last_allocation_count_ = Profiler::GetGlobalAllocationCount();
+    std::fill(std::begin(current_phase_ms_), std::end(current_phase_ms_), 0.0f);
+    return;
+  }
+
+  FrameTimes &frame = frames_[next_frame_];
+  frame.frame_index = total_frames_++;
+  frame.frame_ms = std::chrono::duration<float, std::milli>(now - last_frame_end_).count();
+  std::copy(std::begin(current_phase_ms_), std::end(current_phase_ms_), frame.phase_ms);
+  last_frame_end_ = now;
+  std::fill(std::begin(current_phase_ms_), std::end(current_phase_ms_), 0.0f);
+
+  // the first frames (pipeline creation, first uploads) would skew the average, start it off at the first frame time
+  frame.hitch = average_frame_ms_ > 0.0f && frame.frame_ms > kHitchFactor * average_frame_ms_;
+  average_frame_ms_ = average_frame_ms_ > 0.0f ? average_frame_ms_ + kAverageWeight * (frame.frame_ms - average_frame_ms_) : frame.frame_ms;
+  if (frame.hitch) { total_hitches_++; }
+
+  const uint64_t allocation_count = Profiler::GetGlobalAllocationCount();
+  frame.allocations = static_cast<uint32_t>(allocation_count - last_allocation_count_);
+  last_allocation_count_ = allocation_count;
+  frame.allocated = warmup_frames_left_ == 0 && frame.allocations > 0;
+  if (warmup_frames_left_ > 0) { warmup_frames_left_--; }
+  if (frame.allocated) {
+    total_allocating_frames_++;
+    if (!warned_allocating_frame_) {
+      warned_allocating_frame_ = true;
+      GWARN_CH(Memory, "FrameStats: frame {} made {} heap allocations after the warm-up", frame.frame_index, frame.allocations);
+      // the warning allocates itself, keep that out of the next frame
+      last_allocation_count_ = Profiler::GetGlobalAllocationCount();
+    }
+  }
+
+  next_frame_ = (next_frame_ + 1) % kWindowSize;
+  num_frames_ = std::min(num_frames_ + 1, kWindowSize);
+}
+
+void FrameStats::RestartWarmup() {
+  warmup_frames_left_ = kWarmupFrames;
+  warned_allocating_frame_ = false;
+}
+
+/**
+ * @brief Sorts the window to compute the percentiles, so call it at most once per frame.  Sorts in a static buffer
+ * rather than allocating, so it is main thread only like the rest of FrameStats.
+ */
+FrameStatsSummary FrameStats::GetSummary() {
+  FrameStatsSummary summary;
+  summary.num_frames = num_frames_;
+  summary.total_hitches = total_hitches_;
+  summary.total_frames = total_frames_;
+  summary.counts_allocations = Profiler::IsCountingGlobalAllocations();
+  summary.last_frame_allocations = num_frames_ > 0 ? frames_[(next_frame_ + kWindowSize - 1) % kWindowSize].allocations : 0;
+  summary.total_allocating_frames = total_allocating_frames_;
+
+  const std::span<float> values(sort_scratch_.data(), num_frames_);
+  uint32_t i = 0;
+  ForEachFrame([&](const FrameTimes &frame) {
+    values[i++] = frame.frame_ms;
+    if (frame.hitch) { summary.window_hitches++; }
+    if (frame.allocated) { summary.window_allocating_frames++; }
+  });
+  summary.frame = ComputeStats(values);
+
+  for (uint32_t phase = 0; phase < kNumFramePhases; phase++) {
+    i = 0;
+    ForEachFrame([&](const FrameTimes &frame) { values[i++] = frame.phase_ms[phase]; });
+    summary.phases[phase] = ComputeStats(values);
+  }
+  return summary;
+}
+
+uint32_t FrameStats::GetRecentFrameTimes(float *out, uint32_t max_frames) {
+  const uint32_t count = std::min(num_frames_, max_frames);
+  const uint32_t first = (next_frame_ + kWindowSize - count) % kWindowSize;
+  for (uint32_t i = 0; i < count; i++) { out[i] = frames_[(first + i) % kWindowSize].frame_ms; }
+  return count;
+}
+
+bool FrameStats::WriteCsv(const std::string &file_path) {
+  std::ofstream file(file_path);
+  if (!file) {
+    GERROR("FrameStats: failed to open {} for writing", file_path);
+    return false;
+  }
+
+  file << "frame,frame_ms";
+  for (const char *name : phase_names_) { file << ',' << name << "_ms"; }
+  file << ",allocations,hitch\n";
+  ForEachFrame([&](const FrameTimes &frame) {
+    file << frame.frame_index << ',' << frame.frame_ms;
+    for (float phase_ms : frame.phase_ms) { file << ',' << phase_ms; }
+    file << ',' << frame.allocations << ',' << (frame.hitch ? 1 : 0) << '\n';
+  });
+
+  GINFO("FrameStats: wrote {} frames to {}", num_frames_, file_path);
+  return true;
+}
+
+void FrameStats::PrintStats() {
+  const FrameStatsSummary summary = GetSummary();
+  GINFO("FrameStats: {} frames, {} hitches ({} in the last {} frames)", summary.total_frames, summary.total_hitches,
+        summary.window_hitches, summary.num_frames);
+  GINFO("  {:<8} mean {:7.3f} ms  p50 {:7.3f}  p95 {:7.3f}  p99 {:7.3f}  max {:7.3f}", "Frame", summary.frame.mean,
+        summary.frame.p50, summary.frame.p95, summary.frame.p99, summary.frame.max);
+  for (uint32_t phase = 0; phase < kNumFramePhases; phase++) {
+    const FrameTimeStats &stats = summary.phases[phase];
+    GINFO("  {:<8} mean {:7.3f} ms  p50 {:7.3f}  p95 {:7.3f}  p99 {:7.3f}  max {:7.3f}", phase_names_[phase], stats.mean, stats.p50,
+          stats.p95, stats.p99, stats.max);
+  }
+  if (summary.counts_allocations) {
+    GINFO("  {} frames allocated after the warm-up ({} in the last {} frames)", summary.total_allocating_frames,
+          summary.window_allocating_frames, summary.num_frames);
+  }
+}
+
+const char *FrameStats::GetPhaseName(FramePhase phase) { return phase_names_[static_cast<uint32_t>(phase)]; }
+
+}// namespace glaceon
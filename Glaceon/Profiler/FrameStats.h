@@ -0,0 +1,88 @@
+#ifndef GLACEON_GLACEON_PROFILER_FRAMESTATS_H_
+#define GLACEON_GLACEON_PROFILER_FRAMESTATS_H_
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "../Core/Base.h"
+
+namespace glaceon {
+
+enum class FramePhase : uint8_t { kAcquire, kRecord, kSubmit, kPresent, kCount };
+static constexpr uint32_t kNumFramePhases = static_cast<uint32_t>(FramePhase::kCount);
+
+// percentiles over the frames in the rolling window, in milliseconds
+struct FrameTimeStats {
+  float mean = 0.0f;
+  float p50 = 0.0f;
+  float p95 = 0.0f;
+  float p99 = 0.0f;
+  float max = 0.0f;
+};
+
+struct FrameStatsSummary {
+  uint32_t num_frames = 0;// frames in the window
+  FrameTimeStats frame;   // frame to frame time
+  FrameTimeStats phases[kNumFramePhases];
+  uint32_t window_hitches = 0;
+  uint64_t total_hitches = 0;
+  uint64_t total_frames = 0;
+  // global allocations, only counted when built with GLACEON_TRACK_GLOBAL_NEW
+  bool counts_allocations = false;
+  uint32_t last_frame_allocations = 0;
+  uint32_t window_allocating_frames = 0;// frames past the warm-up that allocated
+  uint64_t total_allocating_frames = 0;
+};
+
+// CPU frame times of the last kWindowSize frames, split into the acquire/record/submit/present phases of the render
+// loop.  Averages hide stutter, so the summary reports percentiles and counts hitches: frames that took more than
+// kHitchFactor times the running average.
+//
+// When built with GLACEON_TRACK_GLOBAL_NEW it also counts every frame's operator new calls.  Once warmed up a frame
+// should only use the frame arena and memory the allocators already own, so the first frame after kWarmupFrames that
+// still allocates is logged as a warning.
+//
+// Main thread only.  Collected in every build; the debug overlay and the PerformanceHud show the summary, and
+// PrintStats()/WriteCsv() write it out at shutdown.
+class GLACEON_API FrameStats {
+ public:
+  static constexpr uint32_t kWindowSize = 2048;
+  static constexpr float kHitchFactor = 2.0f;
+  static constexpr uint32_t kWarmupFrames = 120;
+
+  static void AddPhaseTime(FramePhase phase, float milliseconds);
+  // closes the current frame; its frame time is the time since the previous EndFrame()
+  static void EndFrame();
+  // lets the next kWarmupFrames frames allocate again, e.g. after a swapchain rebuild or opening a new window
+  static void RestartWarmup();
+
+  [[nodiscard]] static FrameStatsSummary GetSummary();
+  // copies the frame times of up to max_frames of the newest frames into out, oldest first; returns how many
+  static uint32_t GetRecentFrameTimes(float *out, uint32_t max_frames);
+  // one row per frame in the window
+  static bool WriteCsv(const std::string &file_path);
+  static void PrintStats();
+
+  static const char *GetPhaseName(FramePhase phase);
+};
+
+// Adds the time until it goes out of scope to the current frame's phase.
+class FramePhaseScope {
+ public:
+  explicit FramePhaseScope(FramePhase phase) : phase_(phase), start_(std::chrono::steady_clock::now()) {}
+  ~FramePhaseScope() {
+    FrameStats::AddPhaseTime(phase_, std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start_).count());
+  }
+
+  FramePhaseScope(const FramePhaseScope &) = delete;
+  FramePhaseScope &operator=(const FramePhaseScope &) = delete;
+
+ private:
+  FramePhase phase_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+}// namespace glaceon
+
+#endif// GLACEON_GLACEON_PROFILER_FRAMESTATS_H_
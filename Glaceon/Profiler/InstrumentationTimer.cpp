@@ -1,18 +1,15 @@
 #include "InstrumentationTimer.h"
 
-#include "../Core/Logger.h"
-
 namespace glaceon {
 
 // "name" here is the function name if using GLACEON_PROFILE_FUNCTION()
-InstrumentationTimer::InstrumentationTimer(const char* name) : name_(name) { start_time_ = std::chrono::high_resolution_clock::now(); }
-
-InstrumentationTimer::~InstrumentationTimer() { Stop(); }
+InstrumentationTimer::InstrumentationTimer(const char *name) : name_(name), session_id_(Profiler::GetSessionId()) {
+  if (session_id_ != 0) { start_ = Profiler::Now(); }
+}
 
-void InstrumentationTimer::Stop() {
-  end_time_ = std::chrono::high_resolution_clock::now();
-  long long duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time_ - start_time_).count();
-  GTRACE("@ {} = InstrumentationTimer: {} us - {} ms", name_, duration, duration * 0.001);
+InstrumentationTimer::~InstrumentationTimer() {
+  // a scope that straddles the start or end of a session is dropped
+  if (session_id_ != 0 && Profiler::GetSessionId() == session_id_) { Profiler::RecordScope(name_, start_, Profiler::Now()); }
 }
 
-}// namespace glaceon
\ No newline at end of file
+}// namespace glaceon
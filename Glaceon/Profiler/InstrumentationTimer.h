@@ -1,16 +1,24 @@
 #ifndef GLACEON_GLACEON_PROFILER_TIMER_H_
 #define GLACEON_GLACEON_PROFILER_TIMER_H_
 
-#include <chrono>
+#include <cstdint>
 
-// 1 to enable profiling
-#define PROFILING0
-#if PROFILING
-// Just write any of these macros within a function to start measuring time
+#include "../Core/Base.h"
+#include "Profiler.h"
+
+// 0 to compile every profile scope out; with it on, a scope outside of a Profiler session costs one atomic load
+#ifndef GLACEON_PROFILING
+#define GLACEON_PROFILING 1
+#endif
+
+#if GLACEON_PROFILING
+#define GLACEON_PROFILE_CONCAT_IMPL(a, b) a##b
+#define GLACEON_PROFILE_CONCAT(a, b) GLACEON_PROFILE_CONCAT_IMPL(a, b)
+// Just write any of these macros within a function to start measuring time; name must outlive the profiler session
 // use line number as name to avoid collisions
-#define GLACEON_PROFILE_SCOPE(name) glaceon::InstrumentationTimer timer##__LINE__(name);
-// prints out the function
-#define GLACEON_PROFILE_FUNCTION() GLACEON_PROFILE_SCOPE(__PRETTY_FUNCTION__)
+#define GLACEON_PROFILE_SCOPE(name) glaceon::InstrumentationTimer GLACEON_PROFILE_CONCAT(timer, __LINE__)(name)
+// records the function name
+#define GLACEON_PROFILE_FUNCTION() GLACEON_PROFILE_SCOPE(__FUNCTION__)
 #else
 #define GLACEON_PROFILE_SCOPE(name)
 #define GLACEON_PROFILE_FUNCTION()
@@ -18,19 +26,22 @@
 
 namespace glaceon {
 
-// Quick timer to measure code performance
-class InstrumentationTimer {
+// Records the time between its construction and destruction as a scope of the running Profiler session.  Scopes
+// nest, the trace viewer shows a scope opened inside another one below it.
+class GLACEON_API InstrumentationTimer {
  public:
-  explicit InstrumentationTimer(const char* name);
+  explicit InstrumentationTimer(const char *name);
   ~InstrumentationTimer();
 
+  InstrumentationTimer(const InstrumentationTimer &) = delete;
+  InstrumentationTimer &operator=(const InstrumentationTimer &) = delete;
+
  private:
-  void Stop();
-  const char* name_;
-  std::chrono::time_point<std::chrono::high_resolution_clock> start_time_;
-  std::chrono::time_point<std::chrono::high_resolution_clock> end_time_;
+  const char *name_;
+  uint32_t session_id_;// 0 if no session was running on construction
+  uint64_t start_ = 0;
 };
 
 }// namespace glaceon
 
-#endif// GLACEON_GLACEON_PROFILER_TIMER_H_
\ No newline at end of file
+#endif// GLACEON_GLACEON_PROFILER_TIMER_H_
@@ -0,0 +1,119 @@
+#include "MemoryPanel.h"
+
+#include "../Core/Memory/AllocatorStats.h"
+#include "../Core/Memory/MemorySubsystem.h"
+#include "../pch.h"
+
+namespace glaceon {
+
+// more allocators than this are left out of the table
+static constexpr uint32_t kMaxAllocators = 64;
+
+static std::string selected_allocator_;
+static std::array<AllocatorStatsSnapshot, kMaxAllocators> snapshots_;
+
+// human readable size, written into a caller's buffer so drawing the panel every frame does not allocate
+struct FormattedBytes {
+  char text[32];
+};
+
+static FormattedBytes FormatBytes(uint64_t bytes) {
+  const uint64_t kKib = 1024;
+  const uint64_t kMib = kKib * 1024;
+  const uint64_t kGib = kMib * 1024;
+
+  FormattedBytes formatted;
+  char *end = formatted.text;
+  const size_t max_size = sizeof(formatted.text) - 1;
+  if (bytes >= kGib) {
+    end = fmt::format_to_n(end, max_size, "{:.2f} GiB", bytes / static_cast<float>(kGib)).out;
+  } else if (bytes >= kMib) {
+    end = fmt::format_to_n(end, max_size, "{:.2f} MiB", bytes / static_cast<float>(kMib)).out;
+  } else if (bytes >= kKib) {
+    end = fmt::format_to_n(end, max_size, "{:.2f} KiB", bytes / static_cast<float>(kKib)).out;
+  } else {
+    end = fmt::format_to_n(end, max_size, "{} B", bytes).out;
+  }
+  *end = '\0';
+  return formatted;
+}
+
+static void DrawSizeHistogram(const AllocatorStatsSnapshot &snapshot) {
+  float buckets[AllocatorStats::kNumSizeBuckets];
+  float max_count = 0.0f;
+  for (uint32_t i = 0; i < AllocatorStats::kNumSizeBuckets; i++) {
+    buckets[i] = static_cast<float>(snapshot.size_histogram[i]);
+    max_count = std::max(max_count, buckets[i]);
+  }
+
+  ImGui::Text("%s allocation sizes, %s to %s+", snapshot.name, FormatBytes(AllocatorStats::GetSizeBucketMin(0)).text,
+              FormatBytes(AllocatorStats::GetSizeBucketMin(AllocatorStats::kNumSizeBuckets - 1)).text);
+  ImGui::PlotHistogram("##sizes", buckets, AllocatorStats::kNumSizeBuckets, 0, nullptr, 0.0f, max_count, ImVec2(0, 80));
+  if (ImGui::IsItemHovered()) {
+    ImGui::BeginTooltip();
+    for (uint32_t i = 0; i < AllocatorStats::kNumSizeBuckets; i++) {
+      if (snapshot.size_histogram[i] == 0) { continue; }
+      ImGui::Text(">= %s: %llu", FormatBytes(AllocatorStats::GetSizeBucketMin(i)).text,
+                  static_cast<unsigned long long>(snapshot.size_histogram[i]));
+    }
+    ImGui::EndTooltip();
+  }
+}
+
+void DrawMemoryPanel() {
+  ImGui::Begin("Memory");
+
+  const MemoryStats memory_stats = MemorySubsystem::GetStats();
+  if (ImGui::TreeNode("memory_tags", "MemorySubsystem: %s", FormatBytes(memory_stats.total_allocated).text)) {
+    for (uint32_t i = 0; i < MEMORY_TAG_MAX_TAGS; i++) {
+      const auto tag = static_cast<MemoryTag>(i);
+      ImGui::Text("%-10s %s", MemorySubsystem::GetTagName(tag), FormatBytes(memory_stats.tagged_allocations[i]).text);
+    }
+    ImGui::TreePop();
+  }
+
+  const std::span<const AllocatorStatsSnapshot> snapshots(snapshots_.data(), AllocatorRegistry::GetSnapshots(snapshots_));
+  const AllocatorStatsSnapshot *selected = nullptr;
+
+  const ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable;
+  if (ImGui::BeginTable("allocators", 7, flags)) {
+    ImGui::TableSetupColumn("Allocator");
+    ImGui::TableSetupColumn("Used");
+    ImGui::TableSetupColumn("Capacity");
+    ImGui::TableSetupColumn("Peak");
+    ImGui::TableSetupColumn("Allocs/frame");
+    ImGui::TableSetupColumn("Bytes/frame");
+    ImGui::TableSetupColumn("Failures");
+    ImGui::TableHeadersRow();
+
+    for (const AllocatorStatsSnapshot &snapshot : snapshots) {
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn();
+      const bool is_selected = snapshot.name == selected_allocator_;
+      if (ImGui::Selectable(snapshot.name, is_selected, ImGuiSelectableFlags_SpanAllColumns)) {
+        selected_allocator_ = snapshot.name;
+      }
+      if (is_selected) { selected = &snapshot; }
+
+      ImGui::TableNextColumn();
+      ImGui::TextUnformatted(FormatBytes(snapshot.used_memory).text);
+      ImGui::TableNextColumn();
+      ImGui::TextUnformatted(FormatBytes(snapshot.capacity).text);
+      ImGui::TableNextColumn();
+      ImGui::TextUnformatted(FormatBytes(snapshot.peak_used_memory).text);
+      ImGui::TableNextColumn();
+      ImGui::Text("%llu", static_cast<unsigned long long>(snapshot.frame_allocations));
+      ImGui::TableNextColumn();
+      ImGui::TextUnformatted(FormatBytes(snapshot.frame_bytes).text);
+      ImGui::TableNextColumn();
+      ImGui::Text("%llu", static_cast<unsigned long long>(snapshot.num_failures));
+    }
+    ImGui::EndTable();
+  }
+
+  if (selected != nullptr) { DrawSizeHistogram(*selected); }
+
+  ImGui::End();
+}
+
+}// namespace glaceon
@@ -0,0 +1,13 @@
+#ifndef GLACEON_GLACEON_PROFILER_MEMORYPANEL_H_
+#define GLACEON_GLACEON_PROFILER_MEMORYPANEL_H_
+
+namespace glaceon {
+
+// ImGui window listing every allocator registered with AllocatorRegistry (usage, peak, per-frame rate, failures and
+// the allocation size histogram of the selected one) plus the MemorySubsystem total, which expands into its per-tag
+// totals.  Call between ImGui::NewFrame() and ImGui::Render().
+void DrawMemoryPanel();
+
+}// namespace glaceon
+
+#endif// GLACEON_GLACEON_PROFILER_MEMORYPANEL_H_
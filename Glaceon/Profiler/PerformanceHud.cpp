@@ -0,0 +1,153 @@
+#include "PerformanceHud.h"
+
+#include "../Core/Memory/AllocatorStats.h"
+#include "../Core/Memory/MemorySubsystem.h"
+#include "../VulkanRenderer/VulkanContext.h"
+#include "../pch.h"
+#include "FrameStats.h"
+
+namespace glaceon {
+
+static constexpr uint32_t kGraphFrames = 240;
+static constexpr float kGraphWidth = 260.0f;
+static constexpr float kGraphHeight = 48.0f;
+static constexpr float kBarWidth = 160.0f;
+static constexpr float kMib = 1024.0f * 1024.0f;
+// more allocators than this are left off the HUD
+static constexpr uint32_t kMaxAllocators = 64;
+
+static bool visible_ = false;
+
+// GPU frame times of the frames the HUD was drawn in; FrameStats keeps the CPU ones
+static std::array<float, kGraphFrames> gpu_frame_times_ = {};
+static uint32_t num_gpu_frame_times_ = 0;
+static uint32_t next_gpu_frame_time_ = 0;
+static std::array<AllocatorStatsSnapshot, kMaxAllocators> snapshots_;
+
+// formats into a fixed buffer, cutting off what does not fit, so drawing the HUD does not allocate
+template<size_t N, typename... Args>
+static void FormatTo(char (&buffer)[N], fmt::format_string<Args...> format, Args &&...args) {
+  *fmt::format_to_n(buffer, N - 1, format, std::forward<Args>(args)...).out = '\0';
+}
+
+// a scale shared by the CPU and GPU graphs so they can be compared at a glance; hitches above it are clipped
+static float GraphScale(const FrameStatsSummary &summary) { return std::max(1.25f * summary.frame.p99, 1000.0f / 60.0f); }
+
+static void DrawFrameTimes(const FrameStatsSummary &summary) {
+  std::array<float, kGraphFrames> frame_times;
+  const uint32_t num_frame_times = FrameStats::GetRecentFrameTimes(frame_times.data(), kGraphFrames);
+  char overlay[64];
+  FormatTo(overlay, "CPU {:.2f} ms, p99 {:.2f} ms", summary.frame.p50, summary.frame.p99);
+  ImGui::PlotLines("##cpu_frame_times", frame_times.data(), static_cast<int>(num_frame_times), 0, overlay, 0.0f, GraphScale(summary),
+                   ImVec2(kGraphWidth, kGraphHeight));
+
+  const float fps = summary.frame.mean > 0.0f ? 1000.0f / summary.frame.mean : 0.0f;
+  ImGui::Text("%.1f FPS, %u hitches in the last %u frames", fps, summary.window_hitches, summary.num_frames);
+  for (uint32_t phase = 0; phase < kNumFramePhases; phase++) {
+    if (phase > 0) { ImGui::SameLine(); }
+    ImGui::Text("%s %.2f", FrameStats::GetPhaseName(static_cast<FramePhase>(phase)), summary.phases[phase].p50);
+  }
+  if (summary.counts_allocations) {
+    ImGui::Text("%u allocations last frame, %u allocating frames", summary.last_frame_allocations, summary.window_allocating_frames);
+  }
+}
+
+static void DrawGpuTimes(const VulkanGpuProfiler &gpu_profiler, const FrameStatsSummary &summary) {
+  if (!gpu_profiler.IsEnabled()) {
+    ImGui::TextUnformatted("GPU timings unavailable");
+    return;
+  }
+
+  const float gpu_ms = gpu_profiler.GetFrameTime();
+  gpu_frame_times_[next_gpu_frame_time_] = gpu_ms;
+  next_gpu_frame_time_ = (next_gpu_frame_time_ + 1) % kGraphFrames;
+  num_gpu_frame_times_ = std::min(num_gpu_frame_times_ + 1, kGraphFrames);
+
+  // GPU results lag a few frames behind, compare against the typical CPU frame rather than the last one
+  char overlay[64];
+  FormatTo(overlay, "GPU {:.2f} ms, {}-bound", gpu_ms, gpu_ms > 0.9f * summary.frame.p50 ? "GPU" : "CPU");
+  const uint32_t first = num_gpu_frame_times_ < kGraphFrames ? 0 : next_gpu_frame_time_;
+  ImGui::PlotLines("##gpu_frame_times", gpu_frame_times_.data(), static_cast<int>(num_gpu_frame_times_), static_cast<int>(first),
+                   overlay, 0.0f, GraphScale(summary), ImVec2(kGraphWidth, kGraphHeight));
+
+  bool first_scope = true;
+  for (const GpuScopeResult &result : gpu_profiler.GetResults()) {
+    if (result.depth != 0) { continue; }
+    if (!first_scope) { ImGui::SameLine(); }
+    ImGui::Text("%s %.2f", result.name, result.milliseconds);
+    first_scope = false;
+  }
+}
+
+static void DrawUsageBar(const char *name, uint64_t used, uint64_t capacity) {
+  char label[64];
+  FormatTo(label, "{:.1f} / {:.1f} MiB", static_cast<float>(used) / kMib, static_cast<float>(capacity) / kMib);
+  ImGui::ProgressBar(capacity > 0 ? static_cast<float>(used) / static_cast<float>(capacity) : 0.0f, ImVec2(kBarWidth, 0.0f), label);
+  ImGui::SameLine();
+  ImGui::TextUnformatted(name);
+}
+
+static void DrawAllocators() {
+  ImGui::Text("MemorySubsystem %.2f MiB", static_cast<float>(MemorySubsystem::GetStats().total_allocated) / kMib);
+  const size_t num_snapshots = AllocatorRegistry::GetSnapshots(snapshots_);
+  for (const AllocatorStatsSnapshot &snapshot : std::span(snapshots_.data(), num_snapshots)) {
+    if (snapshot.capacity > 0) {
+      DrawUsageBar(snapshot.name, snapshot.used_memory, snapshot.capacity);
+    } else {
+      ImGui::Text("%s %.2f MiB", snapshot.name, static_cast<float>(snapshot.used_memory) / kMib);
+    }
+  }
+}
+
+static void DrawDeviceMemory(const VulkanMemoryAllocator &memory_allocator) {
+  const DeviceMemoryStats &stats = memory_allocator.GetStats();
+  for (uint32_t heap = 0; heap < stats.heap_count; heap++) {
+    const DeviceMemoryHeapStats &heap_stats = stats.heaps[heap];
+    char name[96];
+    FormatTo(name, "Heap {}{}, {} blocks, {} allocs, {:.0f}% frag", heap, heap_stats.device_local ? " (device)" : "", heap_stats.block_count,
+             heap_stats.allocation_count, 100.0f * heap_stats.fragmentation);
+    DrawUsageBar(name, heap_stats.usage, heap_stats.budget);
+  }
+  if (!stats.memory_budget_enabled) { ImGui::TextUnformatted("No VK_EXT_memory_budget, usage is VMA's only"); }
+}
+
+void PerformanceHud::Toggle() {
+  visible_ = !visible_;
+  // ImGui sets up the window's draw lists the first frames it is shown
+  FrameStats::RestartWarmup();
+  // the GPU graph only has samples of frames the HUD was up for, start it over
+  num_gpu_frame_times_ = 0;
+  next_gpu_frame_time_ = 0;
+}
+
+bool PerformanceHud::IsVisible() { return visible_; }
+
+/**
+ * @brief Draws the HUD as a fixed overlay in the top left corner of the main window.
+ *
+ * @param context The Vulkan context, for the GPU profiler and the memory allocator.
+ */
+void PerformanceHud::Draw(VulkanContext &context) {
+  // pinned to the main viewport so it never turns into a platform window of its own
+  const ImGuiViewport *viewport = ImGui::GetMainViewport();
+  ImGui::SetNextWindowPos(ImVec2(viewport->WorkPos.x + 8.0f, viewport->WorkPos.y + 8.0f), ImGuiCond_Always);
+  ImGui::SetNextWindowViewport(viewport->ID);
+  ImGui::SetNextWindowBgAlpha(0.75f);
+  const ImGuiWindowFlags flags = ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoDocking | ImGuiWindowFlags_AlwaysAutoResize
+      | ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoNav | ImGuiWindowFlags_NoMove;
+  if (!ImGui::Begin("Performance HUD", nullptr, flags)) {
+    ImGui::End();
+    return;
+  }
+
+  const FrameStatsSummary summary = FrameStats::GetSummary();
+  DrawFrameTimes(summary);
+  DrawGpuTimes(context.GetVulkanGpuProfiler(), summary);
+  ImGui::Separator();
+  DrawAllocators();
+  ImGui::Separator();
+  DrawDeviceMemory(context.GetVulkanMemoryAllocator());
+  ImGui::End();
+}
+
+}// namespace glaceon
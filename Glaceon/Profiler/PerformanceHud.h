@@ -0,0 +1,26 @@
+#ifndef GLACEON_GLACEON_PROFILER_PERFORMANCEHUD_H_
+#define GLACEON_GLACEON_PROFILER_PERFORMANCEHUD_H_
+
+#include "../Core/Base.h"
+
+namespace glaceon {
+
+class VulkanContext;
+
+// Compact overlay usable in every build type: CPU and GPU frame time graphs, the CPU phases and GPU scopes of the
+// typical frame, allocator usage and device memory heap usage against the VMA budget.
+//
+// Hidden by default and toggled with F3 in RunGame.  While it is hidden none of it runs, and release builds skip the
+// ImGui frame and its draws altogether.
+class GLACEON_API PerformanceHud {
+ public:
+  static void Toggle();
+  [[nodiscard]] static bool IsVisible();
+
+  // call between ImGui::NewFrame() and ImGui::Render(), main thread only
+  static void Draw(VulkanContext &context);
+};
+
+}// namespace glaceon
+
+#endif// GLACEON_GLACEON_PROFILER_PERFORMANCEHUD_H_
@@ -0,0 +1,432 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define GLACEON_PROFILER_RDTSC 1
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+#include "../Core/Logger.h"
+#include "../pch.h"
+
+namespace glaceon {
+
+static constexpr size_t kEventsPerChunk = 4096;
+// caps a thread at ~1M scopes per session (32 MiB), anything past that is dropped and reported at the end
+static constexpr uint32_t kMaxChunksPerThread = 256;
+
+enum class TraceEventType : uint8_t { kScope, kAllocation, kFree };
+
+struct TraceEvent {
+  const char *name;// the allocator for memory events
+  uint64_t start;
+  uint64_t end;        // memory events: bytes allocated or freed
+  const char *callsite;// memory events only, may be nullptr
+  int64_t used_memory; // memory events: the allocator's usage afterwards, or -1 to sum up the sizes instead
+  uint32_t track;      // 0 for the recording thread
+  TraceEventType type;
+};
+
+struct EventChunk {
+  TraceEvent events[kEventsPerChunk];
+  EventChunk *next = nullptr;
+};
+
+// Events of one thread.  Only the owning thread writes; it fills in an event and then publishes it by bumping count,
+// so EndSession() can read everything below count without a lock.  Chunks are kept for the next session, and like
+// MemorySubsystem's ThreadStats a node outlives its thread and is handed to the next new one.
+struct ThreadTrace {
+  std::atomic<uint32_t> session_id{0};// session the events belong to
+  std::atomic<uint64_t> count{0};
+  std::atomic<uint64_t> dropped{0};
+  EventChunk *first = nullptr;
+  EventChunk *current = nullptr;
+  uint32_t num_chunks = 0;
+  uint32_t thread_id = 0;
+  std::string thread_name;// guarded by thread_names_mutex_
+  std::atomic<bool> in_use{true};
+  ThreadTrace *next = nullptr;
+};
+
+static std::atomic<uint32_t> session_id_{0};
+static std::atomic<ThreadTrace *> thread_traces_head_{nullptr};
+static std::atomic<uint32_t> next_thread_id_{1};
+
+// session state, only touched with session_mutex_ held
+static std::mutex session_mutex_;
+static uint32_t next_session_id_ = 1;
+static std::string session_file_path_;
+static uint32_t session_frames_left_ = 0;
+static uint64_t session_start_ticks_ = 0;
+static std::chrono::steady_clock::time_point session_start_time_;
+static uint64_t frame_start_ticks_ = 0;
+// rows registered with RegisterTrack(), as (id, name)
+static std::vector<std::pair<uint32_t, std::string>> tracks_;
+
+// separate from session_mutex_ since a thread's first event, which may be an allocation made with session_mutex_
+// held, acquires its ThreadTrace
+static std::mutex thread_names_mutex_;
+
+// Allocators register, and intern their names, from static initializers of other translation units, so the set is
+// created on first use and never destroyed
+struct InternedNames {
+  std::mutex mutex;
+  std::unordered_set<std::string> names;
+};
+
+static InternedNames &GetInternedNames() {
+  static auto *interned_names = new InternedNames();
+  return *interned_names;
+}
+
+// Set while the calling thread records an event.  Allocations made in there (a new EventChunk, the thread's first
+// ThreadTrace, ...) are not recorded, which keeps a global operator new hook from recursing into a half updated trace.
+static thread_local bool recording_event_ = false;
+
+// reference point for GetTicksPerMicrosecond(), taken at startup
+static const uint64_t startup_ticks_ = Profiler::Now();
+static const std::chrono::steady_clock::time_point startup_time_ = std::chrono::steady_clock::now();
+
+static ThreadTrace *AcquireThreadTrace() {
+  // a dead thread's node still holding events of the running session is skipped so they make it into the trace
+  const uint32_t session_id = session_id_.load(std::memory_order_acquire);
+  for (ThreadTrace *trace = thread_traces_head_.load(std::memory_order_acquire); trace != nullptr; trace = trace->next) {
+    if (session_id != 0 && trace->session_id.load(std::memory_order_relaxed) == session_id) { continue; }
+    bool expected = false;
+    if (trace->in_use.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+      std::lock_guard<std::mutex> lock(thread_names_mutex_);
+      trace->thread_name.clear();
+      return trace;
+    }
+  }
+
+  auto *trace = new ThreadTrace();
+  trace->thread_id = next_thread_id_.fetch_add(1, std::memory_order_relaxed);
+  trace->next = thread_traces_head_.load(std::memory_order_relaxed);
+  while (!thread_traces_head_.compare_exchange_weak(trace->next, trace, std::memory_order_release, std::memory_order_relaxed)) {}
+  return trace;
+}
+
+struct ThreadTraceHolder {
+  ThreadTrace *trace = AcquireThreadTrace();
+  ~ThreadTraceHolder() { trace->in_use.store(false, std::memory_order_release); }
+};
+
+static thread_local ThreadTraceHolder thread_trace_;
+
+static void RecordEvent(const TraceEvent &event);
+
+static void AppendEscaped(fmt::memory_buffer &out, const char *text) {
+  for (const char *c = text; *c != '\0'; c++) {
+    if (*c == '"' || *c == '\\') { out.push_back('\\'); }
+    out.push_back(*c);
+  }
+}
+
+// an instant event on the thread's row with the details of one allocation or free
+static void AppendMemoryEvent(fmt::memory_buffer &out, const TraceEvent &event, double timestamp_us, uint32_t thread_id) {
+  fmt::format_to(std::back_inserter(out), ",\n{{\"name\":\"{}\",\"cat\":\"memory\",\"ph\":\"i\",\"s\":\"t\",\"ts\":{:.3f},\"pid\":1,\"tid\":{},\"args\":{{\"allocator\":\"",
+                 event.type == TraceEventType::kAllocation ? "Alloc" : "Free", timestamp_us, thread_id);
+  AppendEscaped(out, event.name);
+  fmt::format_to(std::back_inserter(out), "\",\"bytes\":{}", event.end);
+  if (event.callsite != nullptr) {
+    fmt::format_to(std::back_inserter(out), ",\"callsite\":\"");
+    AppendEscaped(out, event.callsite);
+    out.push_back('"');
+  }
+  fmt::format_to(std::back_inserter(out), "}}}}");
+}
+
+/**
+ * @brief Turns the memory events of every thread into two counter tracks with a series per allocator: "Memory", the
+ * bytes in use, and "Allocations", the number of allocations since the session started.
+ *
+ * Allocators that report their usage are shown as is; for the others (MemorySubsystem tags, operator new) the trace
+ * sums up what was allocated and freed during the session, so their series starts at 0.
+ */
+static void AppendMemoryCounters(fmt::memory_buffer &out, std::vector<const TraceEvent *> &events, uint64_t session_start_ticks,
+                                 double ticks_per_us) {
+  std::stable_sort(events.begin(), events.end(), [](const TraceEvent *a, const TraceEvent *b) { return a->start < b->start; });
+
+  std::unordered_map<std::string_view, int64_t> used_memory;
+  std::unordered_map<std::string_view, uint64_t> allocation_counts;
+  for (const TraceEvent *event : events) {
+    const std::string_view allocator = event->name;
+    int64_t &used = used_memory[allocator];
+    if (event->used_memory >= 0) {
+      used = event->used_memory;
+    } else {
+      used += event->type == TraceEventType::kAllocation ? static_cast<int64_t>(event->end) : -static_cast<int64_t>(event->end);
+    }
+
+    const double timestamp_us = static_cast<double>(event->start - session_start_ticks) / ticks_per_us;
+    fmt::format_to(std::back_inserter(out), ",\n{{\"name\":\"Memory\",\"ph\":\"C\",\"ts\":{:.3f},\"pid\":1,\"args\":{{\"", timestamp_us);
+    AppendEscaped(out, event->name);
+    fmt::format_to(std::back_inserter(out), "\":{}}}}}", used);
+    if (event->type == TraceEventType::kAllocation) {
+      fmt::format_to(std::back_inserter(out), ",\n{{\"name\":\"Allocations\",\"ph\":\"C\",\"ts\":{:.3f},\"pid\":1,\"args\":{{\"", timestamp_us);
+      AppendEscaped(out, event->name);
+      fmt::format_to(std::back_inserter(out), "\":{}}}}}", ++allocation_counts[allocator]);
+    }
+  }
+}
+
+// -------------------------- PROFILER --------------------------
+
+/**
+ * @brief Starts recording scopes from every thread.
+ *
+ * @param file_path Where EndSession() writes the Chrome trace JSON.
+ * @param frame_count Number of EndFrame() calls after which the session ends by itself; 0 to record until EndSession().
+ * @return false if a session is already running.
+ */
+bool Profiler::BeginSession(const std::string &file_path, uint32_t frame_count) {
+  std::lock_guard<std::mutex> lock(session_mutex_);
+  if (session_id_.load(std::memory_order_relaxed) != 0) {
+    GWARN("Profiler: session {} is still running, not starting {}", session_file_path_, file_path);
+    return false;
+  }
+
+  session_file_path_ = file_path;
+  session_frames_left_ = frame_count;
+  session_start_time_ = std::chrono::steady_clock::now();
+  session_start_ticks_ = Now();
+  frame_start_ticks_ = session_start_ticks_;
+  session_id_.store(next_session_id_++, std::memory_order_release);
+
+  if (frame_count > 0) {
+    GINFO("Profiler: capturing {} frames into {}", frame_count, file_path);
+  } else {
+    GINFO("Profiler: capturing into {}", file_path);
+  }
+  return true;
+}
+
+/**
+ * @brief Stops recording and writes every scope recorded during the session to the session's file.
+ *
+ * Threads still inside a scope when this is called drop that scope.  Writing the file takes a while for long
+ * sessions, so call it where a hitch does not matter.
+ */
+void Profiler::EndSession() {
+  std::lock_guard<std::mutex> lock(session_mutex_);
+  const uint32_t session_id = session_id_.load(std::memory_order_relaxed);
+  if (session_id == 0) { return; }
+  session_id_.store(0, std::memory_order_release);
+
+  // timestamps are in ticks, work out how many there are per microsecond over the whole session
+  const uint64_t end_ticks = Now();
+  const double elapsed_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - session_start_time_).count();
+  const double ticks_per_us = elapsed_us > 0.0 ? static_cast<double>(end_ticks - session_start_ticks_) / elapsed_us : 1.0;
+
+  fmt::memory_buffer out;
+  fmt::format_to(std::back_inserter(out), "{{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+  bool first_event = true;
+  uint64_t total_events = 0;
+  uint64_t total_dropped = 0;
+  std::vector<const TraceEvent *> memory_events;
+
+  for (const auto &[track_id, track_name] : tracks_) {
+    fmt::format_to(std::back_inserter(out), "{}{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":\"", first_event ? "" : ",\n",
+                   track_id);
+    AppendEscaped(out, track_name.c_str());
+    fmt::format_to(std::back_inserter(out), "\"}}}}");
+    first_event = false;
+  }
+
+  for (ThreadTrace *trace = thread_traces_head_.load(std::memory_order_acquire); trace != nullptr; trace = trace->next) {
+    if (trace->session_id.load(std::memory_order_acquire) != session_id) { continue; }
+    const uint64_t count = trace->count.load(std::memory_order_acquire);
+    total_dropped += trace->dropped.load(std::memory_order_relaxed);
+
+    fmt::format_to(std::back_inserter(out), "{}{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":\"", first_event ? "" : ",\n",
+                   trace->thread_id);
+    {
+      std::lock_guard<std::mutex> names_lock(thread_names_mutex_);
+      if (trace->thread_name.empty()) {
+        fmt::format_to(std::back_inserter(out), "Thread {}", trace->thread_id);
+      } else {
+        AppendEscaped(out, trace->thread_name.c_str());
+      }
+    }
+    fmt::format_to(std::back_inserter(out), "\"}}}}");
+    first_event = false;
+
+    const EventChunk *chunk = trace->first;
+    for (uint64_t i = 0; i < count; i++) {
+      if (i > 0 && i % kEventsPerChunk == 0) { chunk = chunk->next; }
+      const TraceEvent &event = chunk->events[i % kEventsPerChunk];
+      // GPU scopes are read back frames later and may have started before the session did
+      if (event.start < session_start_ticks_) { continue; }
+      if (event.type != TraceEventType::kScope) {
+        AppendMemoryEvent(out, event, static_cast<double>(event.start - session_start_ticks_) / ticks_per_us, trace->thread_id);
+        memory_events.push_back(&event);
+        continue;
+      }
+      fmt::format_to(std::back_inserter(out), ",\n{{\"name\":\"");
+      AppendEscaped(out, event.name);
+      fmt::format_to(std::back_inserter(out), "\",\"cat\":\"glaceon\",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":1,\"tid\":{}}}",
+                     static_cast<double>(event.start - session_start_ticks_) / ticks_per_us,
+                     static_cast<double>(event.end - event.start) / ticks_per_us, event.track != 0 ? event.track : trace->thread_id);
+    }
+    total_events += count;
+  }
+  AppendMemoryCounters(out, memory_events, session_start_ticks_, ticks_per_us);
+  fmt::format_to(std::back_inserter(out), "\n]}}\n");
+
+  std::ofstream file(session_file_path_, std::ios::binary);
+  if (!file) {
+    GERROR("Profiler: failed to open {} for writing", session_file_path_);
+    return;
+  }
+  file.write(out.data(), static_cast<std::streamsize>(out.size()));
+
+  GINFO("Profiler: wrote {} events ({} allocations and frees) to {}", total_events, memory_events.size(), session_file_path_);
+  if (total_dropped > 0) { GWARN("Profiler: dropped {} scopes, a thread ran out of event buffer", total_dropped); }
+}
+
+bool Profiler::IsActive() { return session_id_.load(std::memory_order_relaxed) != 0; }
+
+uint32_t Profiler::GetSessionId() { return session_id_.load(std::memory_order_relaxed); }
+
+/**
+ * @brief Records the time since the previous call as a "Frame" scope and ends frame limited sessions.
+ */
+void Profiler::EndFrame() {
+  if (!IsActive()) { return; }
+
+  const uint64_t now = Now();
+  RecordScope("Frame", frame_start_ticks_, now);
+  frame_start_ticks_ = now;
+
+  bool end_session = false;
+  {
+    std::lock_guard<std::mutex> lock(session_mutex_);
+    end_session = session_frames_left_ > 0 && --session_frames_left_ == 0;
+  }
+  if (end_session) { EndSession(); }
+}
+
+uint32_t Profiler::RegisterTrack(const char *name) {
+  // shares the id space with threads so the trace viewer shows it as a row of its own
+  const uint32_t track_id = next_thread_id_.fetch_add(1, std::memory_order_relaxed);
+  std::lock_guard<std::mutex> lock(session_mutex_);
+  tracks_.emplace_back(track_id, name);
+  return track_id;
+}
+
+double Profiler::GetTicksPerMicrosecond() {
+#if GLACEON_PROFILER_RDTSC
+  const double elapsed_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - startup_time_).count();
+  return elapsed_us > 0.0 ? static_cast<double>(Now() - startup_ticks_) / elapsed_us : 1.0;
+#else
+  return 1000.0;
+#endif
+}
+
+void Profiler::SetThreadName(const char *name) {
+  ThreadTrace *trace = thread_trace_.trace;
+  std::lock_guard<std::mutex> lock(thread_names_mutex_);
+  trace->thread_name = name;
+}
+
+uint64_t Profiler::Now() {
+#if GLACEON_PROFILER_RDTSC
+  // assumes an invariant TSC (every x86-64 CPU of the last decade); EndSession() calibrates it against steady_clock
+  return __rdtsc();
+#else
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+/**
+ * @brief Appends a finished scope to the calling thread's buffer.  Lock free; does nothing when no session is running.
+ *
+ * @param name Scope name, must stay valid until the session ends.
+ * @param start Now() when the scope was entered.
+ * @param end Now() when the scope was left.
+ * @param track 0 to show the scope on the calling thread's row, or an id returned by RegisterTrack().
+ */
+void Profiler::RecordScope(const char *name, uint64_t start, uint64_t end, uint32_t track) {
+  RecordEvent(TraceEvent{name, start, end, nullptr, 0, track, TraceEventType::kScope});
+}
+
+/**
+ * @brief Records an allocation on the calling thread's row and in the allocator's memory counters.  Lock free; does
+ * nothing when no session is running.
+ *
+ * @param allocator Name of the allocator, must stay valid until the session ends (see InternName()).
+ * @param size Bytes allocated.
+ * @param used_memory The allocator's usage after the allocation, or -1 to count it as size bytes more than before.
+ * @param callsite Function that allocated, may be nullptr.
+ */
+void Profiler::RecordAllocation(const char *allocator, uint64_t size, int64_t used_memory, const char *callsite) {
+  if (!IsActive()) { return; }
+  RecordEvent(TraceEvent{allocator, Now(), size, callsite, used_memory, 0, TraceEventType::kAllocation});
+}
+
+void Profiler::RecordFree(const char *allocator, uint64_t size, int64_t used_memory, const char *callsite) {
+  if (!IsActive()) { return; }
+  RecordEvent(TraceEvent{allocator, Now(), size, callsite, used_memory, 0, TraceEventType::kFree});
+}
+
+const char *Profiler::InternName(const std::string &name) {
+  InternedNames &interned_names = GetInternedNames();
+  std::lock_guard<std::mutex> lock(interned_names.mutex);
+  return interned_names.names.insert(name).first->c_str();
+}
+
+static void RecordEvent(const TraceEvent &event) {
+  const uint32_t session_id = session_id_.load(std::memory_order_acquire);
+  if (session_id == 0 || recording_event_) { return; }
+  recording_event_ = true;
+
+  ThreadTrace &trace = *thread_trace_.trace;
+  if (trace.session_id.load(std::memory_order_relaxed) != session_id) {
+    // first event of this thread in the session, the events of the previous one have been written out already
+    trace.count.store(0, std::memory_order_relaxed);
+    trace.dropped.store(0, std::memory_order_relaxed);
+    trace.current = trace.first;
+    trace.session_id.store(session_id, std::memory_order_release);
+  }
+
+  const uint64_t count = trace.count.load(std::memory_order_relaxed);
+  if (count % kEventsPerChunk == 0) {
+    EventChunk *next = count == 0 ? trace.first : trace.current->next;
+    if (next == nullptr) {
+      if (trace.num_chunks == kMaxChunksPerThread) {
+        trace.dropped.store(trace.dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        recording_event_ = false;
+        return;
+      }
+      next = new EventChunk();
+      trace.num_chunks++;
+      if (count == 0) {
+        trace.first = next;
+      } else {
+        trace.current->next = next;
+      }
+    }
+    trace.current = next;
+  }
+
+  trace.current->events[count % kEventsPerChunk] = event;
+  trace.count.store(count + 1, std::memory_order_release);
+  recording_event_ = false;
+}
+
+}// namespace glaceon
@@ -0,0 +1,65 @@
+#ifndef GLACEON_GLACEON_PROFILER_PROFILER_H_
+#define GLACEON_GLACEON_PROFILER_PROFILER_H_
+
+#include <cstdint>
+#include <string>
+
+#include "../Core/Base.h"
+
+namespace glaceon {
+
+// Records timed scopes (see GLACEON_PROFILE_SCOPE) from any thread and writes them out as a Chrome Trace Event JSON
+// file, which can be opened in https://ui.perfetto.dev or chrome://tracing.
+//
+// Every thread appends to its own buffer, so recording a scope takes no lock and touches no shared cache line; when
+// no session is running a scope costs one relaxed atomic load.  Scope names are stored by pointer and must outlive
+// the session (string literals, __FUNCTION__).
+//
+// Allocations recorded with RecordAllocation()/RecordFree() (MemorySubsystem, named allocators and, when built with
+// GLACEON_TRACK_GLOBAL_NEW, operator new) end up on the same timeline, so allocation bursts line up with frame hitches.
+//
+// e.g. capture the next 300 frames into a file
+//  Profiler::BeginSession("glaceon_trace.json", 300);
+class GLACEON_API Profiler {
+ public:
+  // Starts recording; frame_count > 0 ends the session by itself after that many EndFrame() calls.  Returns false if
+  // a session is already running.
+  static bool BeginSession(const std::string &file_path, uint32_t frame_count = 0);
+  // Stops recording and writes the trace file.  Does nothing if no session is running.
+  static void EndSession();
+  [[nodiscard]] static bool IsActive();
+
+  // call once per frame from the main loop
+  static void EndFrame();
+  // name shown for the calling thread in the trace viewer
+  static void SetThreadName(const char *name);
+
+  // raw timestamp in ticks (rdtsc on x86-64, steady_clock nanoseconds elsewhere); only meaningful within a session
+  [[nodiscard]] static uint64_t Now();
+  // adds a finished scope to the calling thread's buffer; start and end come from Now().  track is 0 for the calling
+  // thread's own row in the trace, or an id from RegisterTrack() for scopes measured elsewhere (e.g. on the GPU)
+  static void RecordScope(const char *name, uint64_t start, uint64_t end, uint32_t track = 0);
+  // adds a named row to the trace for scopes that do not run on a CPU thread
+  [[nodiscard]] static uint32_t RegisterTrack(const char *name);
+  // Now() ticks per microsecond, measured against steady_clock since startup
+  [[nodiscard]] static double GetTicksPerMicrosecond();
+  // id of the running session, 0 if none.  Lets a scope tell whether it began in the session it ends in
+  [[nodiscard]] static uint32_t GetSessionId();
+
+  // Memory events, shown on the calling thread's row and summed up into per allocator "Memory" and "Allocations"
+  // counters.  allocator must outlive the session like a scope name.  used_memory is the allocator's usage after the
+  // event, or -1 to track it as the sum of the sizes allocated and freed during the session.
+  static void RecordAllocation(const char *allocator, uint64_t size, int64_t used_memory = -1, const char *callsite = nullptr);
+  static void RecordFree(const char *allocator, uint64_t size, int64_t used_memory = -1, const char *callsite = nullptr);
+  // a copy of name that stays valid until the process exits, for names built at runtime
+  [[nodiscard]] static const char *InternName(const std::string &name);
+
+  // operator new calls so far, counted by the GLACEON_TRACK_GLOBAL_NEW replacement whether or not a session is running;
+  // always 0 when built without it
+  [[nodiscard]] static uint64_t GetGlobalAllocationCount();
+  [[nodiscard]] static bool IsCountingGlobalAllocations();
+};
+
+}// namespace glaceon
+
+#endif// GLACEON_GLACEON_PROFILER_PROFILER_H_
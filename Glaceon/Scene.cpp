@@ -1,5 +1,7 @@
 #include "Scene.h"
 
+#include <utility>
+
 namespace glaceon {
 Scene::Scene() {
 
@@ -19,5 +21,6 @@ Scene::Scene() {
     for (float y = -1.0f; y < 1.0f; y += 0.2f) { star_positions_.emplace_back(x, y, z); }
   }
 }
-Scene::Scene(const Assimp_ModelData& model_data) { vertex_positions = model_data.vert_data; }
+Scene::Scene(const Assimp_ModelData& model_data) : vertex_positions(model_data.vert_data), vertex_indices(model_data.indices) {}
+Scene::Scene(MeshFile file) : mesh_file(std::move(file)) {}
 }// namespace glaceon
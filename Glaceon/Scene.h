@@ -1,6 +1,7 @@
 #ifndef GLACEON_GLACEON_SCENE_H_
 #define GLACEON_GLACEON_SCENE_H_
 #include "Assimp/AssimpImporter.h"
+#include "MeshFile.h"
 
 namespace glaceon {
 
@@ -9,12 +10,16 @@ class Scene {
  public:
   Scene();
   explicit Scene(const Assimp_ModelData &model_data);
+  explicit Scene(MeshFile file);
 
   std::vector<glm::vec3> triangle_positions_;
   std::vector<glm::vec3> square_positions_;
   std::vector<glm::vec3> star_positions_;
 
   std::vector<glm::vec3> vertex_positions;
+  std::vector<uint32_t> vertex_indices;// triangle lists into vertex_positions, as optimized on import
+  // a cooked mesh, drawn instead of vertex_positions when it is open
+  MeshFile mesh_file;
 };
 
 }// namespace glaceon
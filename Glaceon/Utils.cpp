@@ -1,6 +1,11 @@
 #include "Utils.h"
 
+#include <bit>
 #include <cstdint>
+#include <cstring>
+
+#include "Core/Logger.h"
+#include "Profiler/InstrumentationTimer.h"
 
 namespace glaceon {
 
@@ -9,25 +14,223 @@ bool CompareGlmVec3(const glm::vec3& a, const glm::vec3& b) {
   return false;
 }
 
-std::vector<uint32_t> GetIndexFromVertexData(const std::vector<glm::vec3>& vertexData, std::vector<glm::vec3>& uniqueVertex) {
-  if (vertexData.empty()) { return {}; }
+// Open addressing with linear probing over indexes of unique vertices, kept at most half full.  Each slot also keeps the
+// upper half of its hash so most mismatches are skipped without looking at the vertex.
+class WeldTable {
+ public:
+  explicit WeldTable(size_t count) : slots_(std::bit_ceil(std::max<size_t>(2 * count, 16))), mask_(slots_.size() - 1) {}
+
+  // calls visit(index) for every index stored under a hash equal to the given one, until it returns true
+  template<typename Visit>
+  void Probe(uint64_t hash, Visit&& visit) const {
+    const auto tag = static_cast<uint32_t>(hash >> 32);
+    for (size_t slot = hash & mask_; slots_[slot].index != kEmptySlot; slot = (slot + 1) & mask_) {
+      if (slots_[slot].tag == tag && visit(slots_[slot].index)) { return; }
+    }
+  }
+
+  void Insert(uint64_t hash, uint32_t index) {
+    size_t slot = hash & mask_;
+    while (slots_[slot].index != kEmptySlot) { slot = (slot + 1) & mask_; }
+    slots_[slot] = {index, static_cast<uint32_t>(hash >> 32)};
+  }
+
+ private:
+  static constexpr uint32_t kEmptySlot = UINT32_MAX;
+  struct Slot {
+    uint32_t index = kEmptySlot;
+    uint32_t tag = 0;
+  };
+
+  std::vector<Slot> slots_;
+  size_t mask_;
+};
+
+static uint64_t HashMix(uint64_t hash, uint64_t value) {
+  hash = (hash ^ value) * 0x9E3779B97F4A7C15ull;
+  return hash ^ (hash >> 29);
+}
+
+// + 0.0f turns -0 into 0, which compares equal to it
+static uint64_t HashPosition(const glm::vec3& position, uint64_t key) {
+  uint64_t hash = HashMix(key, std::bit_cast<uint32_t>(position.x + 0.0f));
+  hash = HashMix(hash, std::bit_cast<uint32_t>(position.y + 0.0f));
+  return HashMix(hash, std::bit_cast<uint32_t>(position.z + 0.0f));
+}
+
+using WeldCell = std::array<int64_t, 3>;
+
+static uint64_t HashCell(const WeldCell& cell, uint64_t key) {
+  uint64_t hash = HashMix(key, static_cast<uint64_t>(cell[0]));
+  hash = HashMix(hash, static_cast<uint64_t>(cell[1]));
+  return HashMix(hash, static_cast<uint64_t>(cell[2]));
+}
 
+static std::vector<uint32_t> WeldExact(const std::vector<glm::vec3>& positions, std::vector<glm::vec3>& unique_positions,
+                                       std::span<const uint64_t> keys) {
+  // without keys the positions already in unique_positions are welded against too, the earliest of equal ones first
+  const auto num_seeded = keys.empty() ? static_cast<uint32_t>(unique_positions.size()) : 0;
+  std::vector<uint64_t> unique_keys(keys.empty() ? 0 : unique_positions.size());
+  WeldTable table(num_seeded + positions.size());
+  for (uint32_t i = 0; i < num_seeded; i++) { table.Insert(HashPosition(unique_positions[i], 0), i); }
   std::vector<uint32_t> indexes;
-  for (glm::vec3 vec : vertexData) {
-    auto iter = std::ranges::find_if(uniqueVertex, [&](const glm::vec3& v) { return CompareGlmVec3(v, vec); });
-    if (iter == uniqueVertex.end()) {
-      // New unique vec3 found
-      uint32_t newIndex = uniqueVertex.size();
-      uniqueVertex.push_back(vec);
-      indexes.push_back(newIndex);
-    } else {
-      // Existing vec3 found
-      indexes.push_back(std::distance(uniqueVertex.begin(), iter));
+  indexes.reserve(positions.size());
+
+  for (size_t i = 0; i < positions.size(); i++) {
+    const glm::vec3& position = positions[i];
+    const uint64_t key = keys.empty() ? 0 : keys[i];
+    const uint64_t hash = HashPosition(position, key);
+
+    uint32_t found = UINT32_MAX;
+    table.Probe(hash, [&](uint32_t index) {
+      if (!CompareGlmVec3(unique_positions[index], position)) { return false; }
+      if (!keys.empty() && unique_keys[index] != key) { return false; }
+      found = index;
+      return true;
+    });
+
+    if (found == UINT32_MAX) {
+      found = static_cast<uint32_t>(unique_positions.size());
+      unique_positions.push_back(position);
+      if (!keys.empty()) { unique_keys.push_back(key); }
+      table.Insert(hash, found);
+    }
+    indexes.push_back(found);
+  }
+  return indexes;
+}
+
+// Spatial hash with cells twice epsilon wide, so anything within epsilon of a position is in one of the (at most) 2x2x2
+// cells its epsilon box overlaps.  Welding within a distance is not transitive, taking the earliest candidate keeps the
+// result independent of the table's layout.
+static std::vector<uint32_t> WeldWithinEpsilon(const std::vector<glm::vec3>& positions, std::vector<glm::vec3>& unique_positions,
+                                               std::span<const uint64_t> keys, float epsilon) {
+  const float inverse_cell_size = 0.5f / epsilon;
+  const auto num_seeded = keys.empty() ? static_cast<uint32_t>(unique_positions.size()) : 0;
+  std::vector<uint64_t> unique_keys(keys.empty() ? 0 : unique_positions.size());
+  std::vector<WeldCell> unique_cells(unique_positions.size());
+  WeldTable table(num_seeded + positions.size());
+  std::vector<uint32_t> indexes;
+  indexes.reserve(positions.size());
+
+  auto to_cell = [](const glm::vec3& scaled) -> WeldCell {
+    return {static_cast<int64_t>(scaled.x), static_cast<int64_t>(scaled.y), static_cast<int64_t>(scaled.z)};
+  };
+  // NaN and infinite positions, or ones too far out for a cell, never weld, like NaN never compares equal
+  auto get_cells = [&](const glm::vec3& position, WeldCell& cell, WeldCell& first, WeldCell& last) {
+    constexpr float kMaxCell = 4.0e18f;
+    const glm::vec3 low = glm::floor((position - glm::vec3(epsilon)) * inverse_cell_size);
+    const glm::vec3 high = glm::floor((position + glm::vec3(epsilon)) * inverse_cell_size);
+    if (!glm::all(glm::lessThan(glm::abs(low), glm::vec3(kMaxCell))) || !glm::all(glm::lessThan(glm::abs(high), glm::vec3(kMaxCell)))) {
+      return false;
+    }
+    cell = to_cell(glm::floor(position * inverse_cell_size));
+    first = to_cell(low);
+    last = to_cell(high);
+    return true;
+  };
+
+  // without keys the positions already in unique_positions are welded against too
+  for (uint32_t i = 0; i < num_seeded; i++) {
+    WeldCell first;
+    WeldCell last;
+    if (get_cells(unique_positions[i], unique_cells[i], first, last)) { table.Insert(HashCell(unique_cells[i], 0), i); }
+  }
+
+  for (size_t i = 0; i < positions.size(); i++) {
+    const glm::vec3& position = positions[i];
+    const uint64_t key = keys.empty() ? 0 : keys[i];
+
+    WeldCell cell = {};
+    WeldCell first;
+    WeldCell last;
+    const bool weldable = get_cells(position, cell, first, last);
+    uint32_t found = UINT32_MAX;
+    if (weldable) {
+      WeldCell neighbour;
+      for (neighbour[0] = first[0]; neighbour[0] <= last[0]; neighbour[0]++) {
+        for (neighbour[1] = first[1]; neighbour[1] <= last[1]; neighbour[1]++) {
+          for (neighbour[2] = first[2]; neighbour[2] <= last[2]; neighbour[2]++) {
+            table.Probe(HashCell(neighbour, key), [&](uint32_t index) {
+              if (index >= found || unique_cells[index] != neighbour || (!keys.empty() && unique_keys[index] != key)) { return false; }
+              const glm::vec3 distance = glm::abs(unique_positions[index] - position);
+              if (glm::all(glm::lessThanEqual(distance, glm::vec3(epsilon)))) { found = index; }
+              return false;
+            });
+          }
+        }
+      }
+    }
+
+    if (found == UINT32_MAX) {
+      found = static_cast<uint32_t>(unique_positions.size());
+      unique_positions.push_back(position);
+      unique_cells.push_back(cell);
+      if (!keys.empty()) { unique_keys.push_back(key); }
+      if (weldable) { table.Insert(HashCell(cell, key), found); }
     }
+    indexes.push_back(found);
   }
   return indexes;
 }
 
+/**
+ * @brief Welds positions into unique_positions, see the header.  Both paths are a single pass over the positions with
+ * a constant number of expected probes each.
+ *
+ * @param positions The vertex positions.
+ * @param unique_positions Receives the unique positions.
+ * @param options Epsilon and attribute keys.
+ * @return One index into unique_positions per position.
+ */
+std::vector<uint32_t> WeldVertices(const std::vector<glm::vec3>& positions, std::vector<glm::vec3>& unique_positions,
+                                   const VertexWeldOptions& options) {
+  GLACEON_PROFILE_FUNCTION();
+  if (positions.empty()) { return {}; }
+  if (!options.attribute_keys.empty() && options.attribute_keys.size() != positions.size()) {
+    GERROR("WeldVertices: {} attribute keys for {} positions", options.attribute_keys.size(), positions.size());
+    return {};
+  }
+
+  if (options.epsilon > 0.0f) { return WeldWithinEpsilon(positions, unique_positions, options.attribute_keys, options.epsilon); }
+  return WeldExact(positions, unique_positions, options.attribute_keys);
+}
+
+// one lane step and the final avalanche of xxHash64
+static constexpr uint64_t kHashPrime1 = 0x9E3779B185EBCA87ull;
+static constexpr uint64_t kHashPrime2 = 0xC2B2AE3D27D4EB4Full;
+
+static uint64_t HashRound(uint64_t lane, uint64_t word) { return std::rotl(lane + word * kHashPrime2, 31) * kHashPrime1; }
+
+static uint64_t LoadWord(const std::byte* bytes) {
+  uint64_t word;
+  std::memcpy(&word, bytes, sizeof(word));// little endian, the only byte order Glaceon builds for
+  return word;
+}
+
+uint64_t HashBytes(std::span<const std::byte> bytes, uint64_t seed) {
+  const std::byte* data = bytes.data();
+  const size_t size = bytes.size();
+  size_t offset = 0;
+
+  uint64_t hash = seed + kHashPrime1;
+  if (size >= 32) {
+    uint64_t lanes[4] = {seed + kHashPrime1 + kHashPrime2, seed + kHashPrime2, seed, seed - kHashPrime1};
+    for (; offset + 32 <= size; offset += 32) {
+      for (size_t lane = 0; lane < 4; lane++) { lanes[lane] = HashRound(lanes[lane], LoadWord(data + offset + 8 * lane)); }
+    }
+    hash = std::rotl(lanes[0], 1) + std::rotl(lanes[1], 7) + std::rotl(lanes[2], 12) + std::rotl(lanes[3], 18);
+  }
+
+  for (; offset + 8 <= size; offset += 8) { hash = std::rotl(hash ^ HashRound(0, LoadWord(data + offset)), 27) * kHashPrime1; }
+  for (; offset < size; offset++) { hash = std::rotl(hash ^ (static_cast<uint64_t>(data[offset]) * kHashPrime1), 11) * kHashPrime2; }
+
+  hash ^= size;
+  hash = (hash ^ (hash >> 33)) * kHashPrime2;
+  hash = (hash ^ (hash >> 29)) * kHashPrime1;
+  return hash ^ (hash >> 32);
+}
+
 void* AlignAddress(void* address, uint32_t alignment) {
   const size_t kM = alignment - 1;
   // cast to uintptr_t so that the + operation works; doing pointer arithmetic on a void* is undefined behavior
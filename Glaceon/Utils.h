@@ -1,6 +1,11 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "Core/Base.h"
 #include "pch.h"
 
 namespace glaceon {
@@ -16,17 +21,45 @@ namespace glaceon {
  */
 bool CompareGlmVec3(const glm::vec3& a, const glm::vec3& b);
 
+// Options for WeldVertices()
+struct VertexWeldOptions {
+  // 0 merges equal positions only; above 0 merges positions at most epsilon apart on every axis
+  float epsilon = 0.0f;
+  // empty, or one key per vertex (e.g. a hash of its normal and UV): vertices only merge when their keys match too
+  std::span<const uint64_t> attribute_keys;
+};
+
 /**
- * Generates a vector of unique indices for each vertex in the given vertex data.
+ * Welds duplicate vertices into unique ones and returns an index per input vertex, in O(n).
+ *
+ * Positions are looked up in an open-addressing hash table, keyed on the position's bits for exact welding or on the
+ * epsilon-sized grid cell it falls in otherwise.  The result only depends on the input order: a unique vertex is the
+ * first one of its group, unique vertices are in the order they first appear, and with an epsilon a vertex merges
+ * into the earliest unique vertex within reach.
+ *
+ * Without attribute keys, positions already in unique_positions are candidates as well and come before the new ones,
+ * so exact welding gives the same indexes as searching unique_positions from the front for every position.  With
+ * attribute keys only the positions added by this call are welded against, the existing ones have no keys.
  *
- * @param vertexData The vector of glm::vec3 vertices.
- * @param uniqueVertex The vector to store the unique vertices.
+ * @param positions The vertex positions.
+ * @param unique_positions Receives the unique positions, appended after anything already in it.
+ * @param options Epsilon and attribute keys, see VertexWeldOptions.
+ *
+ * @return One index into unique_positions per position.
+ */
+std::vector<uint32_t> GLACEON_API WeldVertices(const std::vector<glm::vec3>& positions, std::vector<glm::vec3>& unique_positions,
+                                               const VertexWeldOptions& options = {});
+
+/**
+ * 64-bit hash of a block of bytes, e.g. a file's contents as a cache key.  Reads eight bytes at a time over four
+ * independent lanes, so it runs at memory speed; fine against accidental collisions, not against deliberate ones.
  *
- * @return A vector of uint32_t indices corresponding to the unique vertices in the vertexData vector.
+ * @param bytes The bytes to hash.
+ * @param seed Starting value, different seeds give unrelated hashes of the same bytes.
  *
- * @throws None
+ * @return The hash, the same on every run and platform.
  */
-std::vector<uint32_t> GetIndexFromVertexData(const std::vector<glm::vec3>& vertexData, std::vector<glm::vec3>& uniqueVertex);
+uint64_t GLACEON_API HashBytes(std::span<const std::byte> bytes, uint64_t seed = 0);
 
 /**
  * @brief Aligns a memory address to a specified alignment.
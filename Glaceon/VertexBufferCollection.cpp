@@ -1,13 +1,18 @@
 #include "VertexBufferCollection.h"
 
 #include "Core/Logger.h"
+#include "Profiler/InstrumentationTimer.h"
 #include "VulkanRenderer/VulkanBase.h"
 #include "VulkanRenderer/VulkanUtils.h"
 
 namespace glaceon {
-VertexBufferCollection::VertexBufferCollection() : offset_(0) {}
+VertexBufferCollection::VertexBufferCollection(std::pmr::memory_resource *resource)
+    : offset_(0),
+      vertices_(resource),
+      indexes_(resource) {}
 VertexBufferCollection::~VertexBufferCollection() {
-  VK_ASSERT(vk_device_ != VK_NULL_HANDLE, "Logical device is null");
+  // never finalized, e.g. only built on the CPU by GlaceonPerfTests; nothing on the device to free
+  if (vk_device_ == VK_NULL_HANDLE) { return; }
 
   vk_device_.destroyBuffer(vertex_buffer_.buffer);
   vk_device_.freeMemory(vertex_buffer_.buffer_memory);
@@ -21,6 +26,7 @@ VertexBufferCollection::~VertexBufferCollection() {
 }
 
 void VertexBufferCollection::Add(MeshType type, const std::vector<float> &verticies, const std::vector<uint32_t> &indexes) {
+  GLACEON_PROFILE_FUNCTION();
   // divide by 7 to get the number of vertices, since vectors will be structured as (x, y, r, g, b, u, v)
   int vertex_count = static_cast<int>(verticies.size() / 7);
   int index_count = static_cast<int>(indexes.size());// Total number of indexes to draw
@@ -35,6 +41,7 @@ void VertexBufferCollection::Add(MeshType type, const std::vector<float> &vertic
 }
 
 void VertexBufferCollection::Add(const std::vector<glm::vec3> &verticies, const std::vector<uint32_t> &indexes) {
+  GLACEON_PROFILE_FUNCTION();
   int vertex_count = static_cast<int>(verticies.size());
   int index_count = static_cast<int>(indexes.size());
   int last_index = static_cast<int>(indexes_.size());
@@ -52,6 +59,7 @@ void VertexBufferCollection::Add(const std::vector<glm::vec3> &verticies, const
 
 void VertexBufferCollection::Finalize(vk::Device logical_device, vk::PhysicalDevice physical_device, vk::Queue queue,
                                       vk::CommandBuffer command_buffer) {
+  GLACEON_PROFILE_FUNCTION();
   vk_device_ = logical_device;
 
   if (vertices_.empty()) {
@@ -59,15 +67,41 @@ void VertexBufferCollection::Finalize(vk::Device logical_device, vk::PhysicalDev
     return;
   }
 
+  Upload(std::as_bytes(std::span(vertices_)), std::as_bytes(std::span(indexes_)), logical_device, physical_device, queue, command_buffer);
+}
+
+void VertexBufferCollection::Finalize(MeshType type, std::span<const glm::vec3> vertices, std::span<const uint32_t> indexes,
+                                      vk::Device logical_device, vk::PhysicalDevice physical_device, vk::Queue queue,
+                                      vk::CommandBuffer command_buffer) {
+  GLACEON_PROFILE_FUNCTION();
+  vk_device_ = logical_device;
+
+  if (vertices.empty() || indexes.empty()) {
+    GERROR("Cannot finialize vertex buffer collection as no verticies were given.");
+    return;
+  }
+
+  first_indexes_[type] = 0;
+  index_counts_[type] = static_cast<int>(indexes.size());
+  Upload(std::as_bytes(vertices), std::as_bytes(indexes), logical_device, physical_device, queue, command_buffer);
+}
+
+/**
+ * @brief Copies the vertex and index data into staging buffers and from there into device local vertex and index buffers.
+ *
+ * The data is read once, by the memcpy into the staging buffer, so it may point straight into a mapped file.
+ */
+void VertexBufferCollection::Upload(std::span<const std::byte> vertices, std::span<const std::byte> indexes, vk::Device logical_device,
+                                    vk::PhysicalDevice physical_device, vk::Queue queue, vk::CommandBuffer command_buffer) {
   // ----------- Vertex Buffer Transfer ------------
-  VulkanUtils::BufferInputParams params = {logical_device, physical_device, vertices_.size() * sizeof(float), vk::BufferUsageFlagBits::eTransferSrc,
+  VulkanUtils::BufferInputParams params = {logical_device, physical_device, vertices.size(), vk::BufferUsageFlagBits::eTransferSrc,
                                            vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent};
 
   VulkanUtils::Buffer staging_buffer = VulkanUtils::CreateBuffer(params);
 
   // map a memory location to the buffer
   void *memory_loc = logical_device.mapMemory(staging_buffer.buffer_memory, 0, VK_WHOLE_SIZE, {});
-  memcpy(memory_loc, vertices_.data(), vertices_.size() * sizeof(float));
+  memcpy(memory_loc, vertices.data(), vertices.size());
   logical_device.unmapMemory(staging_buffer.buffer_memory);
 
   // copy from staging buffer (host local memory) to vertex buffer (device local memory)
@@ -75,19 +109,19 @@ void VertexBufferCollection::Finalize(vk::Device logical_device, vk::PhysicalDev
   params.buffer_usage = vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer;
   vertex_buffer_ = VulkanUtils::CreateBuffer(params);
 
-  VulkanUtils::CopyBuffer(staging_buffer, vertex_buffer_, vertices_.size() * sizeof(float), queue, command_buffer);
+  VulkanUtils::CopyBuffer(staging_buffer, vertex_buffer_, vertices.size(), queue, command_buffer);
 
   logical_device.destroyBuffer(staging_buffer.buffer);
   logical_device.freeMemory(staging_buffer.buffer_memory);
 
   // ----------- Index Buffer Transfer ------------
-  params = {logical_device, physical_device, indexes_.size() * sizeof(uint32_t), vk::BufferUsageFlagBits::eTransferSrc,
+  params = {logical_device, physical_device, indexes.size(), vk::BufferUsageFlagBits::eTransferSrc,
             vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent};
 
   staging_buffer = VulkanUtils::CreateBuffer(params);
 
   memory_loc = logical_device.mapMemory(staging_buffer.buffer_memory, 0, VK_WHOLE_SIZE, {});
-  memcpy(memory_loc, indexes_.data(), indexes_.size() * sizeof(uint32_t));
+  memcpy(memory_loc, indexes.data(), indexes.size());
   logical_device.unmapMemory(staging_buffer.buffer_memory);
 
   // copy from staging buffer to index buffer
@@ -95,7 +129,7 @@ void VertexBufferCollection::Finalize(vk::Device logical_device, vk::PhysicalDev
   params.buffer_usage = vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndexBuffer;
   index_buffer_ = VulkanUtils::CreateBuffer(params);
 
-  VulkanUtils::CopyBuffer(staging_buffer, index_buffer_, indexes_.size(), queue, command_buffer);
+  VulkanUtils::CopyBuffer(staging_buffer, index_buffer_, indexes.size(), queue, command_buffer);
 
   logical_device.destroyBuffer(staging_buffer.buffer);
   logical_device.freeMemory(staging_buffer.buffer_memory);
@@ -1,8 +1,12 @@
 #ifndef GLACEON_GLACEON_VERTEXBUFFERCOLLECTION_H_
 #define GLACEON_GLACEON_VERTEXBUFFERCOLLECTION_H_
 
+#include <cstddef>
 #include <cstdint>
+#include <memory_resource>
+#include <span>
 
+#include "Core/Base.h"
 #include "VulkanRenderer/VulkanUtils.h"
 #include "pch.h"
 
@@ -10,9 +14,10 @@ namespace glaceon {
 
 // When we get a bunch of textures and put them on together into a single texture,
 // we call that an atlas of textures or we are going to call it just a collection of vertex buffers
-class VertexBufferCollection {
+class GLACEON_API VertexBufferCollection {
  public:
-  VertexBufferCollection();
+  // resource backs the CPU-side vertex/index staging vectors, e.g. an AllocatorResource over a LinearAllocator
+  explicit VertexBufferCollection(std::pmr::memory_resource *resource = std::pmr::get_default_resource());
   ~VertexBufferCollection();
 
   void Add(MeshType type, const std::vector<float> &verticies, const std::vector<uint32_t> &indexes);
@@ -20,6 +25,10 @@ class VertexBufferCollection {
 
   // Finalizes the collection of vertex buffers, actually allocates the memory
   void Finalize(vk::Device logical_device, vk::PhysicalDevice physical_device, vk::Queue queue, vk::CommandBuffer command_buffer);
+  // Uploads vertex data that is already laid out as Add() would have, e.g. straight from the pages of a mapped
+  // MeshFile, as the collection's only mesh; indexes are into all of vertices
+  void Finalize(MeshType type, std::span<const glm::vec3> vertices, std::span<const uint32_t> indexes, vk::Device logical_device,
+                vk::PhysicalDevice physical_device, vk::Queue queue, vk::CommandBuffer command_buffer);
 
   VulkanUtils::Buffer vertex_buffer_;
   VulkanUtils::Buffer index_buffer_;
@@ -28,10 +37,13 @@ class VertexBufferCollection {
   std::unordered_map<MeshType, int> index_counts_;
 
  private:
+  void Upload(std::span<const std::byte> vertices, std::span<const std::byte> indexes, vk::Device logical_device,
+              vk::PhysicalDevice physical_device, vk::Queue queue, vk::CommandBuffer command_buffer);
+
   int offset_;
   vk::Device vk_device_;
-  std::vector<float> vertices_;
-  std::vector<uint32_t> indexes_;
+  std::pmr::vector<float> vertices_;
+  std::pmr::vector<uint32_t> indexes_;
 };
 
 }// namespace glaceon
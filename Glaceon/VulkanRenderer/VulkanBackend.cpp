@@ -31,7 +31,7 @@ void VulkanBackend::Initialize() {
   // if not remove it from the vector
   for (const char *layer : validation_layers) {
     if (!IsLayerAvailable(layer_properties, layer)) {
-      GERROR("Validation layer {} not available", layer);
+      GERROR_CH(Renderer, "Validation layer {} not available", layer);
       std::erase(validation_layers, layer);
     }
   }
@@ -58,6 +58,8 @@ void VulkanBackend::Initialize() {
 #endif
 
   requested_extensions.push_back(vk::KHRPortabilityEnumerationExtensionName);
+  // VK_EXT_memory_budget needs it on a Vulkan 1.0 instance
+  requested_extensions.push_back(vk::KHRGetPhysicalDeviceProperties2ExtensionName);
 
   uint32_t property_count = 0;
   (void) vk::enumerateInstanceExtensionProperties(nullptr, &property_count, nullptr);
@@ -71,20 +73,20 @@ void VulkanBackend::Initialize() {
   instance_extensions.insert(instance_extensions.end(), requested_extensions.begin(), requested_extensions.end());
 
   // check if extensions are available, remove if not
-  for (auto &extension : instance_extensions) {
-    if (!IsExtensionAvailable(properties, extension)) {
-      GERROR("Extension {} not available", extension);
-      std::erase(instance_extensions, extension);
-    }
-  }
+  std::erase_if(instance_extensions, [&properties](const char *extension) {
+    if (IsExtensionAvailable(properties, extension)) { return false; }
+    GERROR_CH(Renderer, "Extension {} not available", extension);
+    return true;
+  });
   instance_create_info.enabledExtensionCount = static_cast<uint32_t>(instance_extensions.size());
   instance_create_info.ppEnabledExtensionNames = instance_extensions.data();
 
   if (vk::createInstance(&instance_create_info, nullptr, &instance_) != vk::Result::eSuccess) {
-    GERROR("Failed to create Vulkan instance");
+    GERROR_CH(Renderer, "Failed to create Vulkan instance");
     return;
   }
-  GINFO("Successfully created Vulkan instance");
+  enabled_extensions_ = std::move(instance_extensions);
+  GINFO_CH(Renderer, "Successfully created Vulkan instance");
 }
 
 VkBool32 VulkanBackend::DebugCallback(VkDebugUtilsMessageSeverityFlagBitsEXT message_severity,
@@ -92,17 +94,17 @@ VkBool32 VulkanBackend::DebugCallback(VkDebugUtilsMessageSeverityFlagBitsEXT mes
                                       const VkDebugUtilsMessengerCallbackDataEXT *p_callback_data, [[maybe_unused]] void *p_user_data) {
   switch (message_severity) {
     case VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT:
-      GTRACE("Validation layer: {}", p_callback_data->pMessage);
+      GTRACE_CH(Renderer, "Validation layer: {}", p_callback_data->pMessage);
       break;
     case VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT:
-      GINFO("Validation layer: {}", p_callback_data->pMessage);
+      GINFO_CH(Renderer, "Validation layer: {}", p_callback_data->pMessage);
       break;
     case VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT:
-      GWARN("Validation layer: {}", p_callback_data->pMessage);
+      GWARN_CH(Renderer, "Validation layer: {}", p_callback_data->pMessage);
       break;
     case VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT:
     default:
-      GERROR("Validation layer: {}", p_callback_data->pMessage);
+      GERROR_CH(Renderer, "Validation layer: {}", p_callback_data->pMessage);
       break;
   }
 
@@ -115,6 +117,14 @@ void VulkanBackend::Destroy() {
     instance_.destroy();
     instance_ = VK_NULL_HANDLE;
   }
+  enabled_extensions_.clear();
+}
+
+bool VulkanBackend::IsInstanceExtensionEnabled(const char *extension) const {
+  for (const char *enabled_extension : enabled_extensions_) {
+    if (strcmp(enabled_extension, extension) == 0) { return true; }
+  }
+  return false;
 }
 bool VulkanBackend::IsLayerAvailable(const std::vector<vk::LayerProperties> &layers, const char *layer_to_check) {
   for (const auto &kLayer : layers) {
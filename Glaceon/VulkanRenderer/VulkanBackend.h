@@ -16,10 +16,13 @@ class VulkanBackend {
   void Destroy();
 
   [[nodiscard]] const vk::Instance &GetVkInstance() const { return instance_; }
+  // whether the instance was created with the extension; requested ones are left out when not available
+  [[nodiscard]] bool IsInstanceExtensionEnabled(const char *extension) const;
 
  private:
   VulkanContext &context_;
   vk::Instance instance_;
+  std::vector<const char *> enabled_extensions_;
 
   static bool IsLayerAvailable(const std::vector<vk::LayerProperties> &layers, const char *layer_to_check);
   static bool IsExtensionAvailable(const std::vector<vk::ExtensionProperties> &all_extensions, const char *extension_to_check);
@@ -5,8 +5,8 @@ namespace glaceon {
 template<typename T>
 void CheckVkResult(T result, const char* msg) {
   if (static_cast<int>(result) < 0) {
-    GERROR("Vulkan error: {}", msg);
-    GERROR("Vulkan Validation error: {}", vk::to_string(static_cast<vk::Result>(result)));
+    GERROR_CH(Renderer, "Vulkan error: {}", msg);
+    GERROR_CH(Renderer, "Vulkan Validation error: {}", vk::to_string(static_cast<vk::Result>(result)));
     exit(EXIT_FAILURE);
   }
 }
@@ -18,7 +18,7 @@ void CheckVkResult(T result, const char* msg) {
 #define VK_ASSERT(expr, msg)               \
   do {                                     \
     if (!(expr)) {                         \
-      GERROR("Assertion failed: {}", msg); \
+      GERROR_CH(Renderer, "Assertion failed: {}", msg); \
       exit(EXIT_FAILURE);                  \
     }                                      \
   } while (0)
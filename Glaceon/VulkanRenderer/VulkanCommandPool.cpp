@@ -20,10 +20,10 @@ void VulkanCommandPool::Initialize() {
   command_pool_create_info.flags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer;
   command_pool_create_info.queueFamilyIndex = context_.GetQueueIndexes().graphics_family.value();
   if (device.createCommandPool(&command_pool_create_info, nullptr, &vk_command_pool_) != vk::Result::eSuccess) {
-    GERROR("Failed to create command pool");
+    GERROR_CH(Renderer, "Failed to create command pool");
     return;
   }
-  GINFO("Successfully created command pool");
+  GINFO_CH(Renderer, "Successfully created command pool");
 
   // initialize main command buffer
   vk::CommandBufferAllocateInfo allocate_info = {};
@@ -32,10 +32,10 @@ void VulkanCommandPool::Initialize() {
   allocate_info.commandPool = vk_command_pool_;
   allocate_info.commandBufferCount = 1;
   if (device.allocateCommandBuffers(&allocate_info, &vk_main_command_buffer_) != vk::Result::eSuccess) {
-    GERROR("Failed to allocate main command buffer");
+    GERROR_CH(Renderer, "Failed to allocate main command buffer");
     return;
   }
-  GINFO("Successfully allocated main command buffer");
+  GINFO_CH(Renderer, "Successfully allocated main command buffer");
 
   // create command buffer for each swap chain frame
   std::vector<SwapChainFrame> swap_chain_frames = context_.GetVulkanSwapChain().GetSwapChainFrames();
@@ -43,12 +43,12 @@ void VulkanCommandPool::Initialize() {
   // Allocate command buffers outside the loop
   for (size_t i = 0; i < swap_chain_frames.size(); ++i) {
     if (device.allocateCommandBuffers(&allocate_info, &vk_frame_command_buffers_[i]) != vk::Result::eSuccess) {
-      GERROR("Failed to allocate command buffer for swap chain frame");
+      GERROR_CH(Renderer, "Failed to allocate command buffer for swap chain frame");
       return;
     }
   }
 
-  GINFO("Successfully allocated command buffers for swap chain frames");
+  GINFO_CH(Renderer, "Successfully allocated command buffers for swap chain frames");
 }
 
 void VulkanCommandPool::Destroy() {
@@ -86,17 +86,17 @@ void VulkanCommandPool::RebuildCommandBuffers() {
   command_buffer_allocate_info.commandBufferCount = 1;
 
   if (device.allocateCommandBuffers(&command_buffer_allocate_info, &vk_main_command_buffer_) != vk::Result::eSuccess) {
-    GERROR("Failed to allocate main command buffer");
+    GERROR_CH(Renderer, "Failed to allocate main command buffer");
     return;
   }
 
   for (size_t i = 0; i < swap_chain_frames.size(); ++i) {
     // allocate command buffers for each swap chain frame
     if (device.allocateCommandBuffers(&command_buffer_allocate_info, &vk_frame_command_buffers_[i]) != vk::Result::eSuccess) {
-      GERROR("Failed to allocate command buffer for swap chain frame");
+      GERROR_CH(Renderer, "Failed to allocate command buffer for swap chain frame");
       return;
     }
   }
-  GINFO("Successfully rebuilt command buffers");
+  GINFO_CH(Renderer, "Successfully rebuilt command buffers");
 }
 }// namespace glaceon
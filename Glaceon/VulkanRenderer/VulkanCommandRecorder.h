@@ -0,0 +1,71 @@
+#ifndef GLACEON_GLACEON_VULKANRENDERER_VULKANCOMMANDRECORDER_H_
+#define GLACEON_GLACEON_VULKANRENDERER_VULKANCOMMANDRECORDER_H_
+
+#include "../pch.h"
+
+namespace glaceon {
+
+// what one frame's command buffer asked the GPU to do
+struct DrawCounters {
+  uint32_t draw_calls = 0;
+  uint32_t instances = 0;
+  uint64_t triangles = 0;// assumes triangle list topology, the only one VulkanPipeline creates
+  uint32_t pipeline_binds = 0;
+  uint32_t descriptor_set_binds = 0;
+  uint32_t vertex_buffer_binds = 0;
+  uint32_t index_buffer_binds = 0;
+};
+
+// Records into a vk::CommandBuffer and counts the draws and binds it forwards.  Only the commands the renderer uses
+// are wrapped; anything else goes through GetCommandBuffer() and is not counted.
+class VulkanCommandRecorder {
+ public:
+  VulkanCommandRecorder(vk::CommandBuffer command_buffer, DrawCounters &counters) : command_buffer_(command_buffer), counters_(counters) {}
+
+  [[nodiscard]] vk::CommandBuffer GetCommandBuffer() const { return command_buffer_; }
+
+  void BindPipeline(vk::PipelineBindPoint bind_point, vk::Pipeline pipeline) {
+    command_buffer_.bindPipeline(bind_point, pipeline);
+    counters_.pipeline_binds++;
+  }
+
+  void BindDescriptorSets(vk::PipelineBindPoint bind_point, vk::PipelineLayout layout, uint32_t first_set, uint32_t set_count,
+                          const vk::DescriptorSet *sets, uint32_t dynamic_offset_count = 0, const uint32_t *dynamic_offsets = nullptr) {
+    command_buffer_.bindDescriptorSets(bind_point, layout, first_set, set_count, sets, dynamic_offset_count, dynamic_offsets);
+    counters_.descriptor_set_binds += set_count;
+  }
+
+  void BindVertexBuffers(uint32_t first_binding, uint32_t binding_count, const vk::Buffer *buffers, const vk::DeviceSize *offsets) {
+    command_buffer_.bindVertexBuffers(first_binding, binding_count, buffers, offsets);
+    counters_.vertex_buffer_binds += binding_count;
+  }
+
+  void BindIndexBuffer(vk::Buffer buffer, vk::DeviceSize offset, vk::IndexType index_type) {
+    command_buffer_.bindIndexBuffer(buffer, offset, index_type);
+    counters_.index_buffer_binds++;
+  }
+
+  void Draw(uint32_t vertex_count, uint32_t instance_count, uint32_t first_vertex, uint32_t first_instance) {
+    command_buffer_.draw(vertex_count, instance_count, first_vertex, first_instance);
+    CountDraw(vertex_count, instance_count);
+  }
+
+  void DrawIndexed(uint32_t index_count, uint32_t instance_count, uint32_t first_index, int32_t vertex_offset, uint32_t first_instance) {
+    command_buffer_.drawIndexed(index_count, instance_count, first_index, vertex_offset, first_instance);
+    CountDraw(index_count, instance_count);
+  }
+
+ private:
+  void CountDraw(uint32_t vertex_count, uint32_t instance_count) {
+    counters_.draw_calls++;
+    counters_.instances += instance_count;
+    counters_.triangles += static_cast<uint64_t>(vertex_count / 3) * instance_count;
+  }
+
+  vk::CommandBuffer command_buffer_;
+  DrawCounters &counters_;
+};
+
+}// namespace glaceon
+
+#endif// GLACEON_GLACEON_VULKANRENDERER_VULKANCOMMANDRECORDER_H_
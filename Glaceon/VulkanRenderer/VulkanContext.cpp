@@ -11,7 +11,9 @@ VulkanContext::VulkanContext()
       pipeline_(*this),
       command_pool_(*this),
       descriptor_pool_(*this),
-      sync_(*this) {}
+      sync_(*this),
+      gpu_profiler_(*this),
+      render_stats_(*this) {}
 
 VulkanContext::~VulkanContext() { Destroy(); }
 
@@ -27,12 +29,15 @@ void VulkanContext::RemoveInstanceExtension(const char *ext) {
 }
 
 void VulkanContext::Destroy() {
+  render_stats_.Destroy();
+  gpu_profiler_.Destroy();
   sync_.Destroy();
   command_pool_.Destroy();
   descriptor_pool_.Destroy();
   pipeline_.Destroy();
   render_pass_.Destroy();
   swap_chain_.Destroy();
+  memory_allocator_.Destroy();
   device_.Destroy();
   if (surface_ != VK_NULL_HANDLE) {
     backend_.GetVkInstance().destroy(surface_, nullptr);
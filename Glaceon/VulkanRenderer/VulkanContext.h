@@ -6,9 +6,11 @@
 #include "VulkanCommandPool.h"
 #include "VulkanDescriptorPool.h"
 #include "VulkanDevice.h"
+#include "VulkanGpuProfiler.h"
 #include "VulkanMemoryAllocator.h"
 #include "VulkanPipeline.h"
 #include "VulkanRenderPass.h"
+#include "VulkanRenderStats.h"
 #include "VulkanSwapChain.h"
 #include "VulkanSync.h"
 
@@ -44,6 +46,8 @@ class VulkanContext {
   VulkanCommandPool &GetVulkanCommandPool() { return command_pool_; }
   VulkanDescriptorPool &GetVulkanDescriptorPool() { return descriptor_pool_; }
   VulkanSync &GetVulkanSync() { return sync_; }
+  VulkanGpuProfiler &GetVulkanGpuProfiler() { return gpu_profiler_; }
+  VulkanRenderStats &GetVulkanRenderStats() { return render_stats_; }
 
   void Destroy();
 
@@ -61,6 +65,8 @@ class VulkanContext {
   VulkanDescriptorPool descriptor_pool_;
 
   VulkanSync sync_;
+  VulkanGpuProfiler gpu_profiler_;
+  VulkanRenderStats render_stats_;
 
   vk::SurfaceKHR surface_ = VK_NULL_HANDLE;
 
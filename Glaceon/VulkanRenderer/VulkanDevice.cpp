@@ -14,9 +14,9 @@ VulkanDevice::VulkanDevice(VulkanContext &context) : context_(context) {
 VulkanDevice::~VulkanDevice() { Destroy(); }
 
 void VulkanDevice::Initialize() {
-  GINFO("Initializing Vulkan device...");
+  GINFO_CH(Renderer, "Initializing Vulkan device...");
   if (context_.GetVulkanInstance() == VK_NULL_HANDLE) {
-    GERROR("Vulkan instance not initialized; cannot initialize device");
+    GERROR_CH(Renderer, "Vulkan instance not initialized; cannot initialize device");
     return;
   }
 
@@ -29,18 +29,22 @@ void VulkanDevice::Initialize() {
   gpus.resize(gpu_count);
   VK_CHECK(instance.enumeratePhysicalDevices(&gpu_count, gpus.data()), "Failed to enumerate physical devices info");
 
-  for (vk::PhysicalDevice &gpu : gpus) {
-    if (CheckDeviceRequirements(gpu)) {
-      vk_physical_device_ = gpu;
-      break;
+  // prefer a discrete GPU, otherwise take whatever can render (integrated GPUs, lavapipe on CI machines)
+  for (bool require_discrete : {true, false}) {
+    for (vk::PhysicalDevice &gpu : gpus) {
+      if (CheckDeviceRequirements(gpu, require_discrete)) {
+        vk_physical_device_ = gpu;
+        break;
+      }
     }
+    if (vk_physical_device_ != VK_NULL_HANDLE) { break; }
   }
 
   if (vk_physical_device_ == VK_NULL_HANDLE) {
-    GERROR("Failed to find a suitable GPU");
+    GERROR_CH(Renderer, "Failed to find a suitable GPU");
     return;
   }
-  GINFO("Successfully found discrete GPU");
+  GINFO_CH(Renderer, "Successfully found GPU");
   PrintPhysicalDevice(vk_physical_device_);
 
   constexpr float kQueuePriority[] = {1.0f};
@@ -63,19 +67,32 @@ void VulkanDevice::Initialize() {
   create_info.sType = vk::StructureType::eDeviceCreateInfo;
   create_info.queueCreateInfoCount = static_cast<uint32_t>(queue_create_info.size());
   create_info.pQueueCreateInfos = queue_create_info.data();
-  create_info.enabledExtensionCount = static_cast<uint32_t>(context_.GetDeviceExtensions().size());
-  create_info.ppEnabledExtensionNames = context_.GetDeviceExtensions().data();
+
+  // optional extensions, like the features below
+  std::vector<const char *> extensions = context_.GetDeviceExtensions();
+  memory_budget_supported_ = IsExtensionAvailable(vk::EXTMemoryBudgetExtensionName)
+      && context_.GetVulkanBackend().IsInstanceExtensionEnabled(vk::KHRGetPhysicalDeviceProperties2ExtensionName);
+  if (memory_budget_supported_) { extensions.push_back(vk::EXTMemoryBudgetExtensionName); }
+  create_info.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+  create_info.ppEnabledExtensionNames = extensions.data();
+
+  // optional features, their users check the getters before relying on them
+  const vk::PhysicalDeviceFeatures supported_features = vk_physical_device_.getFeatures();
+  vk::PhysicalDeviceFeatures enabled_features = {};
+  enabled_features.pipelineStatisticsQuery = supported_features.pipelineStatisticsQuery;
+  pipeline_statistics_query_supported_ = supported_features.pipelineStatisticsQuery == VK_TRUE;
+  create_info.pEnabledFeatures = &enabled_features;
 
   VK_CHECK(vk_physical_device_.createDevice(&create_info, nullptr, &vk_device_), "Failed to create Vulkan device");
-  GINFO("Successfully created Vulkan device");
+  GINFO_CH(Renderer, "Successfully created Vulkan device");
 
   vk_device_.getQueue(queue_indexes_.graphics_family.value(), 0, &vk_graphics_queue_);
   vk_device_.getQueue(queue_indexes_.present_family.value(), 0, &vk_present_queue_);
 }
 
-bool VulkanDevice::CheckDeviceRequirements(const vk::PhysicalDevice &vk_physical_device) {
-  if (vk_physical_device.getProperties().deviceType != vk::PhysicalDeviceType::eDiscreteGpu) {
-    GTRACE("Device is not a discrete GPU, skipping...");
+bool VulkanDevice::CheckDeviceRequirements(const vk::PhysicalDevice &vk_physical_device, bool require_discrete) {
+  if (require_discrete && vk_physical_device.getProperties().deviceType != vk::PhysicalDeviceType::eDiscreteGpu) {
+    GTRACE_CH(Renderer, "Device is not a discrete GPU, skipping...");
     return false;
   }
 
@@ -84,12 +101,12 @@ bool VulkanDevice::CheckDeviceRequirements(const vk::PhysicalDevice &vk_physical
 
 #if _DEBUG
   for (uint32_t i = 0; i < queue_family_count; i++) {
-    GTRACE("Queue family {} properties:", i);
-    GTRACE("  Queue count: {}", queue_family_[i].queueCount);
-    GTRACE("  Supports graphics: {}", queue_family_[i].queueFlags & vk::QueueFlagBits::eGraphics ? "true" : "false");
-    GTRACE("  Supports compute: {}", queue_family_[i].queueFlags & vk::QueueFlagBits::eCompute ? "true" : "false");
-    GTRACE("  Supports transfer: {}", queue_family_[i].queueFlags & vk::QueueFlagBits::eTransfer ? "true" : "false");
-    GTRACE("  Supports sparse binding: {}",
+    GTRACE_CH(Renderer, "Queue family {} properties:", i);
+    GTRACE_CH(Renderer, "  Queue count: {}", queue_family_[i].queueCount);
+    GTRACE_CH(Renderer, "  Supports graphics: {}", queue_family_[i].queueFlags & vk::QueueFlagBits::eGraphics ? "true" : "false");
+    GTRACE_CH(Renderer, "  Supports compute: {}", queue_family_[i].queueFlags & vk::QueueFlagBits::eCompute ? "true" : "false");
+    GTRACE_CH(Renderer, "  Supports transfer: {}", queue_family_[i].queueFlags & vk::QueueFlagBits::eTransfer ? "true" : "false");
+    GTRACE_CH(Renderer, "  Supports sparse binding: {}",
            queue_family_[i].queueFlags & vk::QueueFlagBits::eSparseBinding ? "true" : "false");
   }
 #endif
@@ -101,7 +118,7 @@ bool VulkanDevice::CheckDeviceRequirements(const vk::PhysicalDevice &vk_physical
   for (uint32_t i = 0; i < queue_family_count; i++) {
     vk::Bool32 present_support = false;
     if (vk_physical_device.getSurfaceSupportKHR(i, surface, &present_support) != vk::Result::eSuccess) {
-      GERROR("Failed to get surface support");
+      GERROR_CH(Renderer, "Failed to get surface support");
       return false;
     }
     if (present_support) {
@@ -118,10 +135,10 @@ bool VulkanDevice::CheckDeviceRequirements(const vk::PhysicalDevice &vk_physical
   }
 
   if (!queue_indexes_.IsComplete()) {
-    GTRACE("Device does not support graphics queue family, skipping...");
+    GTRACE_CH(Renderer, "Device does not support graphics queue family, skipping...");
     return false;
   }
-  GTRACE("Device supports graphics and presentation queue families");
+  GTRACE_CH(Renderer, "Device supports graphics and presentation queue families");
 
   uint32_t properties_count;
   (void) vk_physical_device.enumerateDeviceExtensionProperties(nullptr, &properties_count, nullptr);
@@ -133,16 +150,16 @@ bool VulkanDevice::CheckDeviceRequirements(const vk::PhysicalDevice &vk_physical
 
   for (const char *ext : extensions) {
     if (!IsExtensionAvailable(ext)) {
-      GTRACE("Device extension {} not available, skipping...", ext);
+      GTRACE_CH(Renderer, "Device extension {} not available, skipping...", ext);
       context_.RemoveInstanceExtension(ext);
     }
   }
   if (extensions.empty()) {
-    GTRACE("No device extensions available, skipping...");
+    GTRACE_CH(Renderer, "No device extensions available, skipping...");
     return false;
   }
 
-  GTRACE("Vulkan device requirements met");
+  GTRACE_CH(Renderer, "Vulkan device requirements met");
   return true;
 }
 
@@ -155,7 +172,7 @@ bool VulkanDevice::IsExtensionAvailable(const char *ext) {
 
 void VulkanDevice::PrintPhysicalDevice(const vk::PhysicalDevice gpu) {
   if (gpu == VK_NULL_HANDLE) {
-    GERROR("Cannot print physical device info: invalid handle");
+    GERROR_CH(Renderer, "Cannot print physical device info: invalid handle");
     return;
   }
 
@@ -168,11 +185,11 @@ void VulkanDevice::PrintPhysicalDevice(const vk::PhysicalDevice gpu) {
   std::string device_name(gpu.getProperties().deviceName.data());
   device_name.erase(std::remove(device_name.begin(), device_name.end(), '\0'), device_name.end());
 
-  GINFO("Physical device name: {}", device_name);
-  GINFO("API version: {}.{}.{}", kMajor, kMinor, kPatch);
-  GINFO("Driver version: {}", kProperties.driverVersion);
-  GINFO("Vendor ID: {}", kProperties.vendorID);
-  GINFO("Device ID: {}", kProperties.deviceID);
+  GINFO_CH(Renderer, "Physical device name: {}", device_name);
+  GINFO_CH(Renderer, "API version: {}.{}.{}", kMajor, kMinor, kPatch);
+  GINFO_CH(Renderer, "Driver version: {}", kProperties.driverVersion);
+  GINFO_CH(Renderer, "Vendor ID: {}", kProperties.vendorID);
+  GINFO_CH(Renderer, "Device ID: {}", kProperties.deviceID);
 }
 
 void VulkanDevice::Destroy() {
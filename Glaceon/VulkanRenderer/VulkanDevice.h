@@ -29,6 +29,9 @@ class VulkanDevice {
   [[nodiscard]] const vk::Queue &GetVkGraphicsQueue() const { return vk_graphics_queue_; }
 
   QueueIndexes &GetQueueIndexes() { return queue_indexes_; }
+  [[nodiscard]] bool IsPipelineStatisticsQuerySupported() const { return pipeline_statistics_query_supported_; }
+  // VK_EXT_memory_budget, enabled when available
+  [[nodiscard]] bool IsMemoryBudgetSupported() const { return memory_budget_supported_; }
 
  private:
   vk::PhysicalDevice vk_physical_device_;
@@ -42,8 +45,10 @@ class VulkanDevice {
   VulkanContext &context_;
 
   QueueIndexes queue_indexes_;
+  bool pipeline_statistics_query_supported_ = false;
+  bool memory_budget_supported_ = false;
 
-  bool CheckDeviceRequirements(const vk::PhysicalDevice &vk_physical_device);
+  bool CheckDeviceRequirements(const vk::PhysicalDevice &vk_physical_device, bool require_discrete);
   bool IsExtensionAvailable(const char *ext);
   static void PrintPhysicalDevice(const vk::PhysicalDevice gpu);
 };
@@ -0,0 +1,198 @@
+#include "VulkanGpuProfiler.h"
+
+#include "../Core/Logger.h"
+#include "../Profiler/Profiler.h"
+#include "VulkanBase.h"
+#include "VulkanContext.h"
+#include "VulkanUtils.h"
+
+namespace glaceon {
+
+// BeginScope() on a full frame pushes this so the matching EndScope() knows to write nothing
+static constexpr uint32_t kDroppedScope = UINT32_MAX;
+
+VulkanGpuProfiler::VulkanGpuProfiler(VulkanContext &context) : context_(context) {}
+
+VulkanGpuProfiler::~VulkanGpuProfiler() { Destroy(); }
+
+/**
+ * @brief Creates the query pool, one slice of begin/end timestamps per swap chain frame, and calibrates GPU timestamps
+ * against the Profiler clock.  Leaves the profiler disabled if the graphics queue cannot write timestamps.
+ */
+void VulkanGpuProfiler::Initialize() {
+  const vk::Device device = context_.GetVulkanLogicalDevice();
+  VK_ASSERT(device != VK_NULL_HANDLE, "Failed to get Vulkan logical device");
+
+  const vk::PhysicalDevice physical_device = context_.GetVulkanPhysicalDevice();
+  const uint32_t graphics_family = context_.GetQueueIndexes().graphics_family.value();
+  const uint32_t valid_bits = physical_device.getQueueFamilyProperties()[graphics_family].timestampValidBits;
+  if (valid_bits == 0) {
+    GWARN_CH(Renderer, "Graphics queue does not support timestamp queries, GPU profiling disabled");
+    return;
+  }
+  timestamp_mask_ = valid_bits >= 64 ? ~0ULL : (1ULL << valid_bits) - 1;
+  timestamp_period_ns_ = physical_device.getProperties().limits.timestampPeriod;
+
+  const auto num_frames = static_cast<uint32_t>(context_.GetVulkanSwapChain().GetSwapChainFrames().size());
+  queries_per_frame_ = 2 * kMaxScopesPerFrame;
+
+  vk::QueryPoolCreateInfo query_pool_create_info = {};
+  query_pool_create_info.sType = vk::StructureType::eQueryPoolCreateInfo;
+  query_pool_create_info.queryType = vk::QueryType::eTimestamp;
+  query_pool_create_info.queryCount = num_frames * queries_per_frame_;
+  if (device.createQueryPool(&query_pool_create_info, nullptr, &query_pool_) != vk::Result::eSuccess) {
+    GERROR_CH(Renderer, "Failed to create timestamp query pool");
+    query_pool_ = VK_NULL_HANDLE;
+    return;
+  }
+
+  frames_.resize(num_frames);
+  for (FrameQueries &frame : frames_) {
+    frame.scopes.reserve(kMaxScopesPerFrame);
+    frame.open_scopes.reserve(kMaxScopesPerFrame);
+  }
+  timestamps_.reserve(queries_per_frame_);
+  results_.reserve(kMaxScopesPerFrame);
+
+  if (profiler_track_ == 0) { profiler_track_ = Profiler::RegisterTrack("GPU"); }
+  Calibrate();
+  GINFO_CH(Renderer, "Successfully created timestamp query pool ({} ns per tick)", timestamp_period_ns_);
+}
+
+void VulkanGpuProfiler::Rebuild() {
+  Destroy();
+  Initialize();
+}
+
+void VulkanGpuProfiler::Destroy() {
+  if (query_pool_ != VK_NULL_HANDLE) {
+    context_.GetVulkanLogicalDevice().destroy(query_pool_, nullptr);
+    query_pool_ = VK_NULL_HANDLE;
+  }
+  frames_.clear();
+  current_frame_ = nullptr;
+}
+
+/**
+ * @brief Reads back the timestamps the frame slot recorded last time, if they are available, and resets its queries.
+ *
+ * @param command_buffer The frame's command buffer, in the recording state and outside of a render pass.
+ * @param frame_index Index of the frame in flight; its fence must have been waited on.
+ */
+void VulkanGpuProfiler::BeginFrame(vk::CommandBuffer command_buffer, uint32_t frame_index) {
+  if (!IsEnabled() || frame_index >= frames_.size()) { return; }
+
+  FrameQueries &frame = frames_[frame_index];
+  current_first_query_ = frame_index * queries_per_frame_;
+  if (frame.pending) { ReadResults(frame, current_first_query_); }
+
+  frame.scopes.clear();
+  frame.open_scopes.clear();
+  frame.num_queries = 0;
+  command_buffer.resetQueryPool(query_pool_, current_first_query_, queries_per_frame_);
+  current_frame_ = &frame;
+}
+
+void VulkanGpuProfiler::BeginScope(vk::CommandBuffer command_buffer, const char *name) {
+  if (current_frame_ == nullptr) { return; }
+
+  FrameQueries &frame = *current_frame_;
+  if (frame.num_queries + 2 > queries_per_frame_) {
+    frame.open_scopes.push_back(kDroppedScope);
+    return;
+  }
+
+  const Scope scope = {name, frame.num_queries, frame.num_queries + 1, static_cast<uint32_t>(frame.open_scopes.size())};
+  frame.num_queries += 2;
+  frame.open_scopes.push_back(static_cast<uint32_t>(frame.scopes.size()));
+  frame.scopes.push_back(scope);
+  command_buffer.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, query_pool_, current_first_query_ + scope.begin_query);
+}
+
+void VulkanGpuProfiler::EndScope(vk::CommandBuffer command_buffer) {
+  if (current_frame_ == nullptr || current_frame_->open_scopes.empty()) { return; }
+
+  const uint32_t scope_index = current_frame_->open_scopes.back();
+  current_frame_->open_scopes.pop_back();
+  if (scope_index == kDroppedScope) { return; }
+
+  // bottom of pipe: the timestamp is written once every command recorded before it has finished
+  command_buffer.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, query_pool_,
+                                current_first_query_ + current_frame_->scopes[scope_index].end_query);
+}
+
+void VulkanGpuProfiler::EndFrame(vk::CommandBuffer command_buffer) {
+  if (current_frame_ == nullptr) { return; }
+
+  if (!current_frame_->open_scopes.empty()) {
+    GWARN_CH(Renderer, "GpuProfiler: {} scopes still open at the end of the frame", current_frame_->open_scopes.size());
+    while (!current_frame_->open_scopes.empty()) { EndScope(command_buffer); }
+  }
+  current_frame_->pending = !current_frame_->scopes.empty();
+  current_frame_ = nullptr;
+}
+
+/**
+ * @brief Writes a timestamp on an otherwise idle queue and pairs it with an estimate of the CPU time it was taken at.
+ *
+ * The timestamp is written at the top of the pipe, so it marks when the GPU starts executing the submission.  That is
+ * somewhere between the submit call and the wait for the queue returning.  The command buffer does nothing else, so the
+ * estimate takes the middle of that window, as if the GPU took as long to pick the submission up as the CPU took to
+ * see it finish.  This needs nothing beyond core Vulkan, unlike VK_EXT_calibrated_timestamps, at the cost of being off
+ * by up to half the window, typically tens of microseconds.
+ */
+void VulkanGpuProfiler::Calibrate() {
+  vk::CommandBuffer command_buffer = context_.GetVulkanCommandPool().GetVkMainCommandBuffer();
+  VK_ASSERT(command_buffer != VK_NULL_HANDLE, "Main command buffer not initialized");
+
+  VulkanUtils::BeginSingleTimeCommands(command_buffer);
+  command_buffer.resetQueryPool(query_pool_, 0, 1);
+  command_buffer.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, query_pool_, 0);
+  const uint64_t submit_ticks = Profiler::Now();
+  VulkanUtils::EndSingleTimeCommands(command_buffer, context_.GetVulkanDevice().GetVkGraphicsQueue());
+  const uint64_t complete_ticks = Profiler::Now();
+
+  uint64_t timestamp = 0;
+  VK_CHECK(context_.GetVulkanLogicalDevice().getQueryPoolResults(query_pool_, 0, 1, sizeof(timestamp), &timestamp, sizeof(timestamp),
+                                                                 vk::QueryResultFlagBits::e64 | vk::QueryResultFlagBits::eWait),
+           "Failed to read calibration timestamp");
+  calibration_gpu_timestamp_ = timestamp & timestamp_mask_;
+  // the submission started executing between the two, take the middle
+  calibration_cpu_ticks_ = submit_ticks + (complete_ticks - submit_ticks) / 2;
+}
+
+void VulkanGpuProfiler::ReadResults(FrameQueries &frame, uint32_t first_query) {
+  frame.pending = false;
+  timestamps_.resize(frame.num_queries);
+  // no eWait: the frame's fence has signaled so the results are there, and if they are not we would rather lose them
+  const vk::Result result = context_.GetVulkanLogicalDevice().getQueryPoolResults(
+      query_pool_, first_query, frame.num_queries, timestamps_.size() * sizeof(uint64_t), timestamps_.data(), sizeof(uint64_t),
+      vk::QueryResultFlagBits::e64);
+  if (result != vk::Result::eSuccess) { return; }
+
+  results_.clear();
+  const double ticks_per_us = Profiler::GetTicksPerMicrosecond();
+  uint64_t frame_begin = UINT64_MAX;
+  uint64_t frame_end = 0;
+  for (const Scope &scope : frame.scopes) {
+    const uint64_t begin = timestamps_[scope.begin_query] & timestamp_mask_;
+    const uint64_t end = timestamps_[scope.end_query] & timestamp_mask_;
+    const uint64_t duration = (end - begin) & timestamp_mask_;
+    results_.push_back({scope.name, scope.depth, static_cast<float>(static_cast<double>(duration) * timestamp_period_ns_ / 1e6)});
+
+    const uint64_t begin_ticks = ToProfilerTicks(begin, ticks_per_us);
+    const uint64_t end_ticks = ToProfilerTicks(end, ticks_per_us);
+    Profiler::RecordScope(scope.name, begin_ticks, end_ticks, profiler_track_);
+    frame_begin = std::min(frame_begin, begin_ticks);
+    frame_end = std::max(frame_end, end_ticks);
+  }
+  frame_time_ms_ = frame_end > frame_begin ? static_cast<float>(static_cast<double>(frame_end - frame_begin) / ticks_per_us / 1000.0) : 0.0f;
+}
+
+uint64_t VulkanGpuProfiler::ToProfilerTicks(uint64_t gpu_timestamp, double ticks_per_us) const {
+  const uint64_t gpu_ticks = (gpu_timestamp - calibration_gpu_timestamp_) & timestamp_mask_;
+  const double microseconds = static_cast<double>(gpu_ticks) * timestamp_period_ns_ / 1000.0;
+  return calibration_cpu_ticks_ + static_cast<uint64_t>(microseconds * ticks_per_us);
+}
+
+}// namespace glaceon
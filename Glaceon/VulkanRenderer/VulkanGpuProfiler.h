@@ -0,0 +1,115 @@
+#ifndef GLACEON_GLACEON_VULKANRENDERER_VULKANGPUPROFILER_H_
+#define GLACEON_GLACEON_VULKANRENDERER_VULKANGPUPROFILER_H_
+
+#include "../pch.h"
+
+namespace glaceon {
+
+class VulkanContext;
+
+struct GpuScopeResult {
+  const char *name;
+  uint32_t depth;// 0 for top level scopes
+  float milliseconds;
+};
+
+// Measures GPU time of command buffer regions with timestamp queries.
+//
+// Each frame in flight owns a slice of one query pool.  A frame's timestamps are read back when its slot comes around
+// again, right after the in-flight fence for that slot has been waited on, so reading them never stalls.  Results are
+// therefore a few frames old.  They are converted to Profiler ticks and recorded on a "GPU" row of the running
+// Profiler session, next to the CPU scopes that recorded them.
+//
+// Only uses core Vulkan 1.0 (vkCmdResetQueryPool, vkCmdWriteTimestamp), so it also works on lavapipe.  Devices whose
+// graphics queue has no timestamp support leave it disabled and every call becomes a no-op.
+//
+// e.g.
+//  gpu_profiler.BeginFrame(command_buffer, frame_index);// right after command_buffer.begin()
+//  {
+//    GpuProfileScope scope(gpu_profiler, command_buffer, "Draw");
+//    command_buffer.drawIndexed(...);
+//  }
+//  gpu_profiler.EndFrame(command_buffer);// before command_buffer.end()
+class VulkanGpuProfiler {
+ public:
+  static constexpr uint32_t kMaxScopesPerFrame = 64;
+
+  explicit VulkanGpuProfiler(VulkanContext &context);
+  ~VulkanGpuProfiler();
+
+  void Initialize();
+  void Rebuild();
+  void Destroy();
+
+  // reads back the results of the frame that last used frame_index and resets its queries; call outside a render pass
+  void BeginFrame(vk::CommandBuffer command_buffer, uint32_t frame_index);
+  // name must outlive the Profiler session, like a GLACEON_PROFILE_SCOPE name
+  void BeginScope(vk::CommandBuffer command_buffer, const char *name);
+  void EndScope(vk::CommandBuffer command_buffer);
+  void EndFrame(vk::CommandBuffer command_buffer);
+
+  [[nodiscard]] bool IsEnabled() const { return query_pool_ != VK_NULL_HANDLE; }
+  // scopes of the most recent frame whose results are available, in the order they were opened
+  [[nodiscard]] const std::vector<GpuScopeResult> &GetResults() const { return results_; }
+  // GPU time of that frame, from its first to its last timestamp
+  [[nodiscard]] float GetFrameTime() const { return frame_time_ms_; }
+
+ private:
+  struct Scope {
+    const char *name;
+    uint32_t begin_query;
+    uint32_t end_query;
+    uint32_t depth;
+  };
+
+  struct FrameQueries {
+    std::vector<Scope> scopes;
+    std::vector<uint32_t> open_scopes;// indexes into scopes, innermost last
+    uint32_t num_queries = 0;
+    bool pending = false;// submitted, results not read yet
+  };
+
+  void Calibrate();
+  void ReadResults(FrameQueries &frame, uint32_t first_query);
+  [[nodiscard]] uint64_t ToProfilerTicks(uint64_t gpu_timestamp, double ticks_per_us) const;
+
+  VulkanContext &context_;
+
+  vk::QueryPool query_pool_ = VK_NULL_HANDLE;
+  uint32_t queries_per_frame_ = 0;
+  std::vector<FrameQueries> frames_;
+  FrameQueries *current_frame_ = nullptr;
+  uint32_t current_first_query_ = 0;
+
+  float timestamp_period_ns_ = 1.0f;
+  uint64_t timestamp_mask_ = ~0ULL;
+  // a GPU timestamp and the Profiler tick it corresponds to, see Calibrate()
+  uint64_t calibration_gpu_timestamp_ = 0;
+  uint64_t calibration_cpu_ticks_ = 0;
+  uint32_t profiler_track_ = 0;
+
+  std::vector<uint64_t> timestamps_;
+  std::vector<GpuScopeResult> results_;
+  float frame_time_ms_ = 0.0f;
+};
+
+// Measures the commands recorded into command_buffer during its lifetime.
+class GpuProfileScope {
+ public:
+  GpuProfileScope(VulkanGpuProfiler &profiler, vk::CommandBuffer command_buffer, const char *name)
+      : profiler_(profiler), command_buffer_(command_buffer) {
+    profiler_.BeginScope(command_buffer_, name);
+  }
+  ~GpuProfileScope() { profiler_.EndScope(command_buffer_); }
+
+  GpuProfileScope(const GpuProfileScope &) = delete;
+  GpuProfileScope &operator=(const GpuProfileScope &) = delete;
+
+ private:
+  VulkanGpuProfiler &profiler_;
+  vk::CommandBuffer command_buffer_;
+};
+
+}// namespace glaceon
+
+#endif// GLACEON_GLACEON_VULKANRENDERER_VULKANGPUPROFILER_H_
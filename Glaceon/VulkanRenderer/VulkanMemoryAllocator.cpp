@@ -8,14 +8,110 @@
 #include "VulkanContext.h"
 
 namespace glaceon {
+
+static constexpr float kMib = 1024.0f * 1024.0f;
+
 VulkanMemoryAllocator::VulkanMemoryAllocator(VulkanContext &context) : context_(context), allocator_(nullptr) {}
-VulkanMemoryAllocator::~VulkanMemoryAllocator() = default;
+VulkanMemoryAllocator::~VulkanMemoryAllocator() { Destroy(); }
 
 void VulkanMemoryAllocator::Initialize() {
   VmaAllocatorCreateInfo allocator_create_info = {};
   allocator_create_info.device = context_.GetVulkanLogicalDevice();
   allocator_create_info.instance = context_.GetVulkanInstance();
   allocator_create_info.physicalDevice = context_.GetVulkanPhysicalDevice();
+  stats_.memory_budget_enabled = context_.GetVulkanDevice().IsMemoryBudgetSupported();
+  if (stats_.memory_budget_enabled) { allocator_create_info.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT; }
   VK_CHECK(vmaCreateAllocator(&allocator_create_info, &allocator_), "Failed to create VulkanMemoryAllocator");
+
+  const VkPhysicalDeviceMemoryProperties *memory_properties = nullptr;
+  vmaGetMemoryProperties(allocator_, &memory_properties);
+  stats_.heap_count = memory_properties->memoryHeapCount;
+  for (uint32_t heap = 0; heap < stats_.heap_count; heap++) {
+    stats_.heaps[heap].size = memory_properties->memoryHeaps[heap].size;
+    stats_.heaps[heap].device_local = (memory_properties->memoryHeaps[heap].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+  }
+
+  if (!stats_.memory_budget_enabled) {
+    GWARN_CH(Renderer, "VK_EXT_memory_budget not available, device memory usage only counts VMA allocations");
+  }
+  // first stats right away, so they are valid before the first frame
+  EndFrame();
+}
+
+void VulkanMemoryAllocator::Destroy() {
+  if (allocator_ == nullptr) { return; }
+  vmaDestroyAllocator(allocator_);
+  allocator_ = nullptr;
+  stats_ = {};
+  budget_warned_ = {};
 }
+
+/**
+ * @brief Starts VMA's next frame, which also has it fetch the current budget from the driver, and copies the per
+ * heap usage and budget into the stats.  Logs a heap that crossed kBudgetWarningThreshold.
+ */
+void VulkanMemoryAllocator::EndFrame() {
+  if (allocator_ == nullptr) { return; }
+
+  vmaSetCurrentFrameIndex(allocator_, ++frame_index_);
+  std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> budgets;
+  vmaGetHeapBudgets(allocator_, budgets.data());
+
+  for (uint32_t heap = 0; heap < stats_.heap_count; heap++) {
+    DeviceMemoryHeapStats &heap_stats = stats_.heaps[heap];
+    const VmaBudget &budget = budgets[heap];
+    heap_stats.usage = budget.usage;
+    heap_stats.budget = budget.budget;
+    heap_stats.block_count = budget.statistics.blockCount;
+    heap_stats.allocation_count = budget.statistics.allocationCount;
+    heap_stats.block_bytes = budget.statistics.blockBytes;
+    heap_stats.allocation_bytes = budget.statistics.allocationBytes;
+
+    if (budget.budget == 0) { continue; }
+    const float used = static_cast<float>(budget.usage) / static_cast<float>(budget.budget);
+    if (!budget_warned_[heap] && used >= kBudgetWarningThreshold) {
+      GWARN_CH(Renderer, "Device memory heap {} at {:.0f}% of its budget ({:.1f} / {:.1f} MiB)", heap, 100.0f * used,
+               static_cast<float>(budget.usage) / kMib, static_cast<float>(budget.budget) / kMib);
+      budget_warned_[heap] = true;
+    } else if (budget_warned_[heap] && used < kBudgetRearmThreshold) {
+      budget_warned_[heap] = false;
+    }
+  }
+
+  if (frame_index_ % kDetailedStatsInterval == 1) { UpdateDetailedStats(); }
+}
+
+void VulkanMemoryAllocator::UpdateDetailedStats() {
+  VmaTotalStatistics statistics;
+  vmaCalculateStatistics(allocator_, &statistics);
+
+  for (uint32_t heap = 0; heap < stats_.heap_count; heap++) {
+    DeviceMemoryHeapStats &heap_stats = stats_.heaps[heap];
+    const VmaDetailedStatistics &detailed = statistics.memoryHeap[heap];
+    const VkDeviceSize unused_bytes = detailed.statistics.blockBytes - detailed.statistics.allocationBytes;
+    heap_stats.unused_range_count = detailed.unusedRangeCount;
+    heap_stats.largest_unused_range = detailed.unusedRangeSizeMax;
+    heap_stats.fragmentation =
+        unused_bytes > 0 ? 1.0f - static_cast<float>(detailed.unusedRangeSizeMax) / static_cast<float>(unused_bytes) : 0.0f;
+  }
+}
+
+bool VulkanMemoryAllocator::WriteStatsJson(const std::string &file_path) const {
+  if (allocator_ == nullptr) { return false; }
+
+  std::ofstream file(file_path);
+  if (!file) {
+    GERROR_CH(Renderer, "VulkanMemoryAllocator: failed to open {} for writing", file_path);
+    return false;
+  }
+
+  char *stats_string = nullptr;
+  vmaBuildStatsString(allocator_, &stats_string, VK_TRUE);
+  file << stats_string;
+  vmaFreeStatsString(allocator_, stats_string);
+
+  GINFO_CH(Renderer, "VulkanMemoryAllocator: wrote stats to {}", file_path);
+  return true;
+}
+
 }// namespace glaceon
@@ -1,24 +1,75 @@
 #ifndef GLACEON_GLACEON_VULKANRENDERER_VULKANMEMORYALLOCATOR_H_
 #define GLACEON_GLACEON_VULKANRENDERER_VULKANMEMORYALLOCATOR_H_
 
+#include <array>
+#include <string>
+
 #include <vk_mem_alloc.h>
 
 namespace glaceon {
 
 class VulkanContext;
 
+// Device memory of one heap
+struct DeviceMemoryHeapStats {
+  VkDeviceSize size = 0;
+  bool device_local = false;
+  // with VK_EXT_memory_budget usage covers the whole process and the budget is the driver's; without it usage only
+  // counts VMA's own blocks and the budget is an estimate
+  VkDeviceSize usage = 0;
+  VkDeviceSize budget = 0;
+  uint32_t block_count = 0;// VkDeviceMemory blocks allocated by VMA
+  uint32_t allocation_count = 0;
+  VkDeviceSize block_bytes = 0;
+  VkDeviceSize allocation_bytes = 0;
+
+  // from the last detailed update, see VulkanMemoryAllocator::kDetailedStatsInterval
+  uint32_t unused_range_count = 0;
+  VkDeviceSize largest_unused_range = 0;
+  // 0 when the free space in the blocks is a single range, towards 1 the more it is split into small ones
+  float fragmentation = 0.0f;
+};
+
+struct DeviceMemoryStats {
+  std::array<DeviceMemoryHeapStats, VK_MAX_MEMORY_HEAPS> heaps;
+  uint32_t heap_count = 0;
+  bool memory_budget_enabled = false;
+};
+
+// Owns the VMA allocator and reports what it knows about device memory.
+//
+// EndFrame() refreshes the per heap usage, budget and counts, which VMA tracks as it goes, and warns once a heap
+// gets close to its budget.  Fragmentation needs a walk over every block, so it is only recalculated every
+// kDetailedStatsInterval frames.
 class VulkanMemoryAllocator {
 
  public:
+  // a heap at or above this fraction of its budget logs a warning, again once it has been below kBudgetRearmThreshold
+  static constexpr float kBudgetWarningThreshold = 0.9f;
+  static constexpr float kBudgetRearmThreshold = 0.85f;
+  static constexpr uint32_t kDetailedStatsInterval = 60;
+
   explicit VulkanMemoryAllocator(VulkanContext &context);
   ~VulkanMemoryAllocator();
 
   void Initialize();
+  void Destroy();
+
+  // advances VMA's frame index and refreshes the stats; call once per frame
+  void EndFrame();
+  [[nodiscard]] const DeviceMemoryStats &GetStats() const { return stats_; }
+  // VMA's detailed JSON dump of every heap, memory type, block and allocation
+  bool WriteStatsJson(const std::string &file_path) const;
 
  private:
+  void UpdateDetailedStats();
+
   VulkanContext &context_;
 
   VmaAllocator allocator_;
+  uint32_t frame_index_ = 0;
+  DeviceMemoryStats stats_;
+  std::array<bool, VK_MAX_MEMORY_HEAPS> budget_warned_ = {};
 };
 
 }// namespace glaceon
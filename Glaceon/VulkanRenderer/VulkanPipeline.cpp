@@ -28,7 +28,7 @@ void VulkanPipeline::Initialize(const GraphicsPipelineConfig &pipeline_config) {
   pipeline_cache_info.initialDataSize = 0;
   pipeline_cache_info.pInitialData = nullptr;
   if (device.createPipelineCache(&pipeline_cache_info, nullptr, &vk_pipeline_cache_) != vk::Result::eSuccess) {
-    GERROR("Failed to create pipeline cache");
+    GERROR_CH(Renderer, "Failed to create pipeline cache");
     return;
   }
 
@@ -74,16 +74,16 @@ void VulkanPipeline::Initialize(const GraphicsPipelineConfig &pipeline_config) {
 
   // Vertex Shader
   if (pipeline_config.vertex_shader_file.empty()) {
-    GERROR("No vertex shader specified");
+    GERROR_CH(Renderer, "No vertex shader specified");
     return;
   }
 
   vk::ShaderModule vertex_shader = VulkanUtils::CreateShaderModule(device, pipeline_config.vertex_shader_file);
   if (vertex_shader == nullptr) {
-    GERROR("Failed to create vertex shader module");
+    GERROR_CH(Renderer, "Failed to create vertex shader module");
     return;
   }
-  GINFO("Successfully created vertex shader module");
+  GINFO_CH(Renderer, "Successfully created vertex shader module");
 
   vk::PipelineShaderStageCreateInfo vertex_shader_stage = {};
   vertex_shader_stage.sType = vk::StructureType::ePipelineShaderStageCreateInfo;
@@ -131,16 +131,16 @@ void VulkanPipeline::Initialize(const GraphicsPipelineConfig &pipeline_config) {
 
   // Fragment shader
   if (pipeline_config.vertex_shader_file.empty()) {
-    GERROR("No fragment shader specified");
+    GERROR_CH(Renderer, "No fragment shader specified");
     return;
   }
 
   vk::ShaderModule fragment_shader = VulkanUtils::CreateShaderModule(device, pipeline_config.fragment_shader_file);
   if (fragment_shader == nullptr) {
-    GERROR("Failed to create fragment shader module");
+    GERROR_CH(Renderer, "Failed to create fragment shader module");
     return;
   }
-  GINFO("Successfully created fragment shader module");
+  GINFO_CH(Renderer, "Successfully created fragment shader module");
 
   vk::PipelineShaderStageCreateInfo fragment_shader_stage = {};
   fragment_shader_stage.sType = vk::StructureType::ePipelineShaderStageCreateInfo;
@@ -204,7 +204,7 @@ void VulkanPipeline::Initialize(const GraphicsPipelineConfig &pipeline_config) {
   // Create pipeline - for now just one pipeline
   VK_CHECK(device.createGraphicsPipelines(vk_pipeline_cache_, 1, &pipeline_create_info, nullptr, &vk_pipeline_),
            "Failed to create graphics pipeline");
-  GINFO("Successfully created graphics pipeline");
+  GINFO_CH(Renderer, "Successfully created graphics pipeline");
 
   // Clean up shader modules and old pipeline
   if (old_pipeline != VK_NULL_HANDLE) {
@@ -250,10 +250,10 @@ void VulkanPipeline::CreatePipelineLayout() {
   pipeline_layout_info.pPushConstantRanges = &push_constant_info;
 
   if (device.createPipelineLayout(&pipeline_layout_info, nullptr, &vk_pipeline_layout_) != vk::Result::eSuccess) {
-    GERROR("Failed to create pipeline layout");
+    GERROR_CH(Renderer, "Failed to create pipeline layout");
     vk_pipeline_layout_ = nullptr;
   } else {
-    GINFO("Successfully created pipeline layout");
+    GINFO_CH(Renderer, "Successfully created pipeline layout");
   }
 }
 
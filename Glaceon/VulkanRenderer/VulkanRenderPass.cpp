@@ -73,9 +73,9 @@ void VulkanRenderPass::Initialize(const VulkanRenderPassInput &input) {
   VK_ASSERT(device != VK_NULL_HANDLE, "Failed to get Vulkan logical device");
 
   if (device.createRenderPass(&render_pass_create_info, nullptr, &vk_render_pass_) != vk::Result::eSuccess) {
-    GERROR("Failed to create render pass");
+    GERROR_CH(Renderer, "Failed to create render pass");
   } else {
-    GINFO("Successfully created render pass");
+    GINFO_CH(Renderer, "Successfully created render pass");
   }
 }
 
@@ -0,0 +1,115 @@
+#include "VulkanRenderStats.h"
+
+#include "../Core/Logger.h"
+#include "VulkanBase.h"
+#include "VulkanContext.h"
+
+namespace glaceon {
+
+// the order of the members of PipelineStatistics
+static constexpr vk::QueryPipelineStatisticFlags kPipelineStatisticFlags =
+    vk::QueryPipelineStatisticFlagBits::eInputAssemblyVertices | vk::QueryPipelineStatisticFlagBits::eInputAssemblyPrimitives
+    | vk::QueryPipelineStatisticFlagBits::eVertexShaderInvocations | vk::QueryPipelineStatisticFlagBits::eClippingInvocations
+    | vk::QueryPipelineStatisticFlagBits::eClippingPrimitives | vk::QueryPipelineStatisticFlagBits::eFragmentShaderInvocations;
+
+static_assert(sizeof(PipelineStatistics) == 6 * sizeof(uint64_t), "PipelineStatistics must match kPipelineStatisticFlags");
+
+VulkanRenderStats::VulkanRenderStats(VulkanContext &context) : context_(context) {}
+
+VulkanRenderStats::~VulkanRenderStats() { Destroy(); }
+
+/**
+ * @brief Creates the pipeline statistics query pool, one query per swap chain frame.  Draw counters work without it.
+ */
+void VulkanRenderStats::Initialize() {
+  const vk::Device device = context_.GetVulkanLogicalDevice();
+  VK_ASSERT(device != VK_NULL_HANDLE, "Failed to get Vulkan logical device");
+
+  if (!context_.GetVulkanDevice().IsPipelineStatisticsQuerySupported()) {
+    GWARN_CH(Renderer, "Device does not support pipeline statistics queries, only draw counters are available");
+    return;
+  }
+
+  const auto num_frames = static_cast<uint32_t>(context_.GetVulkanSwapChain().GetSwapChainFrames().size());
+
+  vk::QueryPoolCreateInfo query_pool_create_info = {};
+  query_pool_create_info.sType = vk::StructureType::eQueryPoolCreateInfo;
+  query_pool_create_info.queryType = vk::QueryType::ePipelineStatistics;
+  query_pool_create_info.queryCount = num_frames;
+  query_pool_create_info.pipelineStatistics = kPipelineStatisticFlags;
+  if (device.createQueryPool(&query_pool_create_info, nullptr, &query_pool_) != vk::Result::eSuccess) {
+    GERROR_CH(Renderer, "Failed to create pipeline statistics query pool");
+    query_pool_ = VK_NULL_HANDLE;
+    return;
+  }
+
+  frames_.resize(num_frames);
+  GINFO_CH(Renderer, "Successfully created pipeline statistics query pool");
+}
+
+void VulkanRenderStats::Rebuild() {
+  Destroy();
+  Initialize();
+}
+
+void VulkanRenderStats::Destroy() {
+  if (query_pool_ != VK_NULL_HANDLE) {
+    context_.GetVulkanLogicalDevice().destroy(query_pool_, nullptr);
+    query_pool_ = VK_NULL_HANDLE;
+  }
+  frames_.clear();
+  current_frame_ = nullptr;
+}
+
+/**
+ * @brief Starts counting a new frame.  Reads back the pipeline statistics the frame slot collected last time, if they
+ * are available, and resets its query when statistics are enabled.
+ *
+ * @param command_buffer The frame's command buffer, in the recording state and outside of a render pass.
+ * @param frame_index Index of the frame in flight; its fence must have been waited on.
+ */
+void VulkanRenderStats::BeginFrame(vk::CommandBuffer command_buffer, uint32_t frame_index) {
+  current_counters_ = {};
+  current_frame_ = nullptr;
+  if (!IsPipelineStatisticsSupported() || frame_index >= frames_.size()) { return; }
+
+  FrameQuery &frame = frames_[frame_index];
+  if (frame.pending) {
+    frame.pending = false;
+    PipelineStatistics statistics;
+    // no eWait, the frame's fence has signaled; if the results are somehow not there we keep the previous ones
+    if (context_.GetVulkanLogicalDevice().getQueryPoolResults(query_pool_, frame_index, 1, sizeof(statistics), &statistics,
+                                                              sizeof(statistics), vk::QueryResultFlagBits::e64)
+        == vk::Result::eSuccess) {
+      pipeline_statistics_ = statistics;
+    }
+  }
+
+  frame.active = false;
+  if (!pipeline_statistics_enabled_) { return; }
+  command_buffer.resetQueryPool(query_pool_, frame_index, 1);
+  current_frame_ = &frame;
+  current_query_ = frame_index;
+}
+
+void VulkanRenderStats::BeginPipelineStatistics(vk::CommandBuffer command_buffer) {
+  if (current_frame_ == nullptr || current_frame_->active) { return; }
+  command_buffer.beginQuery(query_pool_, current_query_, {});
+  current_frame_->active = true;
+}
+
+void VulkanRenderStats::EndPipelineStatistics(vk::CommandBuffer command_buffer) {
+  if (current_frame_ == nullptr || !current_frame_->active) { return; }
+  command_buffer.endQuery(query_pool_, current_query_);
+  current_frame_->pending = true;
+}
+
+void VulkanRenderStats::EndFrame() {
+  last_counters_ = current_counters_;
+  if (current_frame_ != nullptr && current_frame_->active && !current_frame_->pending) {
+    GWARN_CH(Renderer, "RenderStats: pipeline statistics query was never ended");
+  }
+  current_frame_ = nullptr;
+}
+
+}// namespace glaceon
@@ -0,0 +1,77 @@
+#ifndef GLACEON_GLACEON_VULKANRENDERER_VULKANRENDERSTATS_H_
+#define GLACEON_GLACEON_VULKANRENDERER_VULKANRENDERSTATS_H_
+
+#include "../pch.h"
+#include "VulkanCommandRecorder.h"
+
+namespace glaceon {
+
+class VulkanContext;
+
+// VK_QUERY_TYPE_PIPELINE_STATISTICS results, in the order Vulkan writes them for the flags VulkanRenderStats requests
+struct PipelineStatistics {
+  uint64_t input_assembly_vertices = 0;
+  uint64_t input_assembly_primitives = 0;
+  uint64_t vertex_shader_invocations = 0;
+  uint64_t clipping_invocations = 0;// primitives that reached the clipping stage
+  uint64_t clipping_primitives = 0; // primitives that came out of it
+  uint64_t fragment_shader_invocations = 0;
+};
+
+// Per frame draw/bind counters and, optionally, GPU pipeline statistics.
+//
+// Counters are kept by the VulkanCommandRecorder handed out by GetRecorder() and are complete as soon as the frame has
+// been recorded.  Pipeline statistics are collected with one query per frame in flight around the frame's render pass
+// and read back without waiting once the slot comes around again, like VulkanGpuProfiler's timestamps.  They need the
+// pipelineStatisticsQuery device feature, and are off until SetPipelineStatisticsEnabled(true) since some drivers
+// slow down while the query is active.
+class VulkanRenderStats {
+ public:
+  explicit VulkanRenderStats(VulkanContext &context);
+  ~VulkanRenderStats();
+
+  void Initialize();
+  void Rebuild();
+  void Destroy();
+
+  // call right after command_buffer.begin(), outside a render pass
+  void BeginFrame(vk::CommandBuffer command_buffer, uint32_t frame_index);
+  // counts into the frame started by the last BeginFrame()
+  [[nodiscard]] VulkanCommandRecorder GetRecorder(vk::CommandBuffer command_buffer) { return {command_buffer, current_counters_}; }
+  // bracket the render pass with these, outside of it
+  void BeginPipelineStatistics(vk::CommandBuffer command_buffer);
+  void EndPipelineStatistics(vk::CommandBuffer command_buffer);
+  void EndFrame();
+
+  [[nodiscard]] bool IsPipelineStatisticsSupported() const { return query_pool_ != VK_NULL_HANDLE; }
+  [[nodiscard]] bool IsPipelineStatisticsEnabled() const { return pipeline_statistics_enabled_; }
+  // takes effect from the next BeginFrame()
+  void SetPipelineStatisticsEnabled(bool enabled) { pipeline_statistics_enabled_ = enabled && IsPipelineStatisticsSupported(); }
+
+  // counters of the last recorded frame
+  [[nodiscard]] const DrawCounters &GetDrawCounters() const { return last_counters_; }
+  // statistics of the most recent frame whose results are available; all zero until then
+  [[nodiscard]] const PipelineStatistics &GetPipelineStatistics() const { return pipeline_statistics_; }
+
+ private:
+  struct FrameQuery {
+    bool active = false; // query recorded into the frame's command buffer
+    bool pending = false;// submitted, result not read yet
+  };
+
+  VulkanContext &context_;
+
+  vk::QueryPool query_pool_ = VK_NULL_HANDLE;
+  std::vector<FrameQuery> frames_;
+  FrameQuery *current_frame_ = nullptr;
+  uint32_t current_query_ = 0;
+  bool pipeline_statistics_enabled_ = false;
+
+  DrawCounters current_counters_;
+  DrawCounters last_counters_;
+  PipelineStatistics pipeline_statistics_;
+};
+
+}// namespace glaceon
+
+#endif// GLACEON_GLACEON_VULKANRENDERER_VULKANRENDERSTATS_H_
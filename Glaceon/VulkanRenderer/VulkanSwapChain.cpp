@@ -32,7 +32,7 @@ void VulkanSwapChain::PopulateSwapChainSupport() {
   const vk::SurfaceKHR surface = context_.GetSurface();
 
   if (physical_device.getSurfaceCapabilitiesKHR(surface, &swap_chain_support_.capabilities) != vk::Result::eSuccess) {
-    GERROR("Failed to get swap chain capabilities");
+    GERROR_CH(Renderer, "Failed to get swap chain capabilities");
     return;
   }
 
@@ -61,14 +61,14 @@ void VulkanSwapChain::PopulateSwapChainSupport() {
   //  } VkSurfaceCapabilitiesKHR;
 
 #if _DEBUG
-  GTRACE("Swap chain capabilities:");
-  GTRACE("  minImageCount: {}", swap_chain_support_.capabilities.minImageCount);
-  GTRACE("  maxImageCount: {}", swap_chain_support_.capabilities.maxImageCount);
-  GTRACE("  minExtent: width = {}  height = {}", swap_chain_support_.capabilities.minImageExtent.width,
+  GTRACE_CH(Renderer, "Swap chain capabilities:");
+  GTRACE_CH(Renderer, "  minImageCount: {}", swap_chain_support_.capabilities.minImageCount);
+  GTRACE_CH(Renderer, "  maxImageCount: {}", swap_chain_support_.capabilities.maxImageCount);
+  GTRACE_CH(Renderer, "  minExtent: width = {}  height = {}", swap_chain_support_.capabilities.minImageExtent.width,
          swap_chain_support_.capabilities.minImageExtent.height);
-  GTRACE("  maxExtent: width = {}  height = {}", swap_chain_support_.capabilities.maxImageExtent.width,
+  GTRACE_CH(Renderer, "  maxExtent: width = {}  height = {}", swap_chain_support_.capabilities.maxImageExtent.width,
          swap_chain_support_.capabilities.maxImageExtent.height);
-  GTRACE("  currentExtent: width = {}  height = {}", swap_chain_support_.capabilities.currentExtent.width,
+  GTRACE_CH(Renderer, "  currentExtent: width = {}  height = {}", swap_chain_support_.capabilities.currentExtent.width,
          swap_chain_support_.capabilities.currentExtent.height);
 #endif
 
@@ -78,7 +78,7 @@ void VulkanSwapChain::PopulateSwapChainSupport() {
     swap_chain_support_.formats.resize(format_count);
     // https://registry.khronos.org/vulkan/specs/1.3-extensions/man/html/VkSurfaceFormatKHR.html
     if (physical_device.getSurfaceFormatsKHR(surface, &format_count, swap_chain_support_.formats.data()) != vk::Result::eSuccess) {
-      GERROR("Failed to get surface formats");
+      GERROR_CH(Renderer, "Failed to get surface formats");
       swap_chain_support_.formats.clear();
       return;
     }
@@ -87,9 +87,9 @@ void VulkanSwapChain::PopulateSwapChainSupport() {
 #if _DEBUG
   for (const vk::SurfaceFormatKHR &format : swap_chain_support_.formats) {
     // print out supported surface formats
-    GTRACE("Supported surface format:");
-    GTRACE("  format: {}", vk::to_string(format.format));
-    GTRACE("  colorSpace: {}", vk::to_string(format.colorSpace));
+    GTRACE_CH(Renderer, "Supported surface format:");
+    GTRACE_CH(Renderer, "  format: {}", vk::to_string(format.format));
+    GTRACE_CH(Renderer, "  colorSpace: {}", vk::to_string(format.colorSpace));
   }
 #endif
 
@@ -98,14 +98,14 @@ void VulkanSwapChain::PopulateSwapChainSupport() {
   for (const vk::SurfaceFormatKHR &format : swap_chain_support_.formats) {
     if (format.format == surface_format_ && format.colorSpace == color_space_) {
       found = true;
-      GTRACE("Device supports targeted surface format & color space");
-      GTRACE("Target Surface format: {}", vk::to_string(surface_format_));
-      GTRACE("Target Color space: {}", vk::to_string(color_space_));
+      GTRACE_CH(Renderer, "Device supports targeted surface format & color space");
+      GTRACE_CH(Renderer, "Target Surface format: {}", vk::to_string(surface_format_));
+      GTRACE_CH(Renderer, "Target Color space: {}", vk::to_string(color_space_));
       break;
     }
   }
   if (!found) {
-    GERROR("Surface format not found");
+    GERROR_CH(Renderer, "Surface format not found");
     return;
   }
 
@@ -114,7 +114,7 @@ void VulkanSwapChain::PopulateSwapChainSupport() {
     swap_chain_support_.present_modes.resize(format_count);
     // https://registry.khronos.org/vulkan/specs/1.3-extensions/man/html/VkPresentModeKHR.html
     if (physical_device.getSurfacePresentModesKHR(surface, &format_count, swap_chain_support_.present_modes.data()) != vk::Result::eSuccess) {
-      GERROR("Failed to get surface present modes");
+      GERROR_CH(Renderer, "Failed to get surface present modes");
       swap_chain_support_.present_modes.clear();
       return;
     }
@@ -123,8 +123,8 @@ void VulkanSwapChain::PopulateSwapChainSupport() {
 #if _DEBUG
   for (const vk::PresentModeKHR &mode : swap_chain_support_.present_modes) {
     // print out supported present modes
-    GTRACE("Supported present mode:");
-    GTRACE("  mode: {}", vk::to_string(mode));
+    GTRACE_CH(Renderer, "Supported present mode:");
+    GTRACE_CH(Renderer, "  mode: {}", vk::to_string(mode));
   }
 #endif
 
@@ -133,12 +133,12 @@ void VulkanSwapChain::PopulateSwapChainSupport() {
   for (auto &mode : swap_chain_support_.present_modes) {
     if (mode == present_mode_) {
       found = true;
-      GINFO("Successfully set present mode to {}", vk::to_string(present_mode_));
+      GINFO_CH(Renderer, "Successfully set present mode to {}", vk::to_string(present_mode_));
       break;
     }
   }
   if (!found) {
-    GWARN("Requested Present mode not found, defaulting to VK_PRESENT_MODE_FIFO_KHR");
+    GWARN_CH(Renderer, "Requested Present mode not found, defaulting to VK_PRESENT_MODE_FIFO_KHR");
     present_mode_ = vk::PresentModeKHR::eFifo;
   }
 }
@@ -208,7 +208,7 @@ void VulkanSwapChain::CreateSwapChain() {
   swapchain_create_info.oldSwapchain = vk_swapchain_;// used during re-initialization from old to speed up creation
 
   VK_CHECK(device.createSwapchainKHR(&swapchain_create_info, nullptr, &vk_swapchain_), "Failed to create swap chain");
-  GINFO("Successfully created swap chain");
+  GINFO_CH(Renderer, "Successfully created swap chain");
 }
 
 void VulkanSwapChain::CreateImageViews() {
@@ -250,7 +250,7 @@ void VulkanSwapChain::CreateImageViews() {
     VK_CHECK(device.createImageView(&image_view_create_info, nullptr, &image_view), "Failed to create image view");
     image_views.push_back(image_view);
   }
-  GINFO("Successfully created image views - Count: {}", image_count);
+  GINFO_CH(Renderer, "Successfully created image views - Count: {}", image_count);
 
   vk::Image depth_image = VK_NULL_HANDLE;
   vk::ImageView depth_image_view = VK_NULL_HANDLE;
@@ -343,7 +343,7 @@ void VulkanSwapChain::RebuildSwapChain(int width, int height) {
 
   // Poll surface
   if (physical_device.getSurfaceCapabilitiesKHR(surface, &swap_chain_support_.capabilities) != vk::Result::eSuccess) {
-    GERROR("Failed to get surface capabilities");
+    GERROR_CH(Renderer, "Failed to get surface capabilities");
     return;
   }
 
@@ -399,7 +399,7 @@ void VulkanSwapChain::RebuildSwapChain(int width, int height) {
     device.destroySwapchainKHR(old_swap_chain, nullptr);
   }
 
-  GINFO("Successfully regenerated swap chain");
+  GINFO_CH(Renderer, "Successfully regenerated swap chain");
 
   CreateImageViews();
   CreateFrameBuffers();
@@ -482,7 +482,7 @@ void VulkanSwapChain::CreateFrameBuffers() {
     framebuffer_create_info.attachmentCount = sizeof(attachments) / sizeof(vk::ImageView);
     VK_CHECK(device.createFramebuffer(&framebuffer_create_info, nullptr, &swap_chain_frame.frame_buffer), "Failed to create frame buffers");
   }
-  GINFO("Successfully created frame buffers");
+  GINFO_CH(Renderer, "Successfully created frame buffers");
 }
 
 void VulkanSwapChain::Destroy() {
@@ -26,22 +26,22 @@ void VulkanSync::Initialize() {
   for (uint32_t i = 0; i < max_frames_in_flight; i++) {
     vk::Semaphore semaphore;
     if (device.createSemaphore(&semaphore_create_info, nullptr, &semaphore) != vk::Result::eSuccess) {
-      GERROR("Failed to create image available semaphore");
+      GERROR_CH(Renderer, "Failed to create image available semaphore");
       return;
     }
     image_available_semaphores_.push_back(semaphore);
   }
-  GINFO("Successfully created image available semaphore");
+  GINFO_CH(Renderer, "Successfully created image available semaphore");
 
   for (uint32_t i = 0; i < max_frames_in_flight; i++) {
     vk::Semaphore semaphore;
     if (device.createSemaphore(&semaphore_create_info, nullptr, &semaphore) != vk::Result::eSuccess) {
-      GERROR("Failed to create image available semaphore");
+      GERROR_CH(Renderer, "Failed to create image available semaphore");
       return;
     }
     render_finished_semaphores_.push_back(semaphore);
   }
-  GINFO("Successfully created render finished semaphore");
+  GINFO_CH(Renderer, "Successfully created render finished semaphore");
 
   vk::FenceCreateInfo fence_create_info = {};
   fence_create_info.sType = vk::StructureType::eFenceCreateInfo;
@@ -50,7 +50,7 @@ void VulkanSync::Initialize() {
   for (uint32_t i = 0; i < max_frames_in_flight; i++) {
     vk::Fence fence;
     if (device.createFence(&fence_create_info, nullptr, &fence) != vk::Result::eSuccess) {
-      GERROR("Failed to create in flight fence");
+      GERROR_CH(Renderer, "Failed to create in flight fence");
       return;
     }
     in_flight_fences_.push_back(fence);
@@ -60,7 +60,7 @@ VulkanTexture::~VulkanTexture() {
 void VulkanTexture::LoadImageFromFile() {
   VK_ASSERT(filename_ != nullptr, "Texture filename is null");
   pixels_ = stbi_load(filename_, &width_, &height_, &channels_, STBI_rgb_alpha);
-  if (pixels_ == nullptr) { GWARN("Failed to load texture: {}", filename_); }
+  if (pixels_ == nullptr) { GWARN_CH(Renderer, "Failed to load texture: {}", filename_); }
 }
 
 // Creates the Vulkan image and allocates memory for it
@@ -273,11 +273,11 @@ void VulkanTexture::UpdateDescriptorSet() {
   device.updateDescriptorSets(1, &write_descriptor_set, 0, nullptr);
 }
 
-void VulkanTexture::Use(vk::CommandBuffer &command_buffer) {
+void VulkanTexture::Use(VulkanCommandRecorder &recorder) {
   vk::PipelineLayout pipeline_layout = context_.GetVulkanPipeline().GetVkPipelineLayout();
-  VK_ASSERT(command_buffer != VK_NULL_HANDLE, "Command buffer not initialized");
+  VK_ASSERT(recorder.GetCommandBuffer() != VK_NULL_HANDLE, "Command buffer not initialized");
   VK_ASSERT(pipeline_layout != VK_NULL_HANDLE, "Pipeline layout not initialized");
 
-  command_buffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipeline_layout, 1, vk_descriptor_set_, nullptr);
+  recorder.BindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipeline_layout, 1, 1, &vk_descriptor_set_);
 }
 }// namespace glaceon
@@ -1,6 +1,8 @@
 #ifndef GLACEON_GLACEON_VULKANRENDERER_VULKANTEXTURE_H_
 #define GLACEON_GLACEON_VULKANRENDERER_VULKANTEXTURE_H_
 
+#include "VulkanCommandRecorder.h"
+
 namespace glaceon {
 
 class VulkanContext;
@@ -14,7 +16,7 @@ class VulkanTexture {
   VulkanTexture(VulkanContext &context, vk::DescriptorSet target_descriptor_set, const char *filename, const VulkanTextureInput &input);
   ~VulkanTexture();
 
-  void Use(vk::CommandBuffer &command_buffer);
+  void Use(VulkanCommandRecorder &recorder);
 
  private:
   int width_;
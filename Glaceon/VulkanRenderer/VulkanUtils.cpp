@@ -11,7 +11,7 @@ std::vector<char> VulkanUtils::ReadFile(const std::string &filename) {
   try {
     std::ifstream file(filename, std::ios::ate | std::ios::binary);
     if (!file.is_open()) {
-      GERROR("Failed to open file: {}", filename);
+      GERROR_CH(Renderer, "Failed to open file: {}", filename);
       return buffer;
     }
 
@@ -23,7 +23,7 @@ std::vector<char> VulkanUtils::ReadFile(const std::string &filename) {
 
     file.close();
   } catch (std::exception &e) {
-    GERROR("Exception caught while reading file: {}", e.what());
+    GERROR_CH(Renderer, "Exception caught while reading file: {}", e.what());
     buffer.clear();
   }
   return buffer;
@@ -33,12 +33,12 @@ vk::ShaderModule VulkanUtils::CreateShaderModule(vk::Device const &device, const
   vk::ShaderModule shader_module = VK_NULL_HANDLE;
   try {
     if (code.empty()) {
-      GERROR("Cannot create shader module: Shader code is empty");
+      GERROR_CH(Renderer, "Cannot create shader module: Shader code is empty");
       return VK_NULL_HANDLE;
     }
 
     if (!device) {
-      GERROR("Cannot create shader module: Device is null");
+      GERROR_CH(Renderer, "Cannot create shader module: Device is null");
       return VK_NULL_HANDLE;
     }
 
@@ -48,11 +48,11 @@ vk::ShaderModule VulkanUtils::CreateShaderModule(vk::Device const &device, const
     shader_module_create_info.pCode = reinterpret_cast<const uint32_t *>(code.data());
 
     if (device.createShaderModule(&shader_module_create_info, nullptr, &shader_module) != vk::Result::eSuccess) {
-      GERROR("Failed to create shader module");
+      GERROR_CH(Renderer, "Failed to create shader module");
       return VK_NULL_HANDLE;
     }
   } catch (std::exception &e) {
-    GERROR("Exception caught while creating shader module: {}", e.what());
+    GERROR_CH(Renderer, "Exception caught while creating shader module: {}", e.what());
     if (shader_module != VK_NULL_HANDLE) {
       device.destroy(shader_module);
       shader_module = VK_NULL_HANDLE;
@@ -94,7 +94,7 @@ glaceon::VulkanUtils::Buffer VulkanUtils::CreateBuffer(VulkanUtils::BufferInputP
   //check memory requirements of buffer
   int memory_index = FindMemoryIndex(params, buffer.buffer);
   if (memory_index < 0) {
-    GERROR("Failed to find memory index");
+    GERROR_CH(Renderer, "Failed to find memory index");
     return {};
   }
 
@@ -16,6 +16,7 @@
 #include <vulkan/vulkan_core.h>
 
 #include <algorithm>
+#include <array>
 #include <fstream>
 #include <optional>
 #include <set>
@@ -0,0 +1,45 @@
+// Cooks a model into a mesh file (see MeshFile.h) that the engine maps at startup instead of importing the model:
+//
+//  GlaceonMeshCooker <model> [<output>]
+//
+// The output defaults to the model's path with a .gmesh extension.  The CookModels target cooks every .glb in models/.
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+
+#include <spdlog/fmt/fmt.h>
+
+#include "Assimp/AssimpImporter.h"
+#include "Core/Logger.h"
+
+namespace glaceon {
+
+static bool CookMesh(const std::string &model_path, const std::string &output_path) {
+  const auto start = std::chrono::steady_clock::now();
+  if (!AssimpImporter::CookMeshes(model_path, output_path)) { return false; }
+
+  const double elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  fmt::print("Cooked {} -> {}, {} bytes in {:.1f} ms\n", model_path, output_path, std::filesystem::file_size(output_path), elapsed_ms);
+  return true;
+}
+
+}// namespace glaceon
+
+int main(int argc, char **argv) {
+  if (argc < 2 || argc > 3) {
+    fmt::print(stderr, "Usage: GlaceonMeshCooker <model> [<output>]\n");
+    return EXIT_FAILURE;
+  }
+  const std::string model_path = argv[1];
+  const std::string output_path = argc == 3 ? argv[2] : std::filesystem::path(model_path).replace_extension(".gmesh").string();
+
+  glaceon::Logger::InitLoggers();
+  glaceon::DeferredLog::Start();
+  const bool success = glaceon::CookMesh(model_path, output_path);
+  // the importer's deferred records go out before the loggers do
+  glaceon::DeferredLog::Stop();
+  glaceon::Logger::Shutdown();
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
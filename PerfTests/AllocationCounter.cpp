@@ -0,0 +1,100 @@
+// Replacements of the global operator new/delete that count allocations for the perf tests.
+//
+// On Linux the replacement is process wide, so it also counts what Glaceon, assimp and the Vulkan driver allocate
+// with operator new (malloc calls are not counted).  Elsewhere it only sees the executable's own allocations, so the
+// perf tests leave the allocation metrics out there (see kCountsAllocations).  Glaceon's GLACEON_TRACK_GLOBAL_NEW
+// hooks replace the same operators, CMake refuses to build the perf tests along with them.
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace glaceon {
+
+static std::atomic<uint64_t> allocations_ = 0;
+static std::atomic<uint64_t> bytes_ = 0;
+
+AllocationCounts GetAllocationCounts() {
+  return {allocations_.load(std::memory_order_relaxed), bytes_.load(std::memory_order_relaxed)};
+}
+
+static void *AllocateCounted(size_t size, size_t alignment) {
+  if (size == 0) { size = 1; }
+  allocations_.fetch_add(1, std::memory_order_relaxed);
+  bytes_.fetch_add(size, std::memory_order_relaxed);
+
+  void *block = nullptr;
+  if (alignment <= alignof(std::max_align_t)) {
+    block = std::malloc(size);
+  } else {
+#ifdef _WIN32
+    block = _aligned_malloc(size, alignment);
+#else
+    if (posix_memalign(&block, alignment, size) != 0) { block = nullptr; }
+#endif
+  }
+  if (block == nullptr) { throw std::bad_alloc(); }
+  return block;
+}
+
+static void FreeCounted(void *ptr, [[maybe_unused]] size_t alignment) {
+#ifdef _WIN32
+  if (alignment > alignof(std::max_align_t)) {
+    _aligned_free(ptr);
+    return;
+  }
+#endif
+  std::free(ptr);
+}
+
+}// namespace glaceon
+
+// Every form is replaced so no block can be allocated by one implementation and freed by the other, see
+// Glaceon/Profiler/AllocationHooks.cpp
+static constexpr size_t kDefaultAlignment = alignof(std::max_align_t);
+
+void *operator new(size_t size) { return glaceon::AllocateCounted(size, kDefaultAlignment); }
+void *operator new[](size_t size) { return glaceon::AllocateCounted(size, kDefaultAlignment); }
+void *operator new(size_t size, std::align_val_t alignment) { return glaceon::AllocateCounted(size, static_cast<size_t>(alignment)); }
+void *operator new[](size_t size, std::align_val_t alignment) { return glaceon::AllocateCounted(size, static_cast<size_t>(alignment)); }
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+  try {
+    return glaceon::AllocateCounted(size, kDefaultAlignment);
+  } catch (const std::bad_alloc &) { return nullptr; }
+}
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+  try {
+    return glaceon::AllocateCounted(size, kDefaultAlignment);
+  } catch (const std::bad_alloc &) { return nullptr; }
+}
+void *operator new(size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+  try {
+    return glaceon::AllocateCounted(size, static_cast<size_t>(alignment));
+  } catch (const std::bad_alloc &) { return nullptr; }
+}
+void *operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+  try {
+    return glaceon::AllocateCounted(size, static_cast<size_t>(alignment));
+  } catch (const std::bad_alloc &) { return nullptr; }
+}
+
+void operator delete(void *ptr) noexcept { glaceon::FreeCounted(ptr, kDefaultAlignment); }
+void operator delete[](void *ptr) noexcept { glaceon::FreeCounted(ptr, kDefaultAlignment); }
+void operator delete(void *ptr, size_t) noexcept { glaceon::FreeCounted(ptr, kDefaultAlignment); }
+void operator delete[](void *ptr, size_t) noexcept { glaceon::FreeCounted(ptr, kDefaultAlignment); }
+void operator delete(void *ptr, const std::nothrow_t &) noexcept { glaceon::FreeCounted(ptr, kDefaultAlignment); }
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept { glaceon::FreeCounted(ptr, kDefaultAlignment); }
+
+void operator delete(void *ptr, std::align_val_t alignment) noexcept { glaceon::FreeCounted(ptr, static_cast<size_t>(alignment)); }
+void operator delete[](void *ptr, std::align_val_t alignment) noexcept { glaceon::FreeCounted(ptr, static_cast<size_t>(alignment)); }
+void operator delete(void *ptr, size_t, std::align_val_t alignment) noexcept { glaceon::FreeCounted(ptr, static_cast<size_t>(alignment)); }
+void operator delete[](void *ptr, size_t, std::align_val_t alignment) noexcept { glaceon::FreeCounted(ptr, static_cast<size_t>(alignment)); }
+void operator delete(void *ptr, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+  glaceon::FreeCounted(ptr, static_cast<size_t>(alignment));
+}
+void operator delete[](void *ptr, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+  glaceon::FreeCounted(ptr, static_cast<size_t>(alignment));
+}
@@ -0,0 +1,27 @@
+#ifndef GLACEON_PERFTESTS_ALLOCATIONCOUNTER_H_
+#define GLACEON_PERFTESTS_ALLOCATIONCOUNTER_H_
+
+#include <cstdint>
+
+namespace glaceon {
+
+// Totals of every operator new since the start of the process; the difference of two snapshots is what ran in between
+struct AllocationCounts {
+  uint64_t allocations = 0;
+  uint64_t bytes = 0;
+
+  AllocationCounts operator-(const AllocationCounts &other) const { return {allocations - other.allocations, bytes - other.bytes}; }
+};
+
+// Only on Linux does the replacement cover the whole process, other platforms do not report allocation metrics
+#ifdef __linux__
+inline constexpr bool kCountsAllocations = true;
+#else
+inline constexpr bool kCountsAllocations = false;
+#endif
+
+[[nodiscard]] AllocationCounts GetAllocationCounts();
+
+}// namespace glaceon
+
+#endif// GLACEON_PERFTESTS_ALLOCATIONCOUNTER_H_
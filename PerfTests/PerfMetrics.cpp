@@ -0,0 +1,211 @@
+#include "PerfMetrics.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+#include <spdlog/fmt/fmt.h>
+
+namespace glaceon {
+
+static constexpr double kDefaultTolerance = 0.1;
+
+const PerfMetric *PerfResults::Find(const std::string &name) const {
+  for (const PerfMetric &metric : metrics) {
+    if (metric.name == name) { return &metric; }
+  }
+  return nullptr;
+}
+
+// Just enough JSON for the results files: objects, strings and numbers, flattened into dotted paths, e.g.
+// "metrics.load_ms.value".  Arrays, booleans and null are rejected.
+class FlatJsonReader {
+ public:
+  explicit FlatJsonReader(const std::string &text) : text_(text) {}
+
+  bool Read() {
+    SkipWhitespace();
+    if (!ReadValue("")) { return false; }
+    SkipWhitespace();
+    if (pos_ != text_.size()) { return Fail("trailing characters"); }
+    return true;
+  }
+
+  [[nodiscard]] const std::string &GetError() const { return error_; }
+  std::map<std::string, double> numbers;
+  std::map<std::string, std::string> strings;
+
+ private:
+  bool ReadValue(const std::string &path) {
+    if (pos_ >= text_.size()) { return Fail("unexpected end"); }
+    if (text_[pos_] == '{') { return ReadObject(path); }
+    if (text_[pos_] == '"') {
+      std::string value;
+      if (!ReadString(value)) { return false; }
+      strings[path] = value;
+      return true;
+    }
+
+    const char *start = text_.c_str() + pos_;
+    char *end = nullptr;
+    const double value = std::strtod(start, &end);
+    if (end == start) { return Fail("expected an object, string or number"); }
+    pos_ += end - start;
+    numbers[path] = value;
+    return true;
+  }
+
+  bool ReadObject(const std::string &path) {
+    pos_++;// {
+    SkipWhitespace();
+    if (Consume('}')) { return true; }
+    do {
+      SkipWhitespace();
+      std::string key;
+      if (!ReadString(key)) { return false; }
+      SkipWhitespace();
+      if (!Consume(':')) { return Fail("expected ':'"); }
+      SkipWhitespace();
+      if (!ReadValue(path.empty() ? key : path + "." + key)) { return false; }
+      SkipWhitespace();
+    } while (Consume(','));
+    if (!Consume('}')) { return Fail("expected ',' or '}'"); }
+    return true;
+  }
+
+  bool ReadString(std::string &out) {
+    if (!Consume('"')) { return Fail("expected a string"); }
+    while (pos_ < text_.size() && text_[pos_] != '"') {
+      // the writer never escapes anything but quotes and backslashes
+      if (text_[pos_] == '\\' && pos_ + 1 < text_.size()) { pos_++; }
+      out.push_back(text_[pos_++]);
+    }
+    if (!Consume('"')) { return Fail("unterminated string"); }
+    return true;
+  }
+
+  void SkipWhitespace() {
+    while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_]))) { pos_++; }
+  }
+
+  bool Consume(char c) {
+    if (pos_ >= text_.size() || text_[pos_] != c) { return false; }
+    pos_++;
+    return true;
+  }
+
+  bool Fail(const char *message) {
+    error_ = fmt::format("{} at offset {}", message, pos_);
+    return false;
+  }
+
+  const std::string &text_;
+  size_t pos_ = 0;
+  std::string error_;
+};
+
+bool WritePerfResults(const PerfResults &results, const std::string &file_path) {
+  std::ofstream file(file_path);
+  if (!file) {
+    fmt::print(stderr, "Failed to open {} for writing\n", file_path);
+    return false;
+  }
+
+  file << fmt::format("{{\n  \"scenario\": \"{}\",\n  \"metrics\": {{\n", results.scenario);
+  for (size_t i = 0; i < results.metrics.size(); i++) {
+    const PerfMetric &metric = results.metrics[i];
+    file << fmt::format("    \"{}\": {{\"value\": {}, \"tolerance\": {}, \"slack\": {}}}{}\n", metric.name, metric.value,
+                        metric.tolerance, metric.slack, i + 1 < results.metrics.size() ? "," : "");
+  }
+  file << "  }\n}\n";
+  return static_cast<bool>(file);
+}
+
+bool ReadPerfResults(const std::string &file_path, PerfResults &results, std::string &error) {
+  std::ifstream file(file_path);
+  if (!file) {
+    error = fmt::format("cannot open {}", file_path);
+    return false;
+  }
+  std::stringstream text;
+  text << file.rdbuf();
+  const std::string contents = text.str();
+
+  FlatJsonReader reader(contents);
+  if (!reader.Read()) {
+    error = fmt::format("{}: {}", file_path, reader.GetError());
+    return false;
+  }
+
+  results = {};
+  if (const auto scenario = reader.strings.find("scenario"); scenario != reader.strings.end()) { results.scenario = scenario->second; }
+
+  // "metrics.<name>.value" along with its optional tolerance and slack; a bare "metrics.<name>" number is a value with
+  // the default tolerance
+  static const std::string kPrefix = "metrics.";
+  for (const auto &[path, number] : reader.numbers) {
+    if (path.rfind(kPrefix, 0) != 0) { continue; }
+    std::string name = path.substr(kPrefix.size());
+    const size_t dot = name.rfind('.');
+    if (dot != std::string::npos) {
+      if (name.compare(dot + 1, std::string::npos, "value") != 0) { continue; }
+      name.resize(dot);
+    }
+
+    const std::string metric_path = kPrefix + name;
+    const auto tolerance = reader.numbers.find(metric_path + ".tolerance");
+    const auto slack = reader.numbers.find(metric_path + ".slack");
+    results.Add(name, number, tolerance != reader.numbers.end() ? tolerance->second : kDefaultTolerance,
+                slack != reader.numbers.end() ? slack->second : 0.0);
+  }
+
+  if (results.metrics.empty()) {
+    error = fmt::format("{}: no metrics", file_path);
+    return false;
+  }
+  return true;
+}
+
+uint32_t ComparePerfResults(const PerfResults &baseline, const PerfResults &current) {
+  uint32_t regressions = 0;
+  fmt::print("{:<28} {:>14} {:>14} {:>9} {:>14}\n", current.scenario, "baseline", "current", "change", "limit");
+
+  for (const PerfMetric &expected : baseline.metrics) {
+    const PerfMetric *actual = current.Find(expected.name);
+    if (actual == nullptr) {
+      fmt::print("{:<28} {:>14.3f} {:>14} {:>9} {:>14}  REGRESSION (missing)\n", expected.name, expected.value, "-", "", "");
+      regressions++;
+      continue;
+    }
+
+    const double limit = expected.value * (1.0 + expected.tolerance) + expected.slack;
+    const bool regressed = actual->value > limit;
+    const std::string change =
+        expected.value != 0.0 ? fmt::format("{:+.1f}%", 100.0 * (actual->value - expected.value) / expected.value) : std::string("-");
+    fmt::print("{:<28} {:>14.3f} {:>14.3f} {:>9} {:>14.3f}{}\n", expected.name, expected.value, actual->value, change, limit,
+               regressed ? "  REGRESSION" : "");
+    if (regressed) { regressions++; }
+  }
+
+  for (const PerfMetric &metric : current.metrics) {
+    if (baseline.Find(metric.name) == nullptr) {
+      fmt::print("{:<28} {:>14} {:>14.3f} {:>9} {:>14}  (not in baseline)\n", metric.name, "-", metric.value, "", "");
+    }
+  }
+  return regressions;
+}
+
+PerfResults MergeBaseline(const PerfResults &baseline, const PerfResults &current) {
+  PerfResults merged = current;
+  for (PerfMetric &metric : merged.metrics) {
+    if (const PerfMetric *previous = baseline.Find(metric.name)) {
+      metric.tolerance = previous->tolerance;
+      metric.slack = previous->slack;
+    }
+  }
+  return merged;
+}
+
+}// namespace glaceon
@@ -0,0 +1,46 @@
+#ifndef GLACEON_PERFTESTS_PERFMETRICS_H_
+#define GLACEON_PERFTESTS_PERFMETRICS_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace glaceon {
+
+// Every metric is lower-is-better.  A run regresses when it is above value * (1 + tolerance) + slack of the baseline.
+struct PerfMetric {
+  std::string name;
+  double value = 0.0;
+  double tolerance = 0.0;// allowed regression, a fraction of the baseline value
+  double slack = 0.0;    // allowed regression in the metric's own unit, for metrics that are usually 0
+};
+
+// Results of one scenario.  The JSON written for a run doubles as the baseline of later runs:
+//  {
+//    "scenario": "import",
+//    "metrics": {
+//      "load_ms": {"value": 41.2, "tolerance": 0.25, "slack": 0}
+//    }
+//  }
+struct PerfResults {
+  std::string scenario;
+  std::vector<PerfMetric> metrics;
+
+  void Add(const std::string &name, double value, double tolerance, double slack = 0.0) { metrics.push_back({name, value, tolerance, slack}); }
+  [[nodiscard]] const PerfMetric *Find(const std::string &name) const;
+};
+
+bool WritePerfResults(const PerfResults &results, const std::string &file_path);
+// false with a message in error when the file is missing or is not in the format above
+bool ReadPerfResults(const std::string &file_path, PerfResults &results, std::string &error);
+
+// Prints every metric of current against baseline and returns how many regressed.  Metrics the baseline has but the
+// run does not count as regressions, new ones are only reported.
+uint32_t ComparePerfResults(const PerfResults &baseline, const PerfResults &current);
+
+// current's values with the tolerances of baseline, which may have been tuned by hand, for --update-baseline
+PerfResults MergeBaseline(const PerfResults &baseline, const PerfResults &current);
+
+}// namespace glaceon
+
+#endif// GLACEON_PERFTESTS_PERFMETRICS_H_
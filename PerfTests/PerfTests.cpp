@@ -0,0 +1,356 @@
+// Scripted performance scenarios, each compared against a checked-in baseline so CI fails on regressions.
+//
+//  import          AssimpImporter::ImportObjectModel() of the model, --runs times, after checking that --quad-model, made
+//                  of quads only, comes out as triangles
+//  import_cached   the same from a warm import cache
+//  vertex_buffers  adding the imported vertices and indices to a VertexBufferCollection, CPU side only
+//  render          RunGame() with the model, the same draw as the sandbox, for --warmup-frames plus --frames.  It stands
+//                  in for the instanced grid of Scene(): the engine no longer adds the grid's triangle, square and star
+//                  meshes in MakeAssets() and their draws are commented out in RecordDrawCommands(), so an empty scene
+//                  renders nothing
+//
+// Each run writes perf_<scenario>.json (see PerfMetrics.h) and exits with 1 when a metric regressed against
+// --baseline, or when there is no baseline to compare with.  --update-baseline rewrites the baseline from the run
+// instead, keeping its tolerances; --report-only prints the numbers, and the comparison if there is a baseline, without
+// failing.
+//
+// The render scenario needs a window; on a CPU-only Linux box run it under xvfb-run with lavapipe as the Vulkan
+// driver, e.g.
+//  VK_ICD_FILENAMES=/usr/share/vulkan/icd.d/lvp_icd.x86_64.json xvfb-run -a GlaceonPerfTests --scenario render
+//
+// The engine loads shaders and textures from ../../, run from a directory two levels below the repository (ctest
+// runs it from <build>/PerfTests).
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#ifdef _WIN64
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "AllocationCounter.h"
+#include "Glaceon.h"
+#include "PerfMetrics.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace glaceon {
+
+// timings vary run to run, especially on a shared CI box; allocation counts should not move at all
+static constexpr double kTimeTolerance = 0.25;
+static constexpr double kCountTolerance = 0.02;
+static constexpr double kMemoryTolerance = 0.1;
+static constexpr double kMib = 1024.0 * 1024.0;
+
+struct PerfOptions {
+  std::string scenario;
+  std::string model_path = "../../models/bloons_level.glb";
+  std::string quad_model_path = "../../models/quad_cube.obj";
+  uint32_t runs = 5;
+  uint32_t warmup_frames = 60;
+  uint32_t frames = 600;
+  std::string output_path;
+  std::string baseline_path;
+  bool update_baseline = false;
+  bool report_only = false;
+};
+
+static double Milliseconds(Clock::duration duration) { return std::chrono::duration<double, std::milli>(duration).count(); }
+
+static double Percentile(std::vector<double> values, double percentile) {
+  if (values.empty()) { return 0.0; }
+  const auto nth = values.begin() + static_cast<ptrdiff_t>(percentile * static_cast<double>(values.size() - 1));
+  std::nth_element(values.begin(), nth, values.end());
+  return *nth;
+}
+
+// process wide, so every scenario runs in a process of its own
+static double GetPeakRssMib() {
+#ifdef _WIN64
+  PROCESS_MEMORY_COUNTERS counters = {};
+  GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+  return static_cast<double>(counters.PeakWorkingSetSize) / kMib;
+#else
+  rusage usage = {};
+  getrusage(RUSAGE_SELF, &usage);
+  return static_cast<double>(usage.ru_maxrss) * 1024.0 / kMib;// kilobytes on Linux
+#endif
+}
+
+static bool ImportModel(const PerfOptions &options, Assimp_ModelData &model) {
+  model = AssimpImporter::ImportObjectModel(options.model_path);
+  if (model.vert_data.empty()) {
+    fmt::print(stderr, "Failed to import {}\n", options.model_path);
+    return false;
+  }
+  return true;
+}
+
+// assimp flags meshes it triangulated from quads and polygons, which must not keep them from being imported
+static bool CheckQuadImport(const PerfOptions &options) {
+  const Assimp_ModelData model = AssimpImporter::ImportObjectModel(options.quad_model_path);
+  if (model.indices.empty()) {
+    fmt::print(stderr, "{} imported without any triangles\n", options.quad_model_path);
+    return false;
+  }
+  return true;
+}
+
+static bool RunImport(const PerfOptions &options, PerfResults &results) {
+  if (options.scenario == "import" && !CheckQuadImport(options)) { return false; }
+  if (options.scenario == "import_cached") {
+    // a cache of its own, warmed by a first import that is not timed
+    AssimpImporter::SetCacheDirectory("perf_import_cache");
+    Assimp_ModelData model;
+    if (!ImportModel(options, model)) { return false; }
+  }
+
+  std::vector<double> load_times;
+  AllocationCounts counts;
+  for (uint32_t run = 0; run < options.runs; run++) {
+    Assimp_ModelData model;
+    const AllocationCounts before = GetAllocationCounts();
+    const Clock::time_point start = Clock::now();
+    if (!ImportModel(options, model)) { return false; }
+    load_times.push_back(Milliseconds(Clock::now() - start));
+    counts = GetAllocationCounts() - before;
+  }
+
+  results.Add("load_ms", Percentile(load_times, 0.5), kTimeTolerance);
+  if (kCountsAllocations) {
+    results.Add("allocations", static_cast<double>(counts.allocations), kCountTolerance);
+    results.Add("allocated_mib", static_cast<double>(counts.bytes) / kMib, kMemoryTolerance);
+  }
+  results.Add("peak_rss_mib", GetPeakRssMib(), kMemoryTolerance);
+  return true;
+}
+
+static bool RunVertexBuffers(const PerfOptions &options, PerfResults &results) {
+  Assimp_ModelData model;
+  if (!ImportModel(options, model)) { return false; }
+
+  std::vector<double> build_times;
+  AllocationCounts counts;
+  for (uint32_t run = 0; run < options.runs; run++) {
+    const AllocationCounts before = GetAllocationCounts();
+    const Clock::time_point start = Clock::now();
+    {
+      VertexBufferCollection collection;
+      collection.Add(model.vert_data, model.indices);
+    }
+    build_times.push_back(Milliseconds(Clock::now() - start));
+    counts = GetAllocationCounts() - before;
+  }
+
+  results.Add("build_ms", Percentile(build_times, 0.5), kTimeTolerance);
+  if (kCountsAllocations) {
+    results.Add("allocations", static_cast<double>(counts.allocations), kCountTolerance);
+    results.Add("allocated_mib", static_cast<double>(counts.bytes) / kMib, kMemoryTolerance);
+  }
+  results.Add("peak_rss_mib", GetPeakRssMib(), kMemoryTolerance);
+  return true;
+}
+
+// a member would only be initialized after the Application constructor it is passed to
+static ApplicationInfo app_info = {.name = "GlaceonPerfTests"};
+
+// Renders the imported model like the sandbox and times each frame, from one OnUpdate() to the next, once the warmup
+// frames are done.
+class PerfApplication : public Application {
+ public:
+  explicit PerfApplication(const PerfOptions &options) : Application(&app_info), options_(options), start_(Clock::now()) {}
+
+  void OnStart() override {
+    Assimp_ModelData model;
+    imported_ = ImportModel(options_, model);
+    if (!imported_) {
+      RequestShutdown();
+      return;
+    }
+    PushContent(model);
+  }
+
+  void OnUpdate() override {
+    const Clock::time_point now = Clock::now();
+    if (frame_ == 0) { startup_ms_ = Milliseconds(now - start_); }
+    if (frame_ > options_.warmup_frames) { frame_times_.push_back(Milliseconds(now - last_update_)); }
+    if (frame_ == options_.warmup_frames) { allocations_start_ = GetAllocationCounts(); }
+    last_update_ = now;
+
+    if (frame_ == options_.warmup_frames + options_.frames) {
+      allocations_ = GetAllocationCounts() - allocations_start_;
+      const DeviceMemoryStats &memory_stats = GetVulkanContext().GetVulkanMemoryAllocator().GetStats();
+      for (uint32_t heap = 0; heap < memory_stats.heap_count; heap++) { device_memory_ += memory_stats.heaps[heap].usage; }
+      RequestShutdown();
+    }
+    frame_++;
+  }
+
+  void OnShutdown() override {}
+
+  [[nodiscard]] bool IsComplete() const { return imported_ && !frame_times_.empty(); }
+
+  void AddResults(PerfResults &results) const {
+    const double frames = static_cast<double>(frame_times_.size());
+    results.Add("startup_ms", startup_ms_, kTimeTolerance);
+    results.Add("frame_ms_p50", Percentile(frame_times_, 0.5), kTimeTolerance);
+    results.Add("frame_ms_p95", Percentile(frame_times_, 0.95), kTimeTolerance);
+    results.Add("frame_ms_p99", Percentile(frame_times_, 0.99), kTimeTolerance);
+    // the render loop should not allocate at all; no slack, the recorded baseline is the steady state of the driver
+    if (kCountsAllocations) {
+      results.Add("allocations_per_frame", static_cast<double>(allocations_.allocations) / frames, kCountTolerance);
+    }
+    results.Add("device_memory_mib", static_cast<double>(device_memory_) / kMib, kMemoryTolerance);
+    results.Add("peak_rss_mib", GetPeakRssMib(), kMemoryTolerance);
+  }
+
+ private:
+  const PerfOptions &options_;
+
+  bool imported_ = false;
+  uint32_t frame_ = 0;
+  Clock::time_point start_;
+  Clock::time_point last_update_;
+  double startup_ms_ = 0.0;
+  std::vector<double> frame_times_;
+  AllocationCounts allocations_start_;
+  AllocationCounts allocations_;
+  uint64_t device_memory_ = 0;
+};
+
+static bool RunRender(const PerfOptions &options, PerfResults &results) {
+  // RunGame() would carry on with an empty scene
+  if (!std::filesystem::exists(options.model_path)) {
+    fmt::print(stderr, "{} not found\n", options.model_path);
+    return false;
+  }
+
+  PerfApplication app(options);
+  // keep console output out of the frame times
+  Logger::SetLevel(spdlog::level::warn);
+  RunGame(&app);
+
+  if (!app.IsComplete()) {
+    fmt::print(stderr, "The render scenario did not finish its frames\n");
+    return false;
+  }
+  app.AddResults(results);
+  return true;
+}
+
+static void PrintUsage() {
+  fmt::print(
+      "GlaceonPerfTests --scenario import|import_cached|vertex_buffers|render [--model path] [--quad-model path] [--runs n]\n"
+      "                 [--warmup-frames n] [--frames n] [--output file] [--baseline file] [--update-baseline] [--report-only]\n");
+}
+
+static bool ParseOptions(int argc, char **argv, PerfOptions &options) {
+  for (int i = 1; i < argc; i++) {
+    const char *arg = argv[i];
+    const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+    if (std::strcmp(arg, "--update-baseline") == 0) {
+      options.update_baseline = true;
+      continue;
+    }
+    if (std::strcmp(arg, "--report-only") == 0) {
+      options.report_only = true;
+      continue;
+    }
+    if (value == nullptr) { return false; }
+
+    if (std::strcmp(arg, "--scenario") == 0) {
+      options.scenario = value;
+    } else if (std::strcmp(arg, "--model") == 0) {
+      options.model_path = value;
+    } else if (std::strcmp(arg, "--quad-model") == 0) {
+      options.quad_model_path = value;
+    } else if (std::strcmp(arg, "--runs") == 0) {
+      options.runs = static_cast<uint32_t>(std::max(1, std::atoi(value)));
+    } else if (std::strcmp(arg, "--warmup-frames") == 0) {
+      options.warmup_frames = static_cast<uint32_t>(std::max(0, std::atoi(value)));
+    } else if (std::strcmp(arg, "--frames") == 0) {
+      options.frames = static_cast<uint32_t>(std::max(1, std::atoi(value)));
+    } else if (std::strcmp(arg, "--output") == 0) {
+      options.output_path = value;
+    } else if (std::strcmp(arg, "--baseline") == 0) {
+      options.baseline_path = value;
+    } else {
+      return false;
+    }
+    i++;
+  }
+  if (options.output_path.empty()) { options.output_path = "perf_" + options.scenario + ".json"; }
+  return !options.scenario.empty();
+}
+
+static bool RunScenario(const PerfOptions &options, PerfResults &results) {
+  results.scenario = options.scenario;
+  // every scenario but import_cached measures a real import, whatever an earlier run left in the cache
+  AssimpImporter::SetCacheDirectory("");
+  if (options.scenario == "render") { return RunRender(options, results); }
+
+  // RunGame() sets up logging for the render scenario, the others set it up the way Application does
+  Logger::InitLoggers();
+  Logger::SetLevel(spdlog::level::warn);
+  DeferredLog::Start();
+  bool success = false;
+  if (options.scenario == "import" || options.scenario == "import_cached") {
+    success = RunImport(options, results);
+  } else if (options.scenario == "vertex_buffers") {
+    success = RunVertexBuffers(options, results);
+  } else {
+    fmt::print(stderr, "Unknown scenario {}\n", options.scenario);
+  }
+  // the records still in the rings go out before the loggers do
+  DeferredLog::Stop();
+  Logger::Shutdown();
+  return success;
+}
+
+}// namespace glaceon
+
+int main(int argc, char **argv) {
+  glaceon::PerfOptions options;
+  if (!glaceon::ParseOptions(argc, argv, options)) {
+    glaceon::PrintUsage();
+    return EXIT_FAILURE;
+  }
+
+  glaceon::PerfResults results;
+  if (!glaceon::RunScenario(options, results)) { return EXIT_FAILURE; }
+  if (!glaceon::WritePerfResults(results, options.output_path)) { return EXIT_FAILURE; }
+
+  glaceon::PerfResults baseline;
+  std::string error = "no --baseline given";
+  const bool has_baseline = !options.baseline_path.empty() && glaceon::ReadPerfResults(options.baseline_path, baseline, error);
+  if (options.update_baseline && !options.baseline_path.empty()) {
+    if (!glaceon::WritePerfResults(has_baseline ? glaceon::MergeBaseline(baseline, results) : results, options.baseline_path)) {
+      return EXIT_FAILURE;
+    }
+    fmt::print("Updated baseline {}\n", options.baseline_path);
+    return EXIT_SUCCESS;
+  }
+  if (!has_baseline) {
+    // nothing to gate on, which only passes when asked for
+    fmt::print(stderr, "No baseline ({}), record one with --update-baseline\n", error);
+    for (const glaceon::PerfMetric &metric : results.metrics) { fmt::print("{:<28} {:>14.3f}\n", metric.name, metric.value); }
+    return options.report_only ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+
+  const uint32_t regressions = glaceon::ComparePerfResults(baseline, results);
+  if (regressions > 0) {
+    fmt::print(stderr, "{}: {} metric(s) regressed against {}\n", options.scenario, regressions, options.baseline_path);
+    return options.report_only ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -1,21 +1,34 @@
 #include "Game.h"
 
 #include <Assimp/AssimpImporter.h>
+#include <MeshFile.h>
+
+#include <filesystem>
+#include <utility>
 
 #include "Application.h"
 
+// static, so it is ready before the Application constructor gets to see it
+static glaceon::ApplicationInfo app_info = {.name = "Sandbox"};
+
 int main() {
   SandBoxApplication app;
   glaceon::RunGame(&app);
 }
-SandBoxApplication::SandBoxApplication() : glaceon::Application(&app_info_) {
+SandBoxApplication::SandBoxApplication() : glaceon::Application(&app_info) {
 
   // we want to somehow pass a list of vec3 to engine as a push constant
 }
 
 void SandBoxApplication::OnStart() {
-  // load in object models?
-  const std::string fPath = R"(..\..\models\bloons_level.glb)";
+  // cooked by the CookModels target; importing the model itself is the slow way round
+  const std::string cooked_path = "../../models/bloons_level.gmesh";
+  if (glaceon::MeshFile mesh_file; std::filesystem::exists(cooked_path) && mesh_file.Open(cooked_path)) {
+    PushContent(std::move(mesh_file));
+    return;
+  }
+
+  const std::string fPath = "../../models/bloons_level.glb";
   const glaceon::Assimp_ModelData content = glaceon::AssimpImporter::ImportObjectModel(fPath);
   PushContent(content);
 }
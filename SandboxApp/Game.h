@@ -10,9 +10,6 @@ class SandBoxApplication : public glaceon::Application {
   void OnStart() override;
   void OnUpdate() override;
   void OnShutdown() override;
-
- private:
-  glaceon::ApplicationInfo app_info_ = {.name = "Sandbox"};
 };
 
 #endif// GLACEON_SANDBOXAPP_GAME_H_